@@ -0,0 +1,27 @@
+
+#ifdef USE_BATCHING
+
+	uniform highp sampler2D batchingTexture;
+
+	mat4 getBatchingMatrix( const in float i ) {
+
+		float size = float( textureSize( batchingTexture, 0 ).x );
+		float j = i * 4.0;
+		float x = mod( j, size );
+		float y = floor( j / size );
+
+		float dx = 1.0 / size;
+		float dy = 1.0 / size;
+
+		y = dy * ( y + 0.5 );
+
+		vec4 v1 = texture2D( batchingTexture, vec2( dx * ( x + 0.5 ), y ) );
+		vec4 v2 = texture2D( batchingTexture, vec2( dx * ( x + 1.5 ), y ) );
+		vec4 v3 = texture2D( batchingTexture, vec2( dx * ( x + 2.5 ), y ) );
+		vec4 v4 = texture2D( batchingTexture, vec2( dx * ( x + 3.5 ), y ) );
+
+		return mat4( v1, v2, v3, v4 );
+
+	}
+
+#endif
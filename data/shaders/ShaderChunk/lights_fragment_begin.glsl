@@ -80,6 +80,28 @@ IncidentLight directLight;
 
 #endif
 
+#if defined( USE_CLUSTERED_LIGHTS ) && defined( RE_Direct )
+
+	{
+
+		ivec3 cluster = getCluster( geometry.position );
+		vec4 clusterData = texelFetch( clusterGridTexture, ivec2( cluster.x + cluster.y * CLUSTER_GRID_X, cluster.z ), 0 );
+
+		int clusterOffset = int( clusterData.x );
+		int clusterCount = int( clusterData.y );
+
+		for ( int i = 0; i < clusterCount; i ++ ) {
+
+			getClusteredDirectLightIrradiance( getClusterLightIndex( clusterOffset + i ), geometry, directLight );
+
+			if ( directLight.visible ) RE_Direct( directLight, geometry, material, reflectedLight );
+
+		}
+
+	}
+
+#endif
+
 #if ( NUM_DIR_LIGHTS > 0 ) && defined( RE_Direct )
 
 	DirectionalLight directionalLight;
@@ -57,6 +57,37 @@ vIndirectFront += getLightProbeIrradiance( lightProbe, geometry );
 
 #endif
 
+#ifdef USE_CLUSTERED_LIGHTS
+
+	{
+
+		ivec3 cluster = getCluster( geometry.position );
+		vec4 clusterData = texelFetch( clusterGridTexture, ivec2( cluster.x + cluster.y * CLUSTER_GRID_X, cluster.z ), 0 );
+
+		int clusterOffset = int( clusterData.x );
+		int clusterCount = int( clusterData.y );
+
+		for ( int i = 0; i < clusterCount; i ++ ) {
+
+			getClusteredDirectLightIrradiance( getClusterLightIndex( clusterOffset + i ), geometry, directLight );
+
+			dotNL = dot( geometry.normal, directLight.direction );
+			directLightColor_Diffuse = PI * directLight.color;
+
+			vLightFront += saturate( dotNL ) * directLightColor_Diffuse;
+
+			#ifdef DOUBLE_SIDED
+
+				vLightBack += saturate( -dotNL ) * directLightColor_Diffuse;
+
+			#endif
+
+		}
+
+	}
+
+#endif
+
 #if NUM_SPOT_LIGHTS > 0
 
 	#pragma unroll_loop_start
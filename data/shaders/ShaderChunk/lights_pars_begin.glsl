@@ -192,3 +192,64 @@ vec3 getAmbientLightIrradiance( const in vec3 ambientLightColor ) {
 
 #endif
 
+
+#ifdef USE_CLUSTERED_LIGHTS
+
+	uniform sampler2D clusterLightTexture;
+	uniform sampler2D clusterGridTexture;
+	uniform sampler2D clusterIndexTexture;
+	uniform mat4 clusterProjectionMatrix;
+	uniform vec2 clusterDepth; // near, 1 / log( far / near )
+
+	ivec3 getCluster( const in vec3 viewPosition ) {
+
+		vec4 clipPosition = clusterProjectionMatrix * vec4( viewPosition, 1.0 );
+		vec2 tile = clamp( ( clipPosition.xy / clipPosition.w ) * 0.5 + 0.5, 0.0, 1.0 ) * vec2( CLUSTER_GRID_X, CLUSTER_GRID_Y );
+
+		float slice = log( max( - viewPosition.z, clusterDepth.x ) / clusterDepth.x ) * clusterDepth.y * float( CLUSTER_GRID_Z );
+
+		return ivec3(
+			min( int( tile.x ), CLUSTER_GRID_X - 1 ),
+			min( int( tile.y ), CLUSTER_GRID_Y - 1 ),
+			min( int( slice ), CLUSTER_GRID_Z - 1 ) );
+
+	}
+
+	int getClusterLightIndex( const in int i ) {
+
+		int texel = i / 4;
+		int width = textureSize( clusterIndexTexture, 0 ).x;
+
+		return int( texelFetch( clusterIndexTexture, ivec2( texel % width, texel / width ), 0 )[ i - texel * 4 ] );
+
+	}
+
+	// point light, or spot light when the last texel has its y component set
+	void getClusteredDirectLightIrradiance( const in int index, const in GeometricContext geometry, out IncidentLight directLight ) {
+
+		vec4 positionDistance = texelFetch( clusterLightTexture, ivec2( 0, index ), 0 );
+		vec4 colorDecay = texelFetch( clusterLightTexture, ivec2( 1, index ), 0 );
+
+		vec3 lVector = positionDistance.xyz - geometry.position;
+		directLight.direction = normalize( lVector );
+
+		float lightDistance = length( lVector );
+
+		directLight.color = colorDecay.rgb;
+		directLight.color *= punctualLightIntensityToIrradianceFactor( lightDistance, positionDistance.w, colorDecay.w );
+
+		vec4 directionCone = texelFetch( clusterLightTexture, ivec2( 2, index ), 0 );
+		vec4 penumbraSpot = texelFetch( clusterLightTexture, ivec2( 3, index ), 0 );
+
+		if ( penumbraSpot.y > 0.5 ) {
+
+			float angleCos = dot( directLight.direction, directionCone.xyz );
+			directLight.color *= smoothstep( directionCone.w, penumbraSpot.x, angleCos );
+
+		}
+
+		directLight.visible = ( directLight.color != vec3( 0.0 ) );
+
+	}
+
+#endif
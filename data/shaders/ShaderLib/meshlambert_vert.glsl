@@ -18,6 +18,7 @@ varying vec3 vIndirectFront;
 #include <color_pars_vertex>
 #include <fog_pars_vertex>
 #include <morphtarget_pars_vertex>
+#include <batching_pars_vertex>
 #include <skinning_pars_vertex>
 #include <shadowmap_pars_vertex>
 #include <logdepthbuf_pars_vertex>
@@ -15,6 +15,7 @@ varying vec3 vViewPosition;
 #include <displacementmap_pars_vertex>
 #include <fog_pars_vertex>
 #include <morphtarget_pars_vertex>
+#include <batching_pars_vertex>
 #include <skinning_pars_vertex>
 
 #include <logdepthbuf_pars_vertex>
@@ -2,6 +2,7 @@
 #include <common>
 #include <fog_pars_vertex>
 #include <shadowmap_pars_vertex>
+#include <batching_pars_vertex>
 
 void main() {
 
@@ -0,0 +1,39 @@
+// Times bulk creation and destruction of scene graph nodes. Later rounds reuse the pooled blocks of earlier ones.
+
+#include "threepp/objects/Group.hpp"
+
+#include <chrono>
+#include <iostream>
+
+using namespace threepp;
+
+namespace {
+
+    template<class F>
+    double millis(F&& f) {
+
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+}// namespace
+
+int main() {
+
+    constexpr int count = 100000;
+    constexpr int rounds = 5;
+
+    for (int round = 0; round < rounds; ++round) {
+
+        auto group = Group::create();
+
+        const auto create = millis([&] {
+            for (int i = 0; i < count; ++i) group->add(Object3D::create());
+        });
+
+        const auto destroy = millis([&] { group->clear(); });
+
+        std::cout << "round " << round << ": create " << count << " objects " << create << "ms, destroy " << destroy << "ms" << std::endl;
+    }
+}
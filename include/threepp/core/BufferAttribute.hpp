@@ -8,11 +8,15 @@
 #include "threepp/math/Vector2.hpp"
 #include "threepp/math/Vector3.hpp"
 #include "threepp/math/Vector4.hpp"
+#include "threepp/math/batch.hpp"
 
 #include "threepp/constants.hpp"
 #include "threepp/core/misc.hpp"
 
+#include <algorithm>
 #include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace threepp {
@@ -25,6 +29,12 @@ namespace threepp {
     public:
         UpdateRange updateRange{0, -1};
 
+        // Ranges (in elements) uploaded on the next update, instead of updateRange.
+        std::vector<UpdateRange> updateRanges;
+
+        // Pending ranges beyond which they are collapsed into one range covering them all.
+        static constexpr size_t maxUpdateRanges = 64;
+
         unsigned int version = 0;
 
         [[nodiscard]] virtual int count() const = 0;
@@ -49,6 +59,43 @@ namespace threepp {
             ++version;
         }
 
+        // Ranges touching the last one are merged into it, so that writes in order add a single range.
+        void addUpdateRange(int offset, int count) {
+
+            if (!updateRanges.empty()) {
+
+                auto& last = updateRanges.back();
+                if (offset <= last.offset + last.count && offset + count >= last.offset) {
+
+                    const auto end = std::max(last.offset + last.count, offset + count);
+                    last.offset = std::min(last.offset, offset);
+                    last.count = end - last.offset;
+                    return;
+                }
+            }
+
+            updateRanges.push_back({offset, count});
+
+            // the ranges are only drained when the attribute is uploaded, which may not happen for a while
+            if (updateRanges.size() > maxUpdateRanges) {
+
+                auto begin = offset, end = offset + count;
+                for (const auto& range : updateRanges) {
+
+                    begin = std::min(begin, range.offset);
+                    end = std::max(end, range.offset + range.count);
+                }
+
+                updateRanges.clear();
+                updateRanges.push_back({begin, end - begin});
+            }
+        }
+
+        void clearUpdateRanges() {
+
+            updateRanges.clear();
+        }
+
         void setUsage(DrawUsage value) {
 
             this->usage_ = value;
@@ -100,6 +147,23 @@ namespace threepp {
             return array_;
         }
 
+        // First component of the first item, and the distance between items (in elements).
+        // Lets batch operations run directly on interleaved data.
+        [[nodiscard]] virtual const T* itemData() const {
+
+            return array_.data();
+        }
+
+        T* itemData() {
+
+            return const_cast<T*>(std::as_const(*this).itemData());
+        }
+
+        [[nodiscard]] virtual size_t itemStride() const {
+
+            return this->itemSize_;
+        }
+
         TypedBufferAttribute<T>& copyAt(unsigned int index1, const TypedBufferAttribute<T>& attribute, unsigned int index2) {
 
             index1 *= this->itemSize_;
@@ -120,6 +184,17 @@ namespace threepp {
             return *this;
         }
 
+        // Keeps the first items, the GPU buffer being reallocated on the next update.
+        TypedBufferAttribute<T>& resize(int count) {
+
+            array_.resize(static_cast<size_t>(count) * this->itemSize_);
+            count_ = count;
+
+            needsUpdate();
+
+            return *this;
+        }
+
         TypedBufferAttribute<T>& copyColorsArray(const std::vector<Color>& colors) {
 
             unsigned int offset = 0;
@@ -204,6 +279,16 @@ namespace threepp {
 
         TypedBufferAttribute<T>& applyMatrix4(const Matrix4& m) {
 
+            if constexpr (std::is_same_v<T, float>) {
+
+                if (this->itemSize_ >= 3) {
+
+                    math::applyMatrix4(m, itemData(), this->count(), itemStride());
+
+                    return *this;
+                }
+            }
+
             for (unsigned i = 0, l = this->count_; i < l; i++) {
 
                 _vector.x = this->getX(i);
@@ -236,6 +321,16 @@ namespace threepp {
 
         TypedBufferAttribute<T>& transformDirection(const Matrix4& m) {
 
+            if constexpr (std::is_same_v<T, float>) {
+
+                if (this->itemSize_ >= 3) {
+
+                    math::transformDirections(m, itemData(), this->count(), itemStride());
+
+                    return *this;
+                }
+            }
+
             for (unsigned i = 0, l = this->count_; i < l; i++) {
 
                 _vector.x = this->getX(i);
@@ -354,6 +449,18 @@ namespace threepp {
 
         void setFromBufferAttribute(Box3& target) const {
 
+            if constexpr (std::is_same_v<T, float>) {
+
+                if (this->itemSize_ >= 3) {
+
+                    Vector3 min, max;
+                    math::computeBounds(itemData(), this->count(), itemStride(), min, max);
+                    target.set(min, max);
+
+                    return;
+                }
+            }
+
             auto minX = +Infinity<float>;
             auto minY = +Infinity<float>;
             auto minZ = +Infinity<float>;
@@ -15,6 +15,9 @@
 
 namespace threepp {
 
+    class PointOctree;
+    class TriangleBVH;
+
     class BufferGeometry: public EventDispatcher {
 
     public:
@@ -31,6 +34,12 @@ namespace threepp {
         std::optional<Box3> boundingBox;
         std::optional<Sphere> boundingSphere;
 
+        // Optional triangle hierarchy used by Mesh::raycast. Cleared by applyMatrix4 and copy.
+        std::shared_ptr<TriangleBVH> boundsTree;
+
+        // Optional octree over the positions, used by Points::raycast. Cleared by applyMatrix4 and copy.
+        std::shared_ptr<PointOctree> pointsTree;
+
         DrawRange drawRange{0, std::numeric_limits<int>::max() / 2};
 
         BufferGeometry();
@@ -116,6 +125,12 @@ namespace threepp {
 
         void computeBoundingSphere();
 
+        // Builds boundsTree, splitting large geometries over the given number of threads.
+        void computeBoundsTree(unsigned int threads = 1);
+
+        // Builds pointsTree over the position attribute, splitting large attributes over the given number of threads.
+        void computePointsTree(unsigned int threads = 1);
+
         void normalizeNormals();
 
         [[nodiscard]] std::shared_ptr<BufferGeometry> toNonIndexed() const;
@@ -3,17 +3,64 @@
 #ifndef THREEPP_EVENTDISPATCHER_HPP
 #define THREEPP_EVENTDISPATCHER_HPP
 
+#include "threepp/utils/SmallVector.hpp"
+
+#include <cstddef>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 
 namespace threepp {
 
+    // Event type interned to a small integer id.
+    // Strings are interned on construction, the built-in types are available as constants in threepp::events.
+    class EventType {
+
+    public:
+        constexpr explicit EventType(unsigned int id): id_(id) {}
+
+        EventType(const std::string& name);
+
+        template<size_t N>
+        EventType(const char (&name)[N]): EventType(std::string(name)) {}
+
+        [[nodiscard]] constexpr unsigned int id() const {
+
+            return id_;
+        }
+
+        [[nodiscard]] const std::string& name() const;
+
+        constexpr bool operator==(const EventType& other) const {
+
+            return id_ == other.id_;
+        }
+
+        constexpr bool operator!=(const EventType& other) const {
+
+            return id_ != other.id_;
+        }
+
+    private:
+        unsigned int id_;
+    };
+
+    namespace events {
+
+        // ids match the order in which EventType registers the built-in names
+        inline constexpr EventType dispose{0};
+        inline constexpr EventType added{1};
+        inline constexpr EventType remove{2};
+        inline constexpr EventType childrenAdded{3};
+        inline constexpr EventType childrenRemoved{4};
+        inline constexpr EventType destroyed{5};
+
+    }// namespace events
+
     struct Event {
 
-        const std::string type;
+        const std::string& type;
         void* target;
     };
 
@@ -27,18 +74,52 @@ namespace threepp {
     class EventDispatcher {
 
     public:
-        void addEventListener(const std::string& type, EventListener* listener);
+        void addEventListener(EventType type, EventListener* listener);
+
+        bool hasEventListener(EventType type, const EventListener* listener) const;
+
+        void removeEventListener(EventType type, const EventListener* listener);
+
+        // whether any listener is registered, letting callers skip building an event target
+        [[nodiscard]] bool hasEventListeners() const {
+
+            return !listeners_.empty();
+        }
+
+        void dispatchEvent(EventType type, void* target = nullptr) {
 
-        bool hasEventListener(const std::string& type, const EventListener* listener);
+            if (listeners_.empty()) return;
 
-        void removeEventListener(const std::string& type, const EventListener* listener);
+            dispatch(type, target);
+        }
 
-        void dispatchEvent(const std::string& type, void* target = nullptr);
+        // string types are only interned when there are listeners
+        template<size_t N>
+        void dispatchEvent(const char (&type)[N], void* target = nullptr) {
+
+            if (listeners_.empty()) return;
+
+            dispatch(EventType(type), target);
+        }
+
+        void dispatchEvent(const std::string& type, void* target = nullptr) {
+
+            if (listeners_.empty()) return;
+
+            dispatch(EventType(type), target);
+        }
 
         virtual ~EventDispatcher() = default;
 
     private:
-        std::unordered_map<std::string, std::vector<EventListener*>> listeners_;
+        struct Entry {
+            unsigned int type;
+            EventListener* listener;
+        };
+
+        utils::SmallVector<Entry, 2> listeners_;
+
+        void dispatch(EventType type, void* target);
     };
 
 }// namespace threepp
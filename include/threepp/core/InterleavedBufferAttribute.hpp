@@ -31,6 +31,18 @@ namespace threepp {
             return data->count();
         }
 
+        using TypedBufferAttribute<float>::itemData;
+
+        [[nodiscard]] const float* itemData() const override {
+
+            return data->array().data() + offset;
+        }
+
+        [[nodiscard]] size_t itemStride() const override {
+
+            return data->stride();
+        }
+
         TypedBufferAttribute<float>& setX(size_t index, float x) override {
 
             this->data->array()[index * this->data->stride() + this->offset] = x;
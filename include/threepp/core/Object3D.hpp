@@ -12,11 +12,18 @@
 #include "threepp/core/EventDispatcher.hpp"
 #include "threepp/core/Layers.hpp"
 
+#include "threepp/utils/PoolAllocator.hpp"
+#include "threepp/utils/SmallVector.hpp"
+
 #include "misc.hpp"
 
+#include <array>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <type_traits>
 
 namespace threepp {
 
@@ -26,14 +33,72 @@ namespace threepp {
 
     class Scene;
     class BufferGeometry;
+    class Box3;
+    class Sphere;
 
     typedef std::function<void(void*, Scene*, Camera*, BufferGeometry*, Material*, std::optional<GeometryGroup>)> RenderCallback;
 
+    // Optional return value of traversal callbacks.
+    enum class TraverseResult {
+        Continue,
+        SkipChildren,
+        Stop
+    };
+
     // This is the base class for most objects in three.js and provides a set of properties and methods for manipulating objects in 3D space.
     //Note that this can be used for grouping objects via the .add( object ) method which adds the object as a child, however it is better to use Group for this.
     class Object3D: public EventDispatcher {
 
     public:
+        // A bool member that, when set, makes the next updateMatrixWorld visit the object again.
+        class MatrixUpdateFlag {
+
+        public:
+            MatrixUpdateFlag(const MatrixUpdateFlag&) = delete;
+
+            MatrixUpdateFlag& operator=(bool value);
+
+            MatrixUpdateFlag& operator=(const MatrixUpdateFlag& other) {
+
+                return *this = static_cast<bool>(other);
+            }
+
+            operator bool() const {
+
+                return value_;
+            }
+
+        private:
+            friend class Object3D;
+
+            Object3D* owner_;
+            bool value_;
+
+            MatrixUpdateFlag(Object3D* owner, bool value): owner_(owner), value_(value) {}
+        };
+
+        // UUID of an object, generated once on first access from any thread.
+        // Call uuid(); reading it as a string, as when it was a plain member, is deprecated.
+        class Uuid {
+
+        public:
+            Uuid() = default;
+            Uuid(const Uuid&) = delete;
+            Uuid& operator=(const Uuid&) = delete;
+
+            const std::string& operator()() const;
+
+            [[deprecated("Object3D::uuid is generated on first access, call uuid()")]]
+            operator const std::string&() const {
+
+                return (*this)();
+            }
+
+        private:
+            mutable std::once_flag once_;
+            mutable std::string value_;
+        };
+
         inline static Vector3 defaultUp{0, 1, 0};
         inline static bool defaultMatrixAutoUpdate{true};
 
@@ -41,7 +106,7 @@ namespace threepp {
         unsigned int id{_object3Did++};
 
         // UUID of this object instance. This gets automatically assigned, so this shouldn't be edited.
-        const std::string uuid;
+        const Uuid uuid;
 
         // Optional name of the object (doesn't need to be unique). Default is an empty string.
         std::string name;
@@ -51,6 +116,10 @@ namespace threepp {
         // Vector with object's children. See Group for info on manually grouping objects.
         std::vector<Object3D*> children;
 
+        // When false, remove() moves the last child into the slot of the removed one,
+        // which is O(1) but changes the order of the remaining children. Default is true.
+        bool keepChildOrder = true;
+
         // This is used by the lookAt method, for example, to determine the orientation of the result.
         //Default is Object3D::defaultUp - that is, ( 0, 1, 0 ).
         Vector3 up{defaultUp};
@@ -78,9 +147,11 @@ namespace threepp {
 
         // When this is set, it calculates the matrix of position, (rotation or quaternion) and scale every frame and also recalculates the matrixWorld property.
         // Default is Object3D::defaultMatrixAutoUpdate (true).
-        bool matrixAutoUpdate = defaultMatrixAutoUpdate;
+        // Subtrees where it is false everywhere are skipped by updateMatrixWorld until one of their objects calls
+        // updateMatrix, is flagged with matrixWorldNeedsUpdate, or gains or loses a child.
+        MatrixUpdateFlag matrixAutoUpdate{this, defaultMatrixAutoUpdate};
         // When this is set, it calculates the matrixWorld in that frame and resets this property to false. Default is false.
-        bool matrixWorldNeedsUpdate = false;
+        MatrixUpdateFlag matrixWorldNeedsUpdate{this, false};
 
         // The layer membership of the object.
         // The object is only visible if it has at least one layer in common with the Camera in use.
@@ -96,6 +167,8 @@ namespace threepp {
         // When this is set, it checks every frame if the object is in the frustum of the camera before rendering the object.
         // If set to false the object gets rendered every frame even if it is not in the frustum of the camera. Default is true.
         bool frustumCulled = true;
+        // Marks a mesh, line or points object that rarely moves, so that SceneBVH includes it. Default is false.
+        bool isStatic = false;
         // This value allows the default rendering order of scene graph objects to be overridden although opaque and transparent objects remain sorted independently.
         // When this property is set for an instance of Group, all descendants objects will be sorted and rendered together. Sorting is from lowest to highest renderOrder. Default value is 0.
         unsigned int renderOrder = 0;
@@ -112,6 +185,15 @@ namespace threepp {
 
         [[nodiscard]] virtual std::string type() const;
 
+        // Makes matrix a view of another matrix, e.g. the world matrix of the light a helper follows.
+        // The world matrix of the object is then recomputed on every update.
+        void shareMatrix(std::shared_ptr<Matrix4> source);
+
+        [[nodiscard]] bool matrixShared() const {
+
+            return matrixShared_;
+        }
+
         // Applies the matrix transform to the object and updates the object's position, rotation and scale.
         void applyMatrix4(const Matrix4& matrix);
 
@@ -158,20 +240,35 @@ namespace threepp {
         // Adds object as child of this object. An arbitrary number of objects may be added.
         // Any current parent on an object passed in here will be removed, since an object can have at most one parent.
         // This version of add takes ownership of the passed in object
+        // The object receives an "added" event, and this object a "childrenAdded" event as for addAll.
         void add(const std::shared_ptr<Object3D>& object);
 
         // Adds object as child of this object. An arbitrary number of objects may be added.
         // Any current parent on an object passed in here will be removed, since an object can have at most one parent.
         // This version of add does NOT take ownership of the passed in object
+        // The object receives an "added" event, and this object a "childrenAdded" event as for addAll.
         void add(Object3D& object);
 
+        // Adds the objects as children of this object, in order.
+        // Each object receives an "added" event, and this object a single "childrenAdded" event
+        // with a pointer to the vector of added objects as target.
+        void addAll(const std::vector<std::shared_ptr<Object3D>>& objects);
+
+        // Like addAll, without taking ownership of the objects.
+        void addAll(const std::vector<Object3D*>& objects);
+
         // Removes object as child of this object.
         void remove(Object3D& object);
 
+        // Removes the objects that are children of this object in a single pass.
+        // Each removed object receives a "remove" event, and this object a single "childrenRemoved" event
+        // with a pointer to the vector of removed objects as target.
+        void removeAll(const std::vector<Object3D*>& objects);
+
         // Removes this object from its current parent.
         void removeFromParent();
 
-        // Removes all child objects.
+        // Removes all child objects. Events are dispatched as for removeAll.
         void clear();
 
         // Searches through an object and its children, starting with the object itself, and returns the first with a matching name.
@@ -192,31 +289,71 @@ namespace threepp {
 
         virtual void raycast(Raycaster& raycaster, std::vector<Intersection>& intersects) {}
 
+        // World space bounding sphere of geometry(), or nullptr if the object has none.
+        // Cached, and only recomputed when matrixWorld or the bounds of the geometry change.
+        const Sphere* worldBoundingSphere();
+
+        // World space bounding box of geometry(), or nullptr if the object has none. Cached like worldBoundingSphere.
+        const Box3* worldBoundingBox();
+
+        // Calls callback for this object and all descendants, depth first.
+        // The callback may return a TraverseResult to skip the children of an object or to stop the traversal.
+        template<class Callback>
+        void traverse(Callback&& callback) {
+
+            traverseImpl<Object3D>(false, callback);
+        }
+
+        // Like traverse, skipping objects that are not visible along with their descendants.
+        template<class Callback>
+        void traverseVisible(Callback&& callback) {
+
+            traverseImpl<Object3D>(true, callback);
+        }
+
+        // Calls callback for each ancestor, starting with the parent. Returning TraverseResult::Stop ends the walk.
+        template<class Callback>
+        void traverseAncestors(Callback&& callback) {
+
+            for (auto object = parent; object; object = object->parent) {
+
+                if (invokeTraverse(callback, *object) == TraverseResult::Stop) return;
+            }
+        }
+
+        // Like traverse, only calling callback for objects of type T.
+        // The whole graph is still visited, so skipping children only applies below objects of type T.
+        template<class T, class Callback>
+        void traverseType(Callback&& callback) {
+
+            traverseImpl<T>(false, callback);
+        }
+
         void traverse(const std::function<void(Object3D&)>& callback);
 
         void traverseVisible(const std::function<void(Object3D&)>& callback);
 
         void traverseAncestors(const std::function<void(Object3D&)>& callback);
 
-        template<class T>
-        void traverseType(const std::function<void(T&)>& callback) {
-            traverse([&](Object3D& o) {
-                if (auto dyn = dynamic_cast<T*>(&o)) {
-                    callback(*dyn);
-                }
-            });
-        }
-
         // Updates the local transform.
         void updateMatrix();
 
+        // Updates the world transform of the object and its descendants.
+        // The local matrix is only recomposed when position, rotation/quaternion or scale changed since
+        // it was last composed, and world matrices are only recomputed below objects that changed.
         virtual void updateMatrixWorld(bool force = false);
 
         virtual void updateWorldMatrix(std::optional<bool> updateParents = std::nullopt, std::optional<bool> updateChildren = std::nullopt);
 
         static std::shared_ptr<Object3D> create() {
 
-            return std::make_shared<Object3D>();
+            return utils::makePooled<Object3D>();
+        }
+
+        // Total number of world matrices recomputed by updateMatrixWorld.
+        static size_t matrixWorldUpdates() {
+
+            return _matrixWorldUpdates.load(std::memory_order_relaxed);
         }
 
         virtual BufferGeometry* geometry() {
@@ -255,12 +392,105 @@ namespace threepp {
 
         virtual std::shared_ptr<Object3D> clone(bool recursive = true);
 
+        // Dispatches a "destroyed" event, letting listeners drop their pointers to the object.
         ~Object3D() override;
 
     private:
         inline static unsigned int _object3Did{0};
+        inline static std::atomic<size_t> _matrixWorldUpdates{0};
+
+        // position, quaternion and scale at the last updateMatrix
+        std::array<float, 10> composedTransform_{};
+        bool composed_ = false;
+
+        bool matrixShared_ = false;
+
+        // something in the subtree changed since the last updateMatrixWorld. Raised up to the root, so that
+        // a clear flag means the whole subtree is untouched.
+        bool subtreeNeedsUpdate_ = true;
+        // no object in the subtree had matrixAutoUpdate or a shared matrix at the last updateMatrixWorld
+        bool subtreeStatic_ = false;
+
+        void markSubtreeNeedsUpdate();
 
+        [[nodiscard]] bool transformChanged() const;
+
+        // composes matrix from position, quaternion and scale
+        void composeMatrix();
+
+        struct WorldBounds;
+        std::unique_ptr<WorldBounds> worldBounds_;
+
+        // returns the cache for geometry, invalidated if geometry or matrixWorld changed
+        WorldBounds& worldBounds(const BufferGeometry& geometry);
+
+        // index of this object in parent->children
+        size_t childIndex_ = 0;
+        // owning pointers, parallel to children (empty for children that are not owned)
         std::vector<std::shared_ptr<Object3D>> children_;
+
+        void addChild(Object3D* object, std::shared_ptr<Object3D> owned);
+
+        // dispatches the events of add
+        void dispatchAdded(Object3D* object);
+
+        // index of object in children, or children.size() if it is not a child of this object
+        [[nodiscard]] size_t indexOfChild(const Object3D& object) const;
+
+        // removes children[index], returning the owning pointer, if any
+        std::shared_ptr<Object3D> takeChild(size_t index);
+
+        template<class Ptr>
+        void addAllImpl(const std::vector<Ptr>& objects);
+
+        template<class Callback, class T>
+        static TraverseResult invokeTraverse(Callback& callback, T& object) {
+
+            if constexpr (std::is_void_v<std::invoke_result_t<Callback&, T&>>) {
+
+                callback(object);
+                return TraverseResult::Continue;
+
+            } else {
+
+                return callback(object);
+            }
+        }
+
+        // iterative pre-order traversal, children are visited in order
+        template<class T, class Callback>
+        void traverseImpl(bool visibleOnly, Callback& callback) {
+
+            utils::SmallVector<Object3D*, 32> stack;
+            stack.push_back(this);
+
+            while (!stack.empty()) {
+
+                auto object = stack.back();
+                stack.pop_back();
+
+                if (visibleOnly && !object->visible) continue;
+
+                auto result = TraverseResult::Continue;
+                if constexpr (std::is_same_v<T, Object3D>) {
+
+                    result = invokeTraverse(callback, *object);
+
+                } else if (auto typed = dynamic_cast<T*>(object)) {
+
+                    result = invokeTraverse(callback, *typed);
+                }
+
+                if (result == TraverseResult::Stop) return;
+                if (result == TraverseResult::SkipChildren) continue;
+
+                const auto& c = object->children;
+                for (auto it = c.rbegin(); it != c.rend(); ++it) {
+
+                    stack.push_back(*it);
+                }
+            }
+        }
     };
 
 }// namespace threepp
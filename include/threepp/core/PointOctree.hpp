@@ -0,0 +1,60 @@
+
+#ifndef THREEPP_POINTOCTREE_HPP
+#define THREEPP_POINTOCTREE_HPP
+
+#include <functional>
+#include <memory>
+
+namespace threepp {
+
+    class Box3;
+    class Ray;
+
+    template<class T>
+    class TypedBufferAttribute;
+
+    // Octree over the vertices of a position attribute, in the local space of the geometry.
+    // Assign it to BufferGeometry::pointsTree (see BufferGeometry::computePointsTree) to accelerate Points::raycast.
+    //
+    // The octree remembers the version of the attribute it was last fitted to, and is ignored once they differ:
+    // after moving points, call update with the attribute to refit it.
+    class PointOctree {
+
+    public:
+        // Attributes with more points than this are split on worker threads.
+        static constexpr size_t parallelThreshold = 1 << 20;
+
+        explicit PointOctree(const TypedBufferAttribute<float>& positions, unsigned int threads = 1);
+
+        PointOctree(const PointOctree&) = delete;
+        PointOctree& operator=(const PointOctree&) = delete;
+
+        // Calls visitor with every point that may lie within threshold of the ray.
+        void intersectRay(const Ray& ray, float threshold, const std::function<void(unsigned int point)>& visitor) const;
+
+        // Refits the bounds after points[start, start + count) moved.
+        void update(const TypedBufferAttribute<float>& positions, size_t start, size_t count);
+
+        // Refits the bounds of the points in positions.updateRanges, else in positions.updateRange,
+        // or of all points when neither is set. The ranges are left for the renderer to upload.
+        void update(const TypedBufferAttribute<float>& positions);
+
+        // Whether the octree is up-to-date with the attribute.
+        [[nodiscard]] bool matches(const TypedBufferAttribute<float>& positions) const;
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] const Box3& bounds() const;
+
+        static std::shared_ptr<PointOctree> create(const TypedBufferAttribute<float>& positions, unsigned int threads = 1);
+
+        ~PointOctree();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pimpl_;
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_POINTOCTREE_HPP
@@ -17,6 +17,10 @@ namespace threepp {
     class Camera;
     class Object3D;
 
+    namespace utils {
+        class ThreadPool;
+    }
+
     struct Intersection {
 
         float distance;
@@ -29,9 +33,47 @@ namespace threepp {
         std::optional<Vector2> uv2;
         std::optional<Face3> face;
         std::optional<int> instanceId;
+        std::optional<int> batchId;
         std::optional<float> distanceToRay;
     };
 
+    // Intersections of a batch of rays, kept in one flat buffer that is reused between batches.
+    struct RaycastResults {
+
+        // intersections of ray i are intersections[offsets[i], offsets[i + 1]), sorted by distance
+        std::vector<Intersection> intersections;
+        std::vector<size_t> offsets;
+
+        [[nodiscard]] size_t numRays() const {
+
+            return offsets.empty() ? 0 : offsets.size() - 1;
+        }
+
+        [[nodiscard]] size_t numIntersections(size_t ray) const {
+
+            return offsets[ray + 1] - offsets[ray];
+        }
+
+        [[nodiscard]] const Intersection* begin(size_t ray) const {
+
+            return intersections.data() + offsets[ray];
+        }
+
+        [[nodiscard]] const Intersection* end(size_t ray) const {
+
+            return intersections.data() + offsets[ray + 1];
+        }
+
+    private:
+        friend class Raycaster;
+
+        // per job buffers, merged into intersections
+        std::vector<std::vector<Intersection>> jobs_;
+        std::vector<std::vector<size_t>> jobCounts_;
+    };
+
+    // Raycasting is reentrant, so separate Raycaster instances may be used from different threads
+    // as long as the scene is not modified meanwhile.
     class Raycaster {
 
     public:
@@ -42,6 +84,12 @@ namespace threepp {
         Camera* camera;
         Layers layers;
 
+        // Only report the closest intersection of each mesh, letting Mesh::raycast stop early.
+        bool firstHitOnly = false;
+
+        // Number of threads used by intersectBatch.
+        unsigned int threads = 1;
+
         struct Params {
             float lineThreshold = 1;
             float pointsThreshold = 1;
@@ -58,6 +106,19 @@ namespace threepp {
         std::vector<Intersection> intersectObject(Object3D& object, bool recursive = false);
 
         std::vector<Intersection> intersectObjects(const std::vector<Object3D*>& objects, bool recursive = false);
+
+        // Appends to intersects instead of allocating, then sorts it by distance.
+        void intersectObject(Object3D& object, bool recursive, std::vector<Intersection>& intersects);
+
+        void intersectObjects(const std::vector<Object3D*>& objects, bool recursive, std::vector<Intersection>& intersects);
+
+        // Casts every ray against the objects with the settings of this raycaster, spread over threads.
+        // Bounding spheres missing from the geometries are computed up front, as raycasting must not modify the scene.
+        void intersectBatch(const std::vector<Ray>& rays, const std::vector<Object3D*>& objects, RaycastResults& results, bool recursive = false);
+
+    private:
+        std::shared_ptr<utils::ThreadPool> pool_;
+        unsigned int poolThreads_ = 0;
     };
 
 }// namespace threepp
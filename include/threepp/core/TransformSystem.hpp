@@ -0,0 +1,51 @@
+
+#ifndef THREEPP_TRANSFORMSYSTEM_HPP
+#define THREEPP_TRANSFORMSYSTEM_HPP
+
+#include <cstddef>
+#include <memory>
+
+namespace threepp {
+
+    class Object3D;
+
+    // Optional replacement for the recursive Object3D::updateMatrixWorld.
+    // The hierarchy is flattened breadth first, so that local TRS, local matrices
+    // and world matrices live in contiguous arrays ordered by depth. Each level is
+    // updated in a linear pass, optionally spread over several threads.
+    // Object3D::matrix and Object3D::matrixWorld are rebound to views into that storage,
+    // so code reading them keeps working.
+    //
+    // Objects with their own updateMatrixWorld logic (cameras, skinned meshes, some helpers)
+    // and objects sharing matrices with another object are updated the regular way, together
+    // with their descendants, once their parent is done. Sharing is detected within the hierarchy only:
+    // a helper following an object (see Object3D::shareMatrix) has to be added below the same root.
+    //
+    // Usage: set scene->autoUpdate = false and call update() before rendering.
+    class TransformSystem {
+
+    public:
+        explicit TransformSystem(Object3D& root, unsigned int threads = 1);
+
+        TransformSystem(const TransformSystem&) = delete;
+        TransformSystem operator=(const TransformSystem&) = delete;
+
+        // Flattens the hierarchy again. Called automatically when update() detects added or removed objects.
+        void rebuild();
+
+        // Recomputes all world matrices.
+        void update();
+
+        // Number of objects in the contiguous storage.
+        [[nodiscard]] size_t size() const;
+
+        ~TransformSystem();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pimpl_;
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_TRANSFORMSYSTEM_HPP
@@ -0,0 +1,64 @@
+
+#ifndef THREEPP_TRIANGLEBVH_HPP
+#define THREEPP_TRIANGLEBVH_HPP
+
+#include <functional>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace threepp {
+
+    class Box3;
+    class BufferGeometry;
+    class Ray;
+
+    // Bounding volume hierarchy over the triangles of a geometry, in its local space.
+    // Assign it to BufferGeometry::boundsTree (see BufferGeometry::computeBoundsTree) to accelerate Mesh::raycast.
+    //
+    // Triangles are numbered like Intersection::faceIndex, covering the whole index or position attribute;
+    // groups and the draw range are applied when querying. Rebuild it after editing the positions or the index.
+    class TriangleBVH {
+
+    public:
+        // Geometries with more triangles than this are split on worker threads.
+        static constexpr size_t parallelThreshold = 65536;
+
+        explicit TriangleBVH(const BufferGeometry& geometry, unsigned int threads = 1);
+
+        TriangleBVH(const TriangleBVH&) = delete;
+        TriangleBVH& operator=(const TriangleBVH&) = delete;
+
+        // Calls visitor with the triangles whose bounds are hit by the ray between near and far, nearest nodes first.
+        // The visitor returns the new far distance, so that returning the distance of a hit skips everything behind it.
+        void intersectRay(const Ray& ray, const std::function<float(unsigned int triangle)>& visitor,
+                          float near = 0, float far = std::numeric_limits<float>::infinity()) const;
+
+        // Whether the hierarchy was built for a geometry with the same number of triangles.
+        [[nodiscard]] bool matches(const BufferGeometry& geometry) const;
+
+        [[nodiscard]] size_t triangleCount() const;
+
+        [[nodiscard]] const Box3& bounds() const;
+
+        // Writes the hierarchy in a binary format read by deserialize.
+        void serialize(std::ostream& out) const;
+
+        // Returns nullptr if the stream does not hold a serialized hierarchy.
+        static std::shared_ptr<TriangleBVH> deserialize(std::istream& in);
+
+        static std::shared_ptr<TriangleBVH> create(const BufferGeometry& geometry, unsigned int threads = 1);
+
+        ~TriangleBVH();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pimpl_;
+
+        TriangleBVH();
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_TRIANGLEBVH_HPP
@@ -196,7 +196,7 @@ namespace threepp {
                 body->setActivationState(DISABLE_DEACTIVATION);
             }
 
-            mesh->addEventListener("remove", &onMeshRemovedListener);
+            mesh->addEventListener(events::remove, &onMeshRemovedListener);
 
             meshMap[mesh] = std::make_unique<RigidBodyConstructionInfo>(std::move(shape), std::move(motionState), std::move(body));
         }
@@ -226,7 +226,7 @@ namespace threepp {
                 instancedMeshMap[mesh].emplace_back(std::make_unique<RigidBodyConstructionInfo>(shape, std::move(motionState), std::move(body)));
             }
 
-            mesh->addEventListener("remove", &onInstancedMeshRemovedListener);
+            mesh->addEventListener(events::remove, &onInstancedMeshRemovedListener);
         }
 
         void setMeshPosition(Mesh& mesh, const Vector3& position, unsigned int index = 0) {
@@ -5,6 +5,7 @@
 #include "threepp/textures/Texture.hpp"
 
 #include <filesystem>
+#include <future>
 #include <memory>
 
 namespace threepp {
@@ -18,6 +19,11 @@ namespace threepp {
 
         std::shared_ptr<Texture> loadFromMemory(const std::string& name, const std::vector<unsigned char>& data, bool flipY = true);
 
+        // Decodes the image on a worker thread. The returned future becomes ready once the texture can be used.
+        // When generateMipmaps is true, the full mipmap chain is also computed on the worker thread,
+        // which allows the renderer to stream the texture in coarse-to-fine (see GLRenderer::textureStreaming).
+        std::future<std::shared_ptr<Texture>> loadAsync(const std::filesystem::path& path, bool flipY = true, bool generateMipmaps = true);
+
         void clearCache();
 
         ~TextureLoader();
@@ -14,6 +14,7 @@ namespace threepp {
 
     class Capsule {
 
+    public:
         Vector3 start;
         Vector3 end;
         float radius;
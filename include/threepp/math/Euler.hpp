@@ -5,6 +5,9 @@
 
 #include "float_view.hpp"
 
+#include <functional>
+#include <optional>
+
 namespace threepp {
 
     class Vector3;
@@ -20,7 +23,7 @@ namespace threepp {
      *
      * Iterating through a Euler instance will yield its components (x, y, z, order) in the corresponding order.
      */
-    class Euler {
+    class Euler: private float_view_owner {
 
     public:
         enum RotationOrders {
@@ -40,6 +43,10 @@ namespace threepp {
 
         explicit Euler(float x = 0, float y = 0, float z = 0, RotationOrders order = default_order);
 
+        // listeners and the link to a quaternion are not copied
+        Euler(const Euler& other);
+        Euler& operator=(const Euler& other);
+
         [[nodiscard]] RotationOrders getOrder() const;
 
         void setOrder(RotationOrders value);
@@ -65,7 +72,7 @@ namespace threepp {
             this->y.value_ = array[offset + 1];
             this->z.value_ = array[offset + 2];
 
-            this->onChangeCallback_();
+            this->changed();
 
             return *this;
         }
@@ -82,7 +89,18 @@ namespace threepp {
     private:
         RotationOrders order_ = default_order;
 
-        std::function<void()> onChangeCallback_ = [] {};
+        std::function<void()> onChangeCallback_;
+
+        // when linked, writes mark the quaternion stale and stale angles are recomputed from it on read
+        Quaternion* quaternion_ = nullptr;
+
+        void link(Quaternion& quaternion);
+
+        void attach();
+
+        void refresh() override;
+
+        void changed() final;
 
         friend class Object3D;
         friend class Quaternion;
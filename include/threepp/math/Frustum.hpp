@@ -33,6 +33,9 @@ namespace threepp {
 
         [[nodiscard]] bool intersectsBox(const Box3& box) const;
 
+        // Whether the box is fully inside the frustum.
+        [[nodiscard]] bool containsBox(const Box3& box) const;
+
         [[nodiscard]] bool containsPoint(const Vector3& point) const;
 
         [[nodiscard]] const std::array<Plane, 6>& planes() const;
@@ -0,0 +1,76 @@
+// https://github.com/mrdoob/three.js/blob/r150/examples/jsm/math/Octree.js
+
+#ifndef THREEPP_OCTREE_HPP
+#define THREEPP_OCTREE_HPP
+
+#include "threepp/math/Triangle.hpp"
+#include "threepp/math/Vector3.hpp"
+
+#include <memory>
+#include <optional>
+
+namespace threepp {
+
+    class Box3;
+    class Capsule;
+    class Object3D;
+    class Ray;
+    class Sphere;
+
+    // Static collision world of world-space triangles, e.g. the level geometry of a first-person game.
+    // Queries are const and may run concurrently with each other.
+    class Octree {
+
+    public:
+        struct Collision {
+            // direction in which to move the collider out of the geometry
+            Vector3 normal;
+            float depth;
+        };
+
+        struct RayHit {
+            float distance;
+            Triangle triangle;
+            Vector3 position;
+        };
+
+        // Worlds with more triangles than this are built on worker threads.
+        static constexpr size_t parallelThreshold = 1 << 14;
+
+        Octree();
+
+        Octree(const Octree&) = delete;
+        Octree& operator=(const Octree&) = delete;
+
+        // Adds a world-space triangle, which is not queried until the next build.
+        Octree& addTriangle(const Triangle& triangle);
+
+        Octree& build(unsigned int threads = 1);
+
+        // Adds the triangles of every mesh in the graph, in world space, and builds the octree.
+        Octree& fromGraphNode(Object3D& group, unsigned int threads = 1);
+
+        void clear();
+
+        // Penetration of the sphere into the world, after resolving each overlapping triangle in turn.
+        [[nodiscard]] std::optional<Collision> sphereIntersect(const Sphere& sphere) const;
+
+        [[nodiscard]] std::optional<Collision> capsuleIntersect(const Capsule& capsule) const;
+
+        // Nearest front-facing triangle hit by the ray.
+        [[nodiscard]] std::optional<RayHit> rayIntersect(const Ray& ray) const;
+
+        [[nodiscard]] size_t triangleCount() const;
+
+        [[nodiscard]] const Box3& bounds() const;
+
+        ~Octree();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pimpl_;
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_OCTREE_HPP
@@ -13,7 +13,7 @@ namespace threepp {
     class Matrix4;
     class Euler;
 
-    class Quaternion {
+    class Quaternion: private float_view_owner {
 
     public:
         float_view x;
@@ -23,6 +23,10 @@ namespace threepp {
 
         explicit Quaternion(float x = 0, float y = 0, float z = 0, float w = 1);
 
+        // listeners and the link to an euler are not copied
+        Quaternion(const Quaternion& other);
+        Quaternion& operator=(const Quaternion& other);
+
         float operator[](unsigned int index) const;
 
         Quaternion& set(float x, float y, float z, float w);
@@ -83,7 +87,7 @@ namespace threepp {
             this->z.value_ = array[offset + 2];
             this->w.value_ = array[offset + 3];
 
-            this->onChangeCallback_();
+            this->changed();
 
             return *this;
         }
@@ -103,7 +107,18 @@ namespace threepp {
         }
 
     private:
-        std::function<void()> onChangeCallback_ = [] {};
+        std::function<void()> onChangeCallback_;
+
+        // when linked, writes mark the euler stale and a stale quaternion is recomputed from it on read
+        Euler* euler_ = nullptr;
+
+        void attach();
+
+        void refresh() override;
+
+        void changed() final;
+
+        friend class Euler;
     };
 
 }// namespace threepp
@@ -0,0 +1,31 @@
+
+#ifndef THREEPP_BATCH_HPP
+#define THREEPP_BATCH_HPP
+
+#include "threepp/math/Matrix4.hpp"
+#include "threepp/math/Vector3.hpp"
+
+#include <cstddef>
+
+// Batch versions of the per-vector and per-matrix operations, using SSE/NEON when available.
+// Items are read from data + i * stride, so interleaved arrays can be processed in place.
+namespace threepp::math {
+
+    // Transforms count points by m, including the perspective divide (see Vector3::applyMatrix4).
+    void applyMatrix4(const Matrix4& m, float* data, size_t count, size_t stride = 3);
+
+    // Transforms count directions by the upper 3x3 of m and normalizes them (see Vector3::transformDirection).
+    void transformDirections(const Matrix4& m, float* data, size_t count, size_t stride = 3);
+
+    // Computes the axis-aligned bounds of count points.
+    void computeBounds(const float* data, size_t count, size_t stride, Vector3& min, Vector3& max);
+
+    // out[i] = a[i] * b[i]
+    void multiplyMatrices(const Matrix4* a, const Matrix4* b, Matrix4* out, size_t count);
+
+    // Composes count matrices from positions (xyz), quaternions (xyzw) and scales (xyz) (see Matrix4::compose).
+    void composeMatrices(const float* positions, const float* quaternions, const float* scales, Matrix4* out, size_t count);
+
+}// namespace threepp::math
+
+#endif//THREEPP_BATCH_HPP
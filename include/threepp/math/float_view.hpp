@@ -1,157 +1,168 @@
-
 #ifndef THREEPP_FLOAT_VIEW_HPP
 #define THREEPP_FLOAT_VIEW_HPP
 
-#include <functional>
-#include <optional>
+#include <algorithm>
 #include <ostream>
-#include <utility>
 
 namespace threepp {
 
-    // An internal wrapper around float that allows listeners to be notified about changes.
+    class float_view;
+
+    // Owner of a group of float_views, e.g. the components of an Euler or Quaternion.
+    // It is notified when a component is written, and asked to refresh
+    // its components before a stale one is read or written.
+    class float_view_owner {
+
+    protected:
+        bool stale_ = false;
+
+        virtual void refresh() = 0;
+
+        virtual void changed() = 0;
+
+        ~float_view_owner() = default;
+
+        friend class float_view;
+    };
+
+    // An internal wrapper around float that allows its owner to be notified about changes.
+    // Without an owner it behaves like a plain float.
     class float_view {
 
     public:
         float_view(float value = 0)
             : value_(value) {}
 
+        // the owner is not copied
+        float_view(const float_view& other)
+            : value_(other()) {}
+
         inline float operator()() const {
 
+            if (owner_ && owner_->stale_) owner_->refresh();
+
             return value_;
         }
 
         inline float_view& operator=(float v) {
 
-            this->value_ = v;
-            if (f_) f_.value()();
+            if (owner_) {
+
+                if (owner_->stale_) owner_->refresh();
+                value_ = v;
+                owner_->changed();
+
+            } else {
+
+                value_ = v;
+            }
 
             return *this;
         }
 
+        inline float_view& operator=(const float_view& other) {
+
+            return *this = other();
+        }
+
         inline float operator*(float f) const {
 
-            return value_ * f;
+            return (*this)() * f;
         }
 
         inline float operator*(const float_view& f) const {
 
-            return value_ * f.value_;
+            return (*this)() * f();
         }
 
         inline float_view& operator*=(float f) {
 
-            value_ *= f;
-            if (f_) f_.value()();
-
-            return *this;
+            return *this = (*this)() * f;
         }
 
         inline float operator/(float f) const {
 
-            return value_ / f;
+            return (*this)() / f;
         }
 
         inline float_view& operator/=(float f) {
 
-            value_ /= f;
-            if (f_) f_.value()();
-
-            return *this;
+            return *this = (*this)() / f;
         }
 
         inline float operator+(float f) const {
 
-            return value_ + f;
+            return (*this)() + f;
         }
 
         inline float operator+(const float_view& f) const {
 
-            return value_ + f.value_;
+            return (*this)() + f();
         }
 
         inline float_view& operator+=(float f) {
 
-            value_ += f;
-            if (f_) f_.value()();
-
-            return *this;
+            return *this = (*this)() + f;
         }
 
         inline float operator-(float f) const {
 
-            return value_ - f;
+            return (*this)() - f;
         }
 
         inline float operator-(const float_view& f) const {
 
-            return value_ - f.value_;
+            return (*this)() - f();
         }
 
         inline float_view& operator-=(float f) {
 
-            value_ -= f;
-            if (f_) f_.value()();
-
-            return *this;
+            return *this = (*this)() - f;
         }
 
         inline float_view& operator++() {
 
-            value_++;
-            if (f_) f_.value()();
-
-            return *this;
+            return *this = (*this)() + 1;
         }
 
         inline float_view& operator--() {
 
-            value_--;
-            if (f_) f_.value()();
-
-            return *this;
+            return *this = (*this)() - 1;
         }
 
         inline bool operator==(float other) const {
 
-            return value_ == other;
+            return (*this)() == other;
         }
 
         inline bool operator!=(float other) const {
 
-            return value_ != other;
+            return (*this)() != other;
         }
 
         inline bool operator==(const float_view& other) const {
 
-            return value_ == other.value_;
+            return (*this)() == other();
         }
 
         inline bool operator!=(const float_view& other) const {
 
-            return value_ != other.value_;
-        }
-
-        inline constexpr float_view& clamp(float min, float max) {
-
-            value_ = std::max(min, std::min(max, value_));
-
-            return *this;
+            return (*this)() != other();
         }
 
-        void setCallback(std::function<void()> f) {
+        inline float_view& clamp(float min, float max) {
 
-            f_ = std::move(f);
+            return *this = std::max(min, std::min(max, (*this)()));
         }
 
         friend std::ostream& operator<<(std::ostream& os, const float_view& f) {
-            os << f.value_;
+            os << f();
             return os;
         }
 
     private:
         float value_;
-        std::optional<std::function<void()>> f_;
+        float_view_owner* owner_ = nullptr;
 
         friend class Euler;
         friend class Quaternion;
@@ -0,0 +1,76 @@
+// https://github.com/mrdoob/three.js/blob/r159/src/objects/BatchedMesh.js
+
+#ifndef THREEPP_BATCHEDMESH_HPP
+#define THREEPP_BATCHEDMESH_HPP
+
+#include "threepp/objects/Mesh.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace threepp {
+
+    class Camera;
+    class DataTexture;
+    class Frustum;
+
+    // Many geometries sharing an attribute layout, drawn in one call with a matrix each.
+    // Geometries are added and removed at runtime, their vertices and indices being sub-allocated in the buffers of
+    // the mesh. The matrices are kept in a float texture, read by the vertex shader through the batchId attribute.
+    class BatchedMesh: public Mesh {
+
+    public:
+        // Culls the geometries one by one against the camera frustum.
+        bool perObjectFrustumCulled = true;
+
+        // Offsets and counts, in indices, of the geometries to draw.
+        struct DrawRanges {
+            std::vector<int> starts;
+            std::vector<int> counts;
+        };
+
+        BatchedMesh(size_t maxGeometryCount, size_t maxVertexCount, size_t maxIndexCount, std::shared_ptr<Material> material = nullptr);
+
+        [[nodiscard]] std::string type() const override;
+
+        // Copies the geometry into the shared buffers and returns its id. The first geometry added sets the
+        // attributes of the others. Throws std::runtime_error when out of room.
+        int addGeometry(const BufferGeometry& geometry);
+
+        // Frees the room of the geometry for the geometries added next.
+        void removeGeometry(int id);
+
+        void setMatrixAt(int id, const Matrix4& matrix);
+
+        void getMatrixAt(int id, Matrix4& matrix) const;
+
+        void setVisibleAt(int id, bool visible);
+
+        [[nodiscard]] bool getVisibleAt(int id) const;
+
+        [[nodiscard]] size_t geometryCount() const;
+
+        [[nodiscard]] DataTexture& matricesTexture() const;
+
+        // Keeps the visible geometries whose bounds intersect the frustum. Called by the renderer each frame when
+        // perObjectFrustumCulled is set.
+        void cull(const Frustum& frustum, const Camera& camera);
+
+        // The geometries culled for camera, or all visible geometries if they were not culled for it.
+        const DrawRanges& drawRanges(const Camera& camera);
+
+        // Reports the id of the geometry hit as batchId.
+        void raycast(Raycaster& raycaster, std::vector<Intersection>& intersects) override;
+
+        static std::shared_ptr<BatchedMesh> create(size_t maxGeometryCount, size_t maxVertexCount, size_t maxIndexCount, std::shared_ptr<Material> material = nullptr);
+
+        ~BatchedMesh() override;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pimpl_;
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_BATCHEDMESH_HPP
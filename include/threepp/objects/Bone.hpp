@@ -16,7 +16,7 @@ namespace threepp {
 
         static std::shared_ptr<Bone> create() {
 
-            return std::make_shared<Bone>();
+            return utils::makePooled<Bone>();
         }
     };
 
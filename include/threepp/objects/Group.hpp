@@ -3,6 +3,9 @@
 #define THREEPP_GROUP_HPP
 
 #include "threepp/core/Object3D.hpp"
+#include "threepp/math/Box3.hpp"
+
+#include <optional>
 
 namespace threepp {
 
@@ -16,7 +19,21 @@ namespace threepp {
 
         static std::shared_ptr<Group> create();
 
+        // Recomputes subtreeBounds from the cached world bounds of the descendants, including nested groups.
+        void updateSubtreeBounds();
+
+        // World space bounds of all descendants as of the last updateSubtreeBounds, used by the renderer to
+        // cull the whole subtree with one test. Empty when the subtree has to be visited regardless,
+        // e.g. because it holds lights or objects that are not frustum culled.
+        [[nodiscard]] const std::optional<Box3>& subtreeBounds() const;
+
         ~Group() override = default;
+
+    private:
+        std::optional<Box3> subtreeBounds_;
+
+        // expands box by object and its descendants, returns false if the subtree can not be culled
+        static bool expandBySubtree(Object3D& object, Box3& box);
     };
 
 }// namespace threepp
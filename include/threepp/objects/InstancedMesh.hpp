@@ -6,16 +6,39 @@
 #include "Mesh.hpp"
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace threepp {
 
+    class Camera;
+    class Frustum;
+
     class InstancedMesh: public Mesh {
 
     public:
-        const size_t count;
+        // Number of instances drawn, at most capacity().
+        size_t count;
         std::unique_ptr<FloatBufferAttribute> instanceMatrix;
         std::unique_ptr<FloatBufferAttribute> instanceColor = nullptr;
 
+        // Opt-in culling of the individual instances, for instances spread over a large area.
+        // The renderer then draws only the instances whose bounds intersect the camera frustum, compacted per level.
+        bool cullInstances = false;
+
+        // A geometry, and the instances drawn with it after the last cull.
+        struct Level {
+            std::shared_ptr<BufferGeometry> geometry;
+            float distance = 0;
+
+            std::unique_ptr<FloatBufferAttribute> instanceMatrix;
+            std::unique_ptr<FloatBufferAttribute> instanceColor;
+            size_t count = 0;
+
+            Level(std::shared_ptr<BufferGeometry> geometry, float distance)
+                : geometry(std::move(geometry)), distance(distance) {}
+        };
+
         InstancedMesh(
                 std::shared_ptr<BufferGeometry> geometry,
                 std::shared_ptr<Material> material,
@@ -23,16 +46,44 @@ namespace threepp {
 
         [[nodiscard]] std::string type() const override;
 
+        [[nodiscard]] size_t capacity() const;
+
+        // Grows the instance buffers to hold at least capacity instances.
+        void reserve(size_t capacity);
+
+        // Appends an instance, growing the capacity as needed, and returns its index.
+        size_t addInstance(const Matrix4& matrix);
+
+        // Moves the last instance into index, so that the drawn instances stay dense.
+        void removeInstance(size_t index);
+
         void getColorAt(size_t index, Color& color) const;
 
         void getMatrixAt(size_t index, Matrix4& matrix) const;
 
+        // The setters mark the instance for upload, so that only the modified instances are sent to the GPU.
+        // Writes made through the arrays directly must add their own update range, or clear the pending ones.
         void setColorAt(size_t index, const Color& color);
 
         void setMatrixAt(size_t index, const Matrix4& matrix) const;
 
+        // Draws the instances at least distance away from the camera with geometry, when culling instances.
+        void addLevel(std::shared_ptr<BufferGeometry> geometry, float distance);
+
+        // Level 0 holds the geometry of the mesh, the others are ordered by distance.
+        [[nodiscard]] const std::vector<Level>& levels() const;
+
+        // Compacts the instances whose bounds intersect the frustum into the levels, by their distance to the camera.
+        // Called by the renderer each frame when cullInstances is set.
+        void cull(const Frustum& frustum, const Camera& camera);
+
+        // The level drawn with geometry when rendering from camera, or nullptr if the instances were not culled for it.
+        [[nodiscard]] const Level* culledLevel(const BufferGeometry* geometry, const Camera& camera) const;
+
         void dispose();
 
+        // Tests only the instances whose world bounds the ray hits, using a hierarchy over the instances.
+        // The hierarchy is refit when instanceMatrix->version changes, as it does in setMatrixAt.
         void raycast(Raycaster& raycaster, std::vector<Intersection>& intersects) override;
 
         static std::shared_ptr<InstancedMesh> create(
@@ -43,9 +94,14 @@ namespace threepp {
         ~InstancedMesh() override;
 
     private:
-        Mesh _mesh;
         bool disposed{false};
 
+        struct InstanceBVH;
+        std::unique_ptr<InstanceBVH> instanceBVH_;
+
+        std::vector<Level> levels_;
+        std::optional<unsigned int> culledCamera_;
+
     };
 
 }// namespace threepp
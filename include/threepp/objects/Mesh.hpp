@@ -61,6 +61,10 @@ namespace threepp {
     protected:
         std::shared_ptr<BufferGeometry> geometry_;
         std::vector<std::shared_ptr<Material>> materials_;
+
+        // Raycasts the geometry as if placed by the given world matrix, reporting this object.
+        // range replaces the draw range of the geometry.
+        void raycastGeometry(Raycaster& raycaster, std::vector<Intersection>& intersects, const Matrix4& matrixWorld, std::optional<DrawRange> range = std::nullopt);
     };
 
 }// namespace threepp
@@ -38,7 +38,7 @@ namespace threepp {
 
         static std::shared_ptr<SkinnedMesh> create(const std::shared_ptr<BufferGeometry>& geometry, const std::shared_ptr<Material>& material) {
 
-            return std::make_shared<SkinnedMesh>(geometry, material);
+            return utils::makePooled<SkinnedMesh>(geometry, material);
         }
     };
 
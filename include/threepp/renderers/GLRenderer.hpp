@@ -17,6 +17,7 @@
 #include "threepp/renderers/gl/GLShadowMap.hpp"
 #include "threepp/renderers/gl/GLState.hpp"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -29,6 +30,7 @@ namespace threepp {
     class Material;
     class Texture;
     class GLRenderTarget;
+    struct Intersection;
 
     class GLRenderer {
 
@@ -51,6 +53,13 @@ namespace threepp {
 
         bool sortObjects = true;
 
+        // groups are culled as a whole when all of their descendants are outside the frustum (see Group::subtreeBounds)
+        bool groupCulling = true;
+
+        // opaque meshes sharing a geometry and a material are drawn with one instanced call,
+        // their world matrices being written to an instance buffer each frame.
+        bool autoInstancing = false;
+
         // user-defined clipping
 
         std::vector<Plane> clippingPlanes;
@@ -65,6 +74,12 @@ namespace threepp {
 
         bool physicallyCorrectLights = false;
 
+        // clustered lighting
+        // point and spot lights without shadows are binned into view space clusters, so that
+        // each fragment only shades nearby lights and lights can be added without recompiling.
+
+        bool clusteredLighting = false;
+
         // tone mapping
 
         ToneMapping toneMapping{ToneMapping::None};
@@ -72,6 +87,20 @@ namespace threepp {
 
         bool checkShaderErrors = false;
 
+        // texture streaming
+        // textures with a CPU mipmap chain (see TextureLoader::loadAsync) are uploaded coarse-to-fine,
+        // finer levels following the projected screen size of the objects using them.
+
+        bool textureStreaming = false;
+        size_t textureStreamingBudget = 4 * 1024 * 1024;// bytes uploaded per frame
+
+        // when GPU memory (see GLInfo::memory) exceeds the budget, textures and geometries
+        // unused for evictAfterFrames frames are released, least recently used first.
+        // evicted resources are uploaded again on next use.
+
+        std::optional<size_t> memoryBudget;// bytes
+        unsigned int evictAfterFrames = 60;
+
         explicit GLRenderer(WindowSize size, const Parameters& parameters = {});
 
         GLRenderer(GLRenderer&&) = delete;
@@ -150,6 +179,20 @@ namespace threepp {
 
         void readPixels(const Vector2& position, const WindowSize& size, Format format, unsigned char* data);
 
+        // GPU picking
+        // renders the ids of the objects within radius pixels of coords (normalized device coordinates, as for
+        // Raycaster::setFromCamera), using the same culling as render, and reads them back without stalling.
+        // callback is called from a later render, pick or pollPicks, with one intersection per distinct object,
+        // instance and face (or index, for lines and points), nearest first. Objects destroyed before the callback are left out.
+        // Face indices are only available on desktop GL. Sprites are not picked.
+
+        using PickCallback = std::function<void(const std::vector<Intersection>&)>;
+
+        void pick(Scene& scene, Camera& camera, const Vector2& coords, const PickCallback& callback, unsigned int radius = 0);
+
+        // calls back the picks whose results have arrived, with wait blocking until all have
+        void pollPicks(bool wait = false);
+
         void resetState();
 
         [[nodiscard]] const gl::GLInfo& info() const;
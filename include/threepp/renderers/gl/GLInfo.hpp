@@ -14,8 +14,23 @@ namespace threepp::gl {
         size_t geometries{0};
         size_t textures{0};
 
+        // estimated GPU memory in bytes
+        size_t textureBytes{0};
+        size_t renderTargetBytes{0};
+        size_t bufferBytes{0};
+
+        // number of resources evicted to stay within GLRenderer::memoryBudget
+        size_t evictions{0};
+
+        [[nodiscard]] size_t totalBytes() const {
+
+            return textureBytes + renderTargetBytes + bufferBytes;
+        }
+
         friend std::ostream& operator<<(std::ostream& os, const MemoryInfo& m) {
-            os << "MemoryInfo: geomestries=" << m.geometries << ", textures=" << m.textures;
+            os << "MemoryInfo: geomestries=" << m.geometries << ", textures=" << m.textures
+               << ", textureBytes=" << m.textureBytes << ", renderTargetBytes=" << m.renderTargetBytes
+               << ", bufferBytes=" << m.bufferBytes << ", evictions=" << m.evictions;
             return os;
         }
     };
@@ -27,9 +42,11 @@ namespace threepp::gl {
         size_t triangles{0};
         size_t points{0};
         size_t lines{0};
+        // world matrices recomputed by the scene graph update of the last render
+        size_t matrices{0};
 
         friend std::ostream& operator<<(std::ostream& os, const RenderInfo& m) {
-            os << "RenderInfo: frame=" << m.frame << ", calls=" << m.calls << ", triangles=" << m.triangles << ", points=" << m.points << ", lines=" << m.lines;
+            os << "RenderInfo: frame=" << m.frame << ", calls=" << m.calls << ", triangles=" << m.triangles << ", points=" << m.points << ", lines=" << m.lines << ", matrices=" << m.matrices;
             return os;
         }
     };
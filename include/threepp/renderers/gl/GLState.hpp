@@ -183,6 +183,9 @@ namespace threepp {
 
             void unbindTexture();
 
+            // forget cached bindings of a texture about to be deleted, as GL may reuse its name
+            void releaseTexture(int glTexture);
+
             void texImage2D(unsigned int target, int level, int internalFormat, int width, int height, unsigned int format, unsigned int type, const void* pixels);
 
             void texImage3D(unsigned int target, int level, int internalFormat, int width, int height, int depth, unsigned int format, unsigned int type, const void* pixels);
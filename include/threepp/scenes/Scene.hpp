@@ -7,6 +7,7 @@
 
 #include "threepp/scenes/Fog.hpp"
 #include "threepp/scenes/FogExp2.hpp"
+#include "threepp/scenes/SceneBVH.hpp"
 
 #include <memory>
 #include <variant>
@@ -27,6 +28,9 @@ namespace threepp {
 
         bool autoUpdate = true;
 
+        // Optional hierarchy over the static objects of the scene, queried by the renderer, the shadow pass and Raycaster.
+        std::shared_ptr<SceneBVH> bvh;
+
         static std::shared_ptr<Scene> create();
     };
 
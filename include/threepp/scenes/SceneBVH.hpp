@@ -0,0 +1,72 @@
+
+#ifndef THREEPP_SCENEBVH_HPP
+#define THREEPP_SCENEBVH_HPP
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace threepp {
+
+    class Box3;
+    class Frustum;
+    class Object3D;
+    class Ray;
+
+    // Bounding volume hierarchy over the world bounds of static objects (see Object3D::isStatic).
+    // Assign it to Scene::bvh to let the renderer, the shadow pass and Raycaster query it
+    // instead of testing every static object.
+    //
+    // Only meshes, lines and points that are frustum culled and not skinned are included.
+    // Objects removed from the graph or destroyed are dropped from the hierarchy, and subtrees that get
+    // new children are no longer skipped. Build it again after adding static objects, and refit it after moving them.
+    class SceneBVH {
+
+    public:
+        // Nodes holding more objects than this are split on worker threads.
+        static constexpr size_t parallelThreshold = 4096;
+
+        explicit SceneBVH(unsigned int threads = 1);
+
+        SceneBVH(const SceneBVH&) = delete;
+        SceneBVH& operator=(const SceneBVH&) = delete;
+
+        // Collects the static objects below root and builds the hierarchy using binned SAH.
+        void build(Object3D& root);
+
+        // Updates the bounds of the given objects and of the nodes above them. Returns the number of objects that moved.
+        size_t refit(const std::vector<Object3D*>& objects);
+
+        // Checks every object for changed bounds, refitting the nodes above those that moved. Returns the number of objects that moved.
+        size_t refit();
+
+        // Appends the objects whose world bounding boxes intersect the frustum.
+        void intersectFrustum(const Frustum& frustum, std::vector<Object3D*>& result) const;
+
+        // Appends the objects whose world bounds are hit by the ray between near and far.
+        void intersectRay(const Ray& ray, std::vector<Object3D*>& result, float near = 0, float far = std::numeric_limits<float>::infinity()) const;
+
+        // Whether the object is in the hierarchy.
+        [[nodiscard]] bool contains(const Object3D& object) const;
+
+        // Whether the object and all its descendants are either in the hierarchy or plain Object3D/Group nodes,
+        // so that traversals can skip the whole subtree.
+        [[nodiscard]] bool coversSubtree(const Object3D& object) const;
+
+        // Number of objects in the hierarchy.
+        [[nodiscard]] size_t size() const;
+
+        // Bounds of all objects in the hierarchy.
+        [[nodiscard]] const Box3& bounds() const;
+
+        ~SceneBVH();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pimpl_;
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_SCENEBVH_HPP
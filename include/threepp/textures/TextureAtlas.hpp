@@ -0,0 +1,67 @@
+
+#ifndef THREEPP_TEXTUREATLAS_HPP
+#define THREEPP_TEXTUREATLAS_HPP
+
+#include "threepp/textures/Texture.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace threepp {
+
+    class Object3D;
+
+    // A rectangle of an atlas page. The renderer binds the page in its place,
+    // offset and repeat map the original uv range onto the region.
+    class AtlasTexture: public Texture {
+
+    public:
+        [[nodiscard]] const std::shared_ptr<Texture>& page() const {
+
+            return page_;
+        }
+
+        static std::shared_ptr<AtlasTexture> create(std::shared_ptr<Texture> page) {
+
+            return std::shared_ptr<AtlasTexture>(new AtlasTexture(std::move(page)));
+        }
+
+    private:
+        std::shared_ptr<Texture> page_;
+
+        explicit AtlasTexture(std::shared_ptr<Texture> page)
+            : page_(std::move(page)) {}
+    };
+
+    // Packs small 8-bit RGB/RGBA textures into shared atlas pages, so that materials
+    // using them bind the same texture. Textures are grouped by format and encoding.
+    // Repeat wrapping is not supported for atlas regions: only clamped, unrotated textures are eligible,
+    // as uvs outside [0, 1] sample the padding and then neighbouring regions. Pages are not mipmapped.
+    class TextureAtlas {
+
+    public:
+        explicit TextureAtlas(unsigned int pageSize = 2048, unsigned int maxTextureSize = 256, unsigned int padding = 4);
+
+        TextureAtlas(const TextureAtlas&) = delete;
+        TextureAtlas operator=(const TextureAtlas&) = delete;
+
+        // Returns the atlas region for the texture, or nullptr if it is not eligible.
+        std::shared_ptr<AtlasTexture> add(const std::shared_ptr<Texture>& texture);
+
+        // Replaces the map of sprite and mesh materials in the hierarchy with atlas regions.
+        // Materials using other uv transformed maps are left as is.
+        // Returns the number of materials changed.
+        size_t apply(Object3D& root);
+
+        [[nodiscard]] const std::vector<std::shared_ptr<Texture>>& pages() const;
+
+        ~TextureAtlas();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> pimpl_;
+    };
+
+}// namespace threepp
+
+#endif//THREEPP_TEXTUREATLAS_HPP
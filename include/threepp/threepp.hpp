@@ -25,6 +25,7 @@
 #include "threepp/core/Object3D.hpp"
 #include "threepp/core/Raycaster.hpp"
 
+#include "threepp/objects/BatchedMesh.hpp"
 #include "threepp/objects/Group.hpp"
 #include "threepp/objects/InstancedMesh.hpp"
 #include "threepp/objects/Mesh.hpp"
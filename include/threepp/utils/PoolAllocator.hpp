@@ -0,0 +1,119 @@
+
+#ifndef THREEPP_POOLALLOCATOR_HPP
+#define THREEPP_POOLALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace threepp::utils {
+
+    // Thread safe free list of fixed size blocks.
+    // Blocks are carved from chunks that are kept for reuse until the pool is destroyed.
+    class BlockPool {
+
+    public:
+        explicit BlockPool(size_t blockSize, size_t blocksPerChunk = 256);
+
+        BlockPool(const BlockPool&) = delete;
+        BlockPool& operator=(const BlockPool&) = delete;
+
+        void* allocate();
+
+        void deallocate(void* p) noexcept;
+
+        // Number of blocks currently handed out.
+        [[nodiscard]] size_t size() const;
+
+        // Number of blocks reserved in chunks.
+        [[nodiscard]] size_t capacity() const;
+
+        // Shared pool for blocks of Size bytes. It is never destroyed,
+        // so objects released during static destruction can still be returned to it.
+        template<size_t Size>
+        static BlockPool& instance() {
+
+            static auto* pool = new BlockPool(Size);
+            return *pool;
+        }
+
+    private:
+        struct Node {
+            Node* next;
+        };
+
+        size_t blockSize_;
+        size_t blocksPerChunk_;
+
+        mutable std::mutex m_;
+        Node* free_ = nullptr;
+        size_t size_ = 0;
+        std::vector<std::unique_ptr<std::byte[]>> chunks_;
+    };
+
+    // Allocator for std::allocate_shared and containers, serving single objects from the shared BlockPool of their size.
+    // Arrays and over-aligned types fall back to operator new.
+    template<class T>
+    struct PoolAllocator {
+
+        using value_type = T;
+
+        PoolAllocator() noexcept = default;
+
+        template<class U>
+        PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+        T* allocate(size_t n) {
+
+            if (n == 1 && pooled) {
+
+                return static_cast<T*>(BlockPool::instance<blockSize>().allocate());
+            }
+
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t n) noexcept {
+
+            if (n == 1 && pooled) {
+
+                BlockPool::instance<blockSize>().deallocate(p);
+                return;
+            }
+
+            ::operator delete(p);
+        }
+
+        template<class U>
+        bool operator==(const PoolAllocator<U>&) const noexcept {
+
+            return true;
+        }
+
+        template<class U>
+        bool operator!=(const PoolAllocator<U>&) const noexcept {
+
+            return false;
+        }
+
+    private:
+        static constexpr size_t alignment = alignof(std::max_align_t);
+
+        // sizes are rounded up, so similar types share a pool
+        static constexpr size_t blockSize = (sizeof(T) + alignment - 1) / alignment * alignment;
+        static constexpr bool pooled = alignof(T) <= alignment;
+    };
+
+    // std::make_shared, with the object and its control block served from a BlockPool.
+    template<class T, class... Args>
+    std::shared_ptr<T> makePooled(Args&&... args) {
+
+        return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+    }
+
+}// namespace threepp::utils
+
+#endif//THREEPP_POOLALLOCATOR_HPP
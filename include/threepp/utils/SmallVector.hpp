@@ -0,0 +1,189 @@
+
+#ifndef THREEPP_SMALLVECTOR_HPP
+#define THREEPP_SMALLVECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace threepp::utils {
+
+    // Vector of trivially copyable elements, storing the first N elements inline.
+    // It only allocates once it grows beyond N elements.
+    template<class T, size_t N>
+    class SmallVector {
+
+        static_assert(std::is_trivially_copyable_v<T>, "SmallVector requires trivially copyable elements");
+
+    public:
+        SmallVector() = default;
+
+        SmallVector(const SmallVector& other) {
+
+            assign(other);
+        }
+
+        SmallVector(SmallVector&& other) noexcept {
+
+            steal(other);
+        }
+
+        SmallVector& operator=(const SmallVector& other) {
+
+            if (this != &other) {
+
+                clear();
+                assign(other);
+            }
+
+            return *this;
+        }
+
+        SmallVector& operator=(SmallVector&& other) noexcept {
+
+            if (this != &other) {
+
+                heap_.reset();
+                steal(other);
+            }
+
+            return *this;
+        }
+
+        [[nodiscard]] bool empty() const {
+
+            return size_ == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+
+            return size_;
+        }
+
+        [[nodiscard]] size_t capacity() const {
+
+            return heap_ ? capacity_ : N;
+        }
+
+        T* data() {
+
+            return heap_ ? heap_.get() : inline_;
+        }
+
+        const T* data() const {
+
+            return heap_ ? heap_.get() : inline_;
+        }
+
+        T* begin() {
+
+            return data();
+        }
+
+        T* end() {
+
+            return data() + size_;
+        }
+
+        const T* begin() const {
+
+            return data();
+        }
+
+        const T* end() const {
+
+            return data() + size_;
+        }
+
+        T& operator[](size_t index) {
+
+            return data()[index];
+        }
+
+        const T& operator[](size_t index) const {
+
+            return data()[index];
+        }
+
+        T& back() {
+
+            return data()[size_ - 1];
+        }
+
+        void reserve(size_t capacity) {
+
+            if (capacity <= this->capacity()) return;
+
+            std::unique_ptr<T[]> heap(new T[capacity]);
+            std::copy(begin(), end(), heap.get());
+
+            heap_ = std::move(heap);
+            capacity_ = capacity;
+        }
+
+        void push_back(const T& value) {
+
+            if (size_ == capacity()) {
+
+                const auto copy = value;// value may live in this vector
+                reserve(capacity() * 2);
+                data()[size_++] = copy;
+                return;
+            }
+
+            data()[size_++] = value;
+        }
+
+        void pop_back() {
+
+            --size_;
+        }
+
+        // Removes the element at index, keeping the order of the remaining elements.
+        void erase(size_t index) {
+
+            std::copy(begin() + index + 1, end(), begin() + index);
+            --size_;
+        }
+
+        void clear() {
+
+            size_ = 0;
+        }
+
+    private:
+        T inline_[N]{};
+        std::unique_ptr<T[]> heap_;
+        size_t capacity_ = N;
+        size_t size_ = 0;
+
+        void assign(const SmallVector& other) {
+
+            reserve(other.size_);
+            std::copy(other.begin(), other.end(), data());
+            size_ = other.size_;
+        }
+
+        void steal(SmallVector& other) {
+
+            if (other.heap_) {
+
+                heap_ = std::move(other.heap_);
+                capacity_ = other.capacity_;
+
+            } else {
+
+                std::copy(other.begin(), other.end(), inline_);
+                capacity_ = N;
+            }
+
+            size_ = other.size_;
+            other.size_ = 0;
+            other.capacity_ = N;
+        }
+    };
+
+}// namespace threepp::utils
+
+#endif//THREEPP_SMALLVECTOR_HPP
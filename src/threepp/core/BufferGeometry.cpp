@@ -1,6 +1,9 @@
 
 #include "threepp/core/BufferGeometry.hpp"
 
+#include "threepp/core/PointOctree.hpp"
+#include "threepp/core/TriangleBVH.hpp"
+
 #include "threepp/math/MathUtils.hpp"
 #include "threepp/math/Matrix3.hpp"
 #include "threepp/math/Matrix4.hpp"
@@ -143,6 +146,10 @@ BufferGeometry& BufferGeometry::applyMatrix4(const Matrix4& matrix) {
         position->applyMatrix4(matrix);
 
         position->needsUpdate();
+
+        // the triangles and points moved
+        boundsTree = nullptr;
+        pointsTree = nullptr;
     }
 
 
@@ -345,6 +352,18 @@ void BufferGeometry::computeBoundingBox() {
     }
 }
 
+void BufferGeometry::computeBoundsTree(unsigned int threads) {
+
+    this->boundsTree = TriangleBVH::create(*this, threads);
+}
+
+void BufferGeometry::computePointsTree(unsigned int threads) {
+
+    const auto position = getAttribute<float>("position");
+
+    this->pointsTree = position ? PointOctree::create(*position, threads) : nullptr;
+}
+
 void BufferGeometry::computeBoundingSphere() {
 
     if (!this->boundingSphere) {
@@ -459,6 +478,9 @@ void BufferGeometry::copy(const BufferGeometry& source) {
     this->groups.clear();
     this->boundingBox = std::nullopt;
     this->boundingSphere = std::nullopt;
+    // the hierarchies index into the source's attributes, rebuild them on demand
+    this->boundsTree = nullptr;
+    this->pointsTree = nullptr;
 
     // name
 
@@ -672,7 +694,7 @@ void BufferGeometry::dispose() {
 
     if (!disposed_) {
         disposed_ = true;
-        this->dispatchEvent("dispose", this);
+        this->dispatchEvent(events::dispose, this);
     }
 }
 
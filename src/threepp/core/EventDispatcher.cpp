@@ -1,48 +1,127 @@
 
 #include "threepp/core/EventDispatcher.hpp"
 
-#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
 
 using namespace threepp;
 
+namespace {
 
-void EventDispatcher::addEventListener(const std::string& type, EventListener* listener) {
+    // Append-only, so names can be read without locking: a name is written before the count that
+    // publishes it, and is never moved.
+    class EventTypeRegistry {
 
-    listeners_[type].emplace_back(listener);
-}
+    public:
+        static EventTypeRegistry& instance() {
+
+            static EventTypeRegistry registry;
+            return registry;
+        }
+
+        unsigned int intern(const std::string& name) {
+
+            std::lock_guard<std::mutex> lck(m_);
+
+            auto it = ids_.find(name);
+            if (it != ids_.end()) return it->second;
+
+            const auto id = size_.load(std::memory_order_relaxed);
+            if (id == chunkSize * maxChunks) throw std::length_error("Too many event types");
+
+            auto& chunk = chunks_[id / chunkSize];
+            if (!chunk) chunk = std::make_unique<Chunk>();
+
+            (*chunk)[id % chunkSize] = name;
+            ids_.emplace(name, id);
+
+            size_.store(id + 1, std::memory_order_release);
+
+            return id;
+        }
+
+        const std::string& name(unsigned int id) const {
+
+            if (id >= size_.load(std::memory_order_acquire)) throw std::out_of_range("Unknown event type");
+
+            return (*chunks_[id / chunkSize])[id % chunkSize];
+        }
+
+    private:
+        static constexpr unsigned int chunkSize = 256;
+        static constexpr unsigned int maxChunks = 256;
+
+        using Chunk = std::array<std::string, chunkSize>;
+
+        std::mutex m_;
+        std::array<std::unique_ptr<Chunk>, maxChunks> chunks_;
+        std::atomic<unsigned int> size_{0};
+        std::unordered_map<std::string, unsigned int> ids_;
 
-bool EventDispatcher::hasEventListener(const std::string& type, const EventListener* listener) {
+        EventTypeRegistry() {
 
-    if (!listeners_.count(type)) return false;
+            // same order as the constants in threepp::events
+            for (const auto* name : {"dispose", "added", "remove", "childrenAdded", "childrenRemoved", "destroyed"}) {
 
-    auto& listenerArray = listeners_.at(type);
-    return std::find(listenerArray.begin(), listenerArray.end(), listener) != listenerArray.end();
+                intern(name);
+            }
+        }
+    };
+
+}// namespace
+
+EventType::EventType(const std::string& name)
+    : id_(EventTypeRegistry::instance().intern(name)) {}
+
+const std::string& EventType::name() const {
+
+    return EventTypeRegistry::instance().name(id_);
 }
 
-void EventDispatcher::removeEventListener(const std::string& type, const EventListener* listener) {
+void EventDispatcher::addEventListener(EventType type, EventListener* listener) {
+
+    listeners_.push_back({type.id(), listener});
+}
 
-    if (!listeners_.count(type)) return;
+bool EventDispatcher::hasEventListener(EventType type, const EventListener* listener) const {
 
-    auto& listenerArray = listeners_.at(type);
-    if (listenerArray.empty()) return;
+    for (const auto& entry : listeners_) {
 
-    auto find = std::find(listenerArray.begin(), listenerArray.end(), listener);
-    if (find != listenerArray.end()) {
-        listenerArray.erase(find);
+        if (entry.type == type.id() && entry.listener == listener) return true;
     }
+
+    return false;
 }
 
-void EventDispatcher::dispatchEvent(const std::string& type, void* target) {
+void EventDispatcher::removeEventListener(EventType type, const EventListener* listener) {
 
-    if (listeners_.count(type)) {
+    for (size_t i = 0; i < listeners_.size(); ++i) {
 
-        Event e{type, target};
+        if (listeners_[i].type == type.id() && listeners_[i].listener == listener) {
 
-        auto listenersOfType = listeners_.at(type);//copy
-        for (auto l : listenersOfType) {
-            if (l) {
-                l->onEvent(e);
-            }
+            listeners_.erase(i);
+            return;
         }
     }
 }
+
+void EventDispatcher::dispatch(EventType type, void* target) {
+
+    // copied, as listeners may remove themselves while the event is dispatched
+    utils::SmallVector<EventListener*, 4> listenersOfType;
+    for (const auto& entry : listeners_) {
+
+        if (entry.type == type.id() && entry.listener) listenersOfType.push_back(entry.listener);
+    }
+
+    if (listenersOfType.empty()) return;
+
+    Event e{type.name(), target};
+    for (auto l : listenersOfType) {
+
+        l->onEvent(e);
+    }
+}
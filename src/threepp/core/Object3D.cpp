@@ -10,19 +10,41 @@
 
 #include "threepp/lights/Light.hpp"
 
+#include <algorithm>
+#include <unordered_map>
+
 using namespace threepp;
 
 Object3D::Object3D()
-    : uuid(math::generateUUID()),
-      matrix(std::make_shared<Matrix4>()),
-      matrixWorld(std::make_shared<Matrix4>()) {
+    : matrix(utils::makePooled<Matrix4>()),
+      matrixWorld(utils::makePooled<Matrix4>()) {
+
+    // writes to one representation only mark the other stale, it is converted when read
+    rotation.link(quaternion);
+}
+
+Object3D::MatrixUpdateFlag& Object3D::MatrixUpdateFlag::operator=(bool value) {
+
+    value_ = value;
+    if (value) owner_->markSubtreeNeedsUpdate();
+
+    return *this;
+}
+
+void Object3D::markSubtreeNeedsUpdate() {
+
+    // ancestors of a flagged object are flagged already
+    for (auto object = this; object && !object->subtreeNeedsUpdate_; object = object->parent) {
 
-    rotation._onChange([this] {
-        quaternion.setFromEuler(rotation, false);
-    });
-    quaternion._onChange([this] {
-        rotation.setFromQuaternion(quaternion, std::nullopt, false);
-    });
+        object->subtreeNeedsUpdate_ = true;
+    }
+}
+
+void Object3D::shareMatrix(std::shared_ptr<Matrix4> source) {
+
+    this->matrix = std::move(source);
+    this->matrixShared_ = true;
+    this->matrixWorldNeedsUpdate = true;
 }
 
 std::string Object3D::type() const {
@@ -30,6 +52,13 @@ std::string Object3D::type() const {
     return "Object3D";
 }
 
+const std::string& Object3D::Uuid::operator()() const {
+
+    std::call_once(once_, [this] { value_ = math::generateUUID(); });
+
+    return value_;
+}
+
 void Object3D::applyMatrix4(const Matrix4& m) {
 
     if (this->matrixAutoUpdate) this->updateMatrix();
@@ -207,11 +236,9 @@ void Object3D::add(const std::shared_ptr<Object3D>& object) {
         object->parent->remove(*object);
     }
 
-    object->parent = this;
-    this->children_.emplace_back(object);
-    this->children.emplace_back(object.get());
+    addChild(object.get(), object);
 
-    object->dispatchEvent("added");
+    dispatchAdded(object.get());
 }
 
 void Object3D::add(Object3D& object) {
@@ -221,35 +248,79 @@ void Object3D::add(Object3D& object) {
         object.parent->remove(object);
     }
 
-    object.parent = this;
-    this->children.emplace_back(&object);
+    addChild(&object, nullptr);
 
-    object.dispatchEvent("added");
+    dispatchAdded(&object);
+}
+
+void Object3D::addAll(const std::vector<std::shared_ptr<Object3D>>& objects) {
+
+    addAllImpl(objects);
+}
+
+void Object3D::addAll(const std::vector<Object3D*>& objects) {
+
+    addAllImpl(objects);
 }
 
 void Object3D::remove(Object3D& object) {
 
-    {// non-owning (all children should be represented here)
-        auto find = std::find_if(children.begin(), children.end(), [&object](const auto& obj) {
-            return obj == &object;
-        });
-        if (find != children.end()) {
-            Object3D* child = *find;
-            children.erase(find);
+    const auto index = indexOfChild(object);
+    if (index == children.size()) return;
 
-            child->parent = nullptr;
-            child->dispatchEvent("remove", child);
-        }
+    // keeps the object alive while the event is dispatched
+    const auto owned = takeChild(index);
+
+    object.parent = nullptr;
+    object.matrixWorldNeedsUpdate = true;
+    object.dispatchEvent(events::remove, &object);
+}
+
+void Object3D::removeAll(const std::vector<Object3D*>& objects) {
+
+    std::vector<Object3D*> removed;
+    // keeps the removed objects alive while the events are dispatched
+    std::vector<std::shared_ptr<Object3D>> owned;
+
+    children_.resize(children.size());
+
+    for (auto object : objects) {
+
+        if (!object) continue;
+
+        const auto index = indexOfChild(*object);
+        if (index == children.size()) continue;
+
+        children[index] = nullptr;
+        owned.emplace_back(std::move(children_[index]));
+        removed.emplace_back(object);
+
+        object->parent = nullptr;
+        object->matrixWorldNeedsUpdate = true;
     }
-    {// owning
-        auto find = std::find_if(children_.begin(), children_.end(), [&object](const auto& obj) {
-            return obj.get() == &object;
-        });
-        if (find != children_.end()) {
 
-            children_.erase(find);
-        }
+    if (removed.empty()) return;
+
+    // compact the remaining children in one pass, keeping their order
+    size_t size = 0;
+    for (size_t i = 0; i < children.size(); ++i) {
+
+        if (!children[i]) continue;
+
+        children[size] = children[i];
+        children_[size] = std::move(children_[i]);
+        children[size]->childIndex_ = size;
+        ++size;
+    }
+    children.resize(size);
+    children_.resize(size);
+
+    for (auto object : removed) {
+
+        object->dispatchEvent(events::remove, object);
     }
+
+    dispatchEvent(events::childrenRemoved, &removed);
 }
 
 void Object3D::removeFromParent() {
@@ -262,15 +333,150 @@ void Object3D::removeFromParent() {
 
 void Object3D::clear() {
 
-    for (auto& object : this->children) {
+    if (children.empty()) return;
+
+    auto removed = std::move(this->children);
+    const auto owned = std::move(this->children_);
+    this->children.clear();
+    this->children_.clear();
+
+    for (auto object : removed) {
 
         object->parent = nullptr;
+        object->matrixWorldNeedsUpdate = true;
+    }
+
+    for (auto object : removed) {
 
-        object->dispatchEvent("remove");
+        object->dispatchEvent(events::remove, object);
     }
 
-    this->children.clear();
-    this->children_.clear();
+    dispatchEvent(events::childrenRemoved, &removed);
+}
+
+void Object3D::dispatchAdded(Object3D* object) {
+
+    object->dispatchEvent(events::added);
+
+    if (hasEventListeners()) {
+
+        std::vector<Object3D*> added{object};
+        dispatchEvent(events::childrenAdded, &added);
+    }
+}
+
+void Object3D::addChild(Object3D* object, std::shared_ptr<Object3D> owned) {
+
+    object->parent = this;
+    object->childIndex_ = children.size();
+    object->matrixWorldNeedsUpdate = true;
+    // the object may still be flagged from its previous parent
+    markSubtreeNeedsUpdate();
+
+    children_.resize(children.size());
+    children_.emplace_back(std::move(owned));
+    children.emplace_back(object);
+}
+
+namespace {
+
+    Object3D* rawPointer(Object3D* object) {
+
+        return object;
+    }
+
+    Object3D* rawPointer(const std::shared_ptr<Object3D>& object) {
+
+        return object.get();
+    }
+
+    std::shared_ptr<Object3D> owningPointer(Object3D*) {
+
+        return nullptr;
+    }
+
+    std::shared_ptr<Object3D> owningPointer(const std::shared_ptr<Object3D>& object) {
+
+        return object;
+    }
+
+}// namespace
+
+template<class Ptr>
+void Object3D::addAllImpl(const std::vector<Ptr>& objects) {
+
+    // detach from the current parents, one batch per parent
+    std::unordered_map<Object3D*, std::vector<Object3D*>> previousParents;
+    for (const auto& object : objects) {
+
+        auto o = rawPointer(object);
+        if (o && o->parent) previousParents[o->parent].emplace_back(o);
+    }
+    for (auto& [previousParent, previousChildren] : previousParents) {
+
+        previousParent->removeAll(previousChildren);
+    }
+
+    std::vector<Object3D*> added;
+    added.reserve(objects.size());
+    children.reserve(children.size() + objects.size());
+
+    for (const auto& object : objects) {
+
+        auto o = rawPointer(object);
+        // skips duplicates
+        if (!o || o->parent == this) continue;
+
+        addChild(o, owningPointer(object));
+        added.emplace_back(o);
+    }
+
+    for (auto object : added) {
+
+        object->dispatchEvent(events::added);
+    }
+
+    if (!added.empty()) dispatchEvent(events::childrenAdded, &added);
+}
+
+size_t Object3D::indexOfChild(const Object3D& object) const {
+
+    if (object.parent != this) return children.size();
+
+    const auto index = object.childIndex_;
+    if (index < children.size() && children[index] == &object) return index;
+
+    // children was modified directly
+    return std::find(children.begin(), children.end(), &object) - children.begin();
+}
+
+std::shared_ptr<Object3D> Object3D::takeChild(size_t index) {
+
+    children_.resize(children.size());
+    auto owned = std::move(children_[index]);
+
+    if (keepChildOrder) {
+
+        const auto it = static_cast<std::ptrdiff_t>(index);
+        children.erase(children.begin() + it);
+        children_.erase(children_.begin() + it);
+
+        for (auto i = index; i < children.size(); ++i) {
+
+            children[i]->childIndex_ = i;
+        }
+
+    } else {
+
+        children[index] = children.back();
+        children_[index] = std::move(children_.back());
+        children[index]->childIndex_ = index;
+
+        children.pop_back();
+        children_.pop_back();
+    }
+
+    return owned;
 }
 
 Object3D* Object3D::getObjectByName(const std::string& name) {
@@ -328,48 +534,124 @@ void Object3D::getWorldDirection(Vector3& target) {
 
 void Object3D::traverse(const std::function<void(Object3D&)>& callback) {
 
-    callback(*this);
+    traverse<const std::function<void(Object3D&)>&>(callback);
+}
+
+void Object3D::traverseVisible(const std::function<void(Object3D&)>& callback) {
+
+    traverseVisible<const std::function<void(Object3D&)>&>(callback);
+}
+
+void Object3D::traverseAncestors(const std::function<void(Object3D&)>& callback) {
+
+    traverseAncestors<const std::function<void(Object3D&)>&>(callback);
+}
+
+struct Object3D::WorldBounds {
+
+    const BufferGeometry* geometry = nullptr;
+    Matrix4 matrixWorld;
+
+    bool sphereValid = false;
+    Sphere localSphere;
+    Sphere sphere;
+
+    bool boxValid = false;
+    Box3 localBox;
+    Box3 box;
+};
 
-    for (auto& i : children) {
+Object3D::WorldBounds& Object3D::worldBounds(const BufferGeometry& geometry) {
 
-        i->traverse(callback);
+    if (!worldBounds_) worldBounds_ = std::make_unique<WorldBounds>();
+
+    auto& bounds = *worldBounds_;
+    if (bounds.geometry != &geometry || bounds.matrixWorld != *matrixWorld) {
+
+        bounds.geometry = &geometry;
+        bounds.matrixWorld.copy(*matrixWorld);
+        bounds.sphereValid = false;
+        bounds.boxValid = false;
     }
+
+    return bounds;
 }
 
-void Object3D::traverseVisible(const std::function<void(Object3D&)>& callback) {
+const Sphere* Object3D::worldBoundingSphere() {
 
-    if (!this->visible) return;
+    auto geometry = this->geometry();
+    if (!geometry) return nullptr;
 
-    callback(*this);
+    if (!geometry->boundingSphere) geometry->computeBoundingSphere();
 
-    for (auto& i : children) {
+    auto& bounds = worldBounds(*geometry);
+    if (!bounds.sphereValid || !bounds.localSphere.equals(*geometry->boundingSphere)) {
 
-        i->traverseVisible(callback);
+        bounds.localSphere.copy(*geometry->boundingSphere);
+        bounds.sphere.copy(bounds.localSphere).applyMatrix4(*matrixWorld);
+        bounds.sphereValid = true;
     }
+
+    return &bounds.sphere;
 }
 
-void Object3D::traverseAncestors(const std::function<void(Object3D&)>& callback) {
+const Box3* Object3D::worldBoundingBox() {
 
-    if (parent) {
+    auto geometry = this->geometry();
+    if (!geometry) return nullptr;
+
+    if (!geometry->boundingBox) geometry->computeBoundingBox();
 
-        callback(*parent);
+    auto& bounds = worldBounds(*geometry);
+    if (!bounds.boxValid || !bounds.localBox.equals(*geometry->boundingBox)) {
 
-        parent->traverseAncestors(callback);
+        bounds.localBox.copy(*geometry->boundingBox);
+        bounds.box.copy(bounds.localBox).applyMatrix4(*matrixWorld);
+        bounds.boxValid = true;
     }
+
+    return &bounds.box;
+}
+
+bool Object3D::transformChanged() const {
+
+    if (!composed_) return true;
+
+    const auto& t = composedTransform_;
+    return t[0] != position.x || t[1] != position.y || t[2] != position.z ||
+           t[3] != quaternion.x() || t[4] != quaternion.y() || t[5] != quaternion.z() || t[6] != quaternion.w() ||
+           t[7] != scale.x || t[8] != scale.y || t[9] != scale.z;
 }
 
 void Object3D::updateMatrix() {
 
-    this->matrix->compose(this->position, this->quaternion, this->scale);
+    composeMatrix();
 
     this->matrixWorldNeedsUpdate = true;
 }
 
+void Object3D::composeMatrix() {
+
+    this->matrix->compose(this->position, this->quaternion, this->scale);
+
+    composedTransform_ = {position.x, position.y, position.z,
+                          quaternion.x(), quaternion.y(), quaternion.z(), quaternion.w(),
+                          scale.x, scale.y, scale.z};
+    composed_ = true;
+}
+
 void Object3D::updateMatrixWorld(bool force) {
 
-    if (this->matrixAutoUpdate) this->updateMatrix();
+    // nothing in the subtree changed since the last update, and nothing in it changes without raising the flag
+    if (!force && !subtreeNeedsUpdate_ && subtreeStatic_) return;
 
-    if (this->matrixWorldNeedsUpdate || force) {
+    subtreeNeedsUpdate_ = false;
+
+    const bool composed = this->matrixAutoUpdate && transformChanged();
+    if (composed) composeMatrix();
+
+    // a matrix shared with another object (e.g. a light helper) may change without notice
+    if (composed || this->matrixWorldNeedsUpdate || force || matrixShared_) {
 
         if (!this->parent) {
 
@@ -381,16 +663,22 @@ void Object3D::updateMatrixWorld(bool force) {
         }
 
         this->matrixWorldNeedsUpdate = false;
+        _matrixWorldUpdates.fetch_add(1, std::memory_order_relaxed);
 
         force = true;
     }
 
     // update children
 
+    bool isStatic = !this->matrixAutoUpdate && !matrixShared_;
+
     for (auto& child : this->children) {
 
         child->updateMatrixWorld(force);
+        isStatic = isStatic && child->subtreeStatic_;
     }
+
+    subtreeStatic_ = isStatic;
 }
 
 void Object3D::updateWorldMatrix(std::optional<bool> updateParents, std::optional<bool> updateChildren) {
@@ -411,6 +699,9 @@ void Object3D::updateWorldMatrix(std::optional<bool> updateParents, std::optiona
         this->matrixWorld->multiplyMatrices(*this->parent->matrixWorld, *this->matrix);
     }
 
+    // descendants not updated here are refreshed by the next updateMatrixWorld
+    this->matrixWorldNeedsUpdate = true;
+
     // update children
 
     if (updateChildren && updateChildren.value()) {
@@ -447,6 +738,7 @@ void Object3D::copy(const Object3D& source, bool recursive) {
 
     this->frustumCulled = source.frustumCulled;
     this->renderOrder = source.renderOrder;
+    this->keepChildOrder = source.keepChildOrder;
 
     if (recursive) {
 
@@ -460,7 +752,7 @@ void Object3D::copy(const Object3D& source, bool recursive) {
 
 std::shared_ptr<Object3D> Object3D::clone(bool recursive) {
 
-    auto clone = std::make_shared<Object3D>();
+    auto clone = utils::makePooled<Object3D>();
     clone->copy(*this, recursive);
 
     return clone;
@@ -484,6 +776,7 @@ Object3D::Object3D(Object3D&& source) noexcept: Object3D() {
 
     this->matrix = std::move(source.matrix);
     this->matrixWorld = std::move(source.matrixWorld);
+    this->matrixShared_ = source.matrixShared_;
 
     this->matrixAutoUpdate = source.matrixAutoUpdate;
     this->matrixWorldNeedsUpdate = source.matrixWorldNeedsUpdate;
@@ -500,13 +793,8 @@ Object3D::Object3D(Object3D&& source) noexcept: Object3D() {
     this->onAfterRender = std::move(onAfterRender);
     this->onBeforeRender = std::move(onBeforeRender);
 
-    this->rotation._onChange([this] {
-        quaternion.setFromEuler(rotation, false);
-    });
-    this->quaternion._onChange([this] {
-        rotation.setFromQuaternion(quaternion, std::nullopt, false);
-    });
-
+    this->childIndex_ = source.childIndex_;
+    this->keepChildOrder = source.keepChildOrder;
     this->children = std::move(source.children);
     this->children_ = std::move(source.children_);
 
@@ -515,4 +803,7 @@ Object3D::Object3D(Object3D&& source) noexcept: Object3D() {
     }
 }
 
-Object3D::~Object3D() = default;
+Object3D::~Object3D() {
+
+    dispatchEvent(events::destroyed, this);
+}
@@ -0,0 +1,299 @@
+
+#include "threepp/core/PointOctree.hpp"
+
+#include "threepp/core/BufferAttribute.hpp"
+#include "threepp/math/Ray.hpp"
+#include "threepp/math/octants.hpp"
+#include "threepp/utils/SmallVector.hpp"
+#include "threepp/utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+
+using namespace threepp;
+
+namespace {
+
+    using octants::invalid;
+    using octants::Node;
+
+    constexpr uint32_t maxLeafSize = 32;
+    constexpr int maxDepth = 21;
+
+    struct PointTraits {
+        const float* data;
+        size_t stride;
+
+        [[nodiscard]] Vector3 centroid(uint32_t index) const {
+
+            const auto p = data + index * stride;
+            return {p[0], p[1], p[2]};
+        }
+
+        void expand(Box3& box, uint32_t index) const {
+
+            box.expandByPoint(centroid(index));
+        }
+    };
+
+    // points [first, second) touched by a range of array elements
+    std::pair<size_t, size_t> pointRange(const UpdateRange& range, size_t itemSize) {
+
+        const auto start = static_cast<size_t>(range.offset) / itemSize;
+        const auto end = (static_cast<size_t>(range.offset + range.count) + itemSize - 1) / itemSize;
+
+        return {start, end};
+    }
+
+}// namespace
+
+struct PointOctree::Impl {
+
+    const float* data = nullptr;
+    size_t stride = 3;
+
+    std::vector<uint32_t> points;// point of each slot
+    std::vector<uint32_t> leaves;// leaf of each point
+    std::vector<Node> nodes;
+
+    unsigned int version = 0;
+
+    Box3 emptyBox;
+
+    void bind(const TypedBufferAttribute<float>& positions) {
+
+        data = positions.itemData();
+        stride = positions.itemStride();
+    }
+
+    [[nodiscard]] const float* point(uint32_t index) const {
+
+        return data + index * stride;
+    }
+
+    void build(const TypedBufferAttribute<float>& positions, unsigned int threads) {
+
+        bind(positions);
+
+        const auto count = static_cast<uint32_t>(positions.count());
+
+        points.resize(count);
+        std::iota(points.begin(), points.end(), 0);
+        leaves.assign(count, invalid);
+        nodes.clear();
+
+        version = positions.version;
+
+        if (count == 0) return;
+
+        std::unique_ptr<utils::ThreadPool> pool;
+        threads = std::max(threads, 1u);
+        if (threads > 1 && count > parallelThreshold) pool = std::make_unique<utils::ThreadPool>(threads);
+
+        // subtrees up to this size are built as independent jobs
+        const auto taskSize = std::max<uint32_t>(parallelThreshold / 8, count / (threads * 4));
+
+        nodes = octants::Builder<uint32_t, PointTraits>(points, {data, stride}, maxLeafSize, maxDepth, pool.get(), taskSize).build();
+
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+
+            const auto& node = nodes[i];
+            if (!node.isLeaf()) continue;
+
+            for (auto j = node.begin; j < node.end; ++j) leaves[points[j]] = i;
+        }
+    }
+
+    void computeBox(Node& node) const {
+
+        node.box.makeEmpty();
+
+        Vector3 v;
+        for (auto i = node.begin; i < node.end; ++i) {
+
+            const auto p = point(points[i]);
+            node.box.expandByPoint(v.set(p[0], p[1], p[2]));
+        }
+    }
+
+    // ranges of points [first, second), clamped to the point count
+    void refit(const std::vector<std::pair<size_t, size_t>>& ranges) {
+
+        std::vector<uint32_t> dirty;
+        for (const auto& [start, end] : ranges) {
+
+            for (auto i = start; i < end; ++i) dirty.emplace_back(leaves[i]);
+        }
+
+        std::sort(dirty.begin(), dirty.end());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+        // children have larger indices than their parents, so they are refit first
+        std::priority_queue<uint32_t> queue(dirty.begin(), dirty.end());
+
+        auto last = invalid;
+        while (!queue.empty()) {
+
+            const auto index = queue.top();
+            queue.pop();
+
+            if (index == last) continue;
+            last = index;
+
+            auto& node = nodes[index];
+            const auto box = node.box;
+
+            if (node.isLeaf()) {
+
+                computeBox(node);
+
+            } else {
+
+                node.box.makeEmpty();
+                for (auto i = node.firstChild; i < node.firstChild + node.childCount; ++i) node.box.union_(nodes[i].box);
+            }
+
+            if (node.parent != invalid && !box.equals(node.box)) queue.push(node.parent);
+        }
+    }
+
+    void refitAll() {
+
+        for (auto i = nodes.size(); i-- > 0;) {
+
+            auto& node = nodes[i];
+
+            if (node.isLeaf()) {
+
+                computeBox(node);
+
+            } else {
+
+                node.box.makeEmpty();
+                for (auto j = node.firstChild; j < node.firstChild + node.childCount; ++j) node.box.union_(nodes[j].box);
+            }
+        }
+    }
+
+    // ranges of points [first, second)
+    void update(const TypedBufferAttribute<float>& positions, std::vector<std::pair<size_t, size_t>> ranges) {
+
+        if (static_cast<size_t>(positions.count()) != points.size()) {
+
+            build(positions, 1);
+            return;
+        }
+
+        bind(positions);
+
+        size_t count = 0;
+        for (auto& [start, end] : ranges) {
+
+            end = std::min(end, points.size());
+            start = std::min(start, end);
+            count += end - start;
+        }
+
+        if (count >= points.size()) {
+
+            refitAll();
+
+        } else {
+
+            refit(ranges);
+        }
+
+        version = positions.version;
+    }
+
+    void intersectRay(const Ray& ray, float threshold, const std::function<void(unsigned int)>& visitor) const {
+
+        if (nodes.empty()) return;
+
+        const auto& origin = ray.origin;
+        const Vector3 invDir(1.f / ray.direction.x, 1.f / ray.direction.y, 1.f / ray.direction.z);
+        const auto far = std::numeric_limits<float>::infinity();
+
+        utils::SmallVector<uint32_t, 64> stack;
+        stack.push_back(0);
+
+        Box3 box;
+        while (!stack.empty()) {
+
+            const auto& node = nodes[stack.back()];
+            stack.pop_back();
+
+            box.copy(node.box).expandByScalar(threshold);
+            if (!bvh::intersectsBox(box, origin, invDir, 0, far)) continue;
+
+            if (node.isLeaf()) {
+
+                for (auto i = node.begin; i < node.end; ++i) visitor(points[i]);
+                continue;
+            }
+
+            for (auto i = node.firstChild; i < node.firstChild + node.childCount; ++i) stack.push_back(i);
+        }
+    }
+};
+
+PointOctree::PointOctree(const TypedBufferAttribute<float>& positions, unsigned int threads)
+    : pimpl_(std::make_unique<Impl>()) {
+
+    pimpl_->build(positions, threads);
+}
+
+void PointOctree::intersectRay(const Ray& ray, float threshold, const std::function<void(unsigned int)>& visitor) const {
+
+    pimpl_->intersectRay(ray, threshold, visitor);
+}
+
+void PointOctree::update(const TypedBufferAttribute<float>& positions, size_t start, size_t count) {
+
+    pimpl_->update(positions, {{start, start + std::min(count, static_cast<size_t>(positions.count()))}});
+}
+
+void PointOctree::update(const TypedBufferAttribute<float>& positions) {
+
+    // the ranges are in array elements, and are left for GLAttributes to drain on upload
+    const auto itemSize = static_cast<size_t>(positions.itemSize());
+
+    std::vector<std::pair<size_t, size_t>> ranges;
+    if (!positions.updateRanges.empty()) {
+
+        for (const auto& range : positions.updateRanges) ranges.emplace_back(pointRange(range, itemSize));
+
+    } else if (positions.updateRange.count >= 0) {
+
+        ranges.emplace_back(pointRange(positions.updateRange, itemSize));
+
+    } else {
+
+        ranges.emplace_back(0, static_cast<size_t>(positions.count()));
+    }
+
+    pimpl_->update(positions, std::move(ranges));
+}
+
+bool PointOctree::matches(const TypedBufferAttribute<float>& positions) const {
+
+    return static_cast<size_t>(positions.count()) == pimpl_->points.size() && positions.version == pimpl_->version;
+}
+
+size_t PointOctree::size() const {
+
+    return pimpl_->points.size();
+}
+
+const Box3& PointOctree::bounds() const {
+
+    return pimpl_->nodes.empty() ? pimpl_->emptyBox : pimpl_->nodes.front().box;
+}
+
+std::shared_ptr<PointOctree> PointOctree::create(const TypedBufferAttribute<float>& positions, unsigned int threads) {
+
+    return std::make_shared<PointOctree>(positions, threads);
+}
+
+PointOctree::~PointOctree() = default;
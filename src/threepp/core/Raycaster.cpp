@@ -3,6 +3,9 @@
 
 #include "threepp/cameras/OrthographicCamera.hpp"
 #include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/core/BufferGeometry.hpp"
+#include "threepp/scenes/Scene.hpp"
+#include "threepp/utils/ThreadPool.hpp"
 
 #include <algorithm>
 #include <iostream>
@@ -16,9 +19,12 @@ namespace {
         return a.distance < b.distance;
     }
 
-    void intersectObject(Object3D& object, Raycaster& raycaster, std::vector<Intersection>& intersects, bool recursive) {
+    void intersectObject(Object3D& object, Raycaster& raycaster, std::vector<Intersection>& intersects, bool recursive, const SceneBVH* bvh) {
+
+        // static objects are tested through the bvh query
+        if (bvh && bvh->coversSubtree(object)) return;
 
-        if (object.layers.test(raycaster.layers)) {
+        if (object.layers.test(raycaster.layers) && !(bvh && bvh->contains(object))) {
 
             object.raycast(raycaster, intersects);
         }
@@ -29,7 +35,46 @@ namespace {
 
             for (const auto& child : children) {
 
-                intersectObject(*child, raycaster, intersects, true);
+                intersectObject(*child, raycaster, intersects, true, bvh);
+            }
+        }
+    }
+
+    void intersectObject(Object3D& object, Raycaster& raycaster, std::vector<Intersection>& intersects, bool recursive) {
+
+        const auto scene = object.as<Scene>();
+        const auto bvh = recursive && scene ? scene->bvh.get() : nullptr;
+
+        intersectObject(object, raycaster, intersects, recursive, bvh);
+
+        if (bvh) {
+
+            thread_local std::vector<Object3D*> candidates;
+            candidates.clear();
+            bvh->intersectRay(raycaster.ray, candidates, raycaster.near, raycaster.far);
+
+            for (auto candidate : candidates) {
+
+                if (candidate->layers.test(raycaster.layers)) {
+
+                    candidate->raycast(raycaster, intersects);
+                }
+            }
+        }
+    }
+
+    // computes the lazily created bounds that raycasting reads, so that batches only read the scene
+    void prepare(Object3D& object, bool recursive) {
+
+        const auto geometry = object.geometry();
+        if (geometry && !geometry->boundingSphere) geometry->computeBoundingSphere();
+        if (geometry && !geometry->boundingBox) geometry->computeBoundingBox();
+
+        if (recursive) {
+
+            for (auto child : object.children) {
+
+                prepare(*child, true);
             }
         }
     }
@@ -48,9 +93,7 @@ std::vector<Intersection> Raycaster::intersectObject(Object3D& object, bool recu
 
     std::vector<Intersection> intersects;
 
-    ::intersectObject(object, *this, intersects, recursive);
-
-    std::stable_sort(intersects.begin(), intersects.end(), &ascSort);
+    intersectObject(object, recursive, intersects);
 
     return intersects;
 }
@@ -59,14 +102,106 @@ std::vector<Intersection> Raycaster::intersectObjects(const std::vector<Object3D
 
     std::vector<Intersection> intersects;
 
+    intersectObjects(objects, recursive, intersects);
+
+    return intersects;
+}
+
+void Raycaster::intersectObject(Object3D& object, bool recursive, std::vector<Intersection>& intersects) {
+
+    ::intersectObject(object, *this, intersects, recursive);
+
+    std::stable_sort(intersects.begin(), intersects.end(), &ascSort);
+}
+
+void Raycaster::intersectObjects(const std::vector<Object3D*>& objects, bool recursive, std::vector<Intersection>& intersects) {
+
     for (auto& object : objects) {
 
         ::intersectObject(*object, *this, intersects, recursive);
     }
 
     std::stable_sort(intersects.begin(), intersects.end(), &ascSort);
+}
 
-    return intersects;
+void Raycaster::intersectBatch(const std::vector<Ray>& rays, const std::vector<Object3D*>& objects, RaycastResults& results, bool recursive) {
+
+    for (auto object : objects) {
+
+        prepare(*object, recursive);
+    }
+
+    const auto jobs = threads > 1 ? std::min<size_t>(threads * 4, rays.size()) : std::min<size_t>(1, rays.size());
+    const auto batch = jobs > 0 ? (rays.size() + jobs - 1) / jobs : 0;
+
+    results.jobs_.resize(jobs);
+    results.jobCounts_.resize(jobs);
+
+    const auto job = [&](size_t index) {
+        auto& intersects = results.jobs_[index];
+        auto& counts = results.jobCounts_[index];
+        intersects.clear();
+        counts.clear();
+
+        // each job casts with its own copy, as the ray is replaced per ray
+        Raycaster raycaster(*this);
+
+        const auto end = std::min(rays.size(), (index + 1) * batch);
+        for (auto i = index * batch; i < end; ++i) {
+
+            raycaster.ray.copy(rays[i]);
+
+            const auto first = intersects.size();
+            for (auto object : objects) {
+
+                ::intersectObject(*object, raycaster, intersects, recursive);
+            }
+
+            std::stable_sort(intersects.begin() + static_cast<std::ptrdiff_t>(first), intersects.end(), &ascSort);
+            counts.emplace_back(intersects.size() - first);
+        }
+    };
+
+    if (jobs > 1) {
+
+        if (!pool_ || poolThreads_ != threads) {
+
+            pool_ = std::make_shared<utils::ThreadPool>(threads);
+            poolThreads_ = threads;
+        }
+
+        for (size_t i = 0; i < jobs; ++i) {
+
+            pool_->submit([&job, i] { job(i); });
+        }
+        pool_->wait();
+
+    } else if (jobs == 1) {
+
+        job(0);
+    }
+
+    // merge the job buffers into the flat buffer
+
+    size_t total = 0;
+    for (const auto& intersects : results.jobs_) total += intersects.size();
+
+    results.intersections.clear();
+    results.intersections.reserve(total);
+    results.offsets.clear();
+    results.offsets.reserve(rays.size() + 1);
+    results.offsets.emplace_back(0);
+
+    for (size_t i = 0; i < jobs; ++i) {
+
+        const auto& intersects = results.jobs_[i];
+        results.intersections.insert(results.intersections.end(), intersects.begin(), intersects.end());
+
+        for (auto count : results.jobCounts_[i]) {
+
+            results.offsets.emplace_back(results.offsets.back() + count);
+        }
+    }
 }
 
 void Raycaster::setFromCamera(const Vector2& coords, Camera& camera) {
@@ -0,0 +1,321 @@
+
+#include "threepp/core/TransformSystem.hpp"
+
+#include "threepp/cameras/Camera.hpp"
+#include "threepp/core/Object3D.hpp"
+#include "threepp/helpers/Box3Helper.hpp"
+#include "threepp/helpers/PlaneHelper.hpp"
+#include "threepp/helpers/SkeletonHelper.hpp"
+#include "threepp/math/batch.hpp"
+#include "threepp/objects/SkinnedMesh.hpp"
+#include "threepp/utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace threepp;
+
+namespace {
+
+    // below this many objects per job, threading costs more than it saves
+    constexpr size_t minBatchSize = 512;
+
+    bool hasCustomMatrixUpdate(Object3D* object) {
+
+        return dynamic_cast<Camera*>(object) ||
+               dynamic_cast<SkinnedMesh*>(object) ||
+               dynamic_cast<Box3Helper*>(object) ||
+               dynamic_cast<PlaneHelper*>(object) ||
+               dynamic_cast<SkeletonHelper*>(object);
+    }
+
+}// namespace
+
+struct TransformSystem::Impl {
+
+    struct Storage {
+
+        std::vector<Matrix4> local;
+        std::vector<Matrix4> world;
+    };
+
+    // local TRS, gathered from the objects each update
+    struct TRS {
+
+        std::vector<float> positions;
+        std::vector<float> quaternions;
+        std::vector<float> scales;
+        std::vector<unsigned char> autoUpdate;
+
+        void resize(size_t size) {
+
+            positions.resize(size * 3);
+            quaternions.resize(size * 4);
+            scales.resize(size * 3);
+            autoUpdate.resize(size);
+        }
+    };
+
+    Object3D& root;
+    Object3D* rootParent = nullptr;
+
+    unsigned int threads;
+    std::unique_ptr<utils::ThreadPool> pool;
+
+    std::shared_ptr<Storage> storage;
+    TRS trs;
+
+    // breadth first order, levels[d] is the index of the first object at depth d
+    std::vector<Object3D*> objects;
+    std::vector<int> parents;
+    std::vector<size_t> levels;
+
+    // updated through their own updateMatrixWorld after the linear pass
+    std::vector<Object3D*> detached;
+
+    // children of each object at the last rebuild, used to detect hierarchy changes
+    std::vector<Object3D*> childSnapshot;
+    std::vector<size_t> childOffsets;
+
+    Impl(Object3D& root, unsigned int threads)
+        : root(root), threads(std::max(threads, 1u)) {
+
+        if (this->threads > 1) {
+
+            pool = std::make_unique<utils::ThreadPool>(this->threads);
+        }
+
+        rebuild();
+    }
+
+    void rebuild() {
+
+        // matrices aliased by helpers (see Object3D::shareMatrix) can not be moved into the storage
+
+        std::unordered_map<Matrix4*, int> references;
+        root.traverse([&](Object3D& o) {
+            ++references[o.matrix.get()];
+            ++references[o.matrixWorld.get()];
+        });
+
+        const auto isShared = [&](const std::shared_ptr<Matrix4>& m) {
+            return references[m.get()] > 1;
+        };
+
+        objects.clear();
+        parents.clear();
+        levels.clear();
+        detached.clear();
+        childSnapshot.clear();
+        childOffsets.clear();
+
+        rootParent = root.parent;
+
+        std::vector<std::pair<Object3D*, int>> current{{&root, -1}};
+        std::vector<std::pair<Object3D*, int>> next;
+
+        while (!current.empty()) {
+
+            levels.emplace_back(objects.size());
+
+            for (auto [object, parent] : current) {
+
+                if (hasCustomMatrixUpdate(object) || object->matrixShared() ||
+                    isShared(object->matrix) || isShared(object->matrixWorld)) {
+
+                    detached.emplace_back(object);
+                    continue;
+                }
+
+                const auto index = static_cast<int>(objects.size());
+                objects.emplace_back(object);
+                parents.emplace_back(parent);
+
+                childOffsets.emplace_back(childSnapshot.size());
+                for (auto child : object->children) {
+
+                    childSnapshot.emplace_back(child);
+                    next.emplace_back(child, index);
+                }
+            }
+
+            current.swap(next);
+            next.clear();
+        }
+
+        childOffsets.emplace_back(childSnapshot.size());
+
+        // rebind the matrices of the objects to views into contiguous storage
+
+        const auto size = objects.size();
+
+        auto newStorage = std::make_shared<Storage>();
+        newStorage->local.resize(size);
+        newStorage->world.resize(size);
+
+        for (size_t i = 0; i < size; ++i) {
+
+            auto object = objects[i];
+
+            newStorage->local[i].copy(*object->matrix);
+            newStorage->world[i].copy(*object->matrixWorld);
+
+            object->matrix = std::shared_ptr<Matrix4>(newStorage, &newStorage->local[i]);
+            object->matrixWorld = std::shared_ptr<Matrix4>(newStorage, &newStorage->world[i]);
+        }
+
+        storage = std::move(newStorage);
+        trs.resize(size);
+    }
+
+    [[nodiscard]] bool structureChanged() const {
+
+        if (root.parent != rootParent) return true;
+
+        for (size_t i = 0; i < objects.size(); ++i) {
+
+            auto object = objects[i];
+            const auto begin = childSnapshot.begin() + static_cast<std::ptrdiff_t>(childOffsets[i]);
+            const auto end = childSnapshot.begin() + static_cast<std::ptrdiff_t>(childOffsets[i + 1]);
+
+            if (object->children.size() != static_cast<size_t>(end - begin)) return true;
+            if (!std::equal(begin, end, object->children.begin())) return true;
+        }
+
+        return false;
+    }
+
+    template<class Func>
+    void parallelFor(size_t begin, size_t end, Func&& f) {
+
+        const auto count = end - begin;
+
+        if (!pool || count < minBatchSize * 2) {
+
+            f(begin, end);
+            return;
+        }
+
+        const auto jobs = std::min<size_t>(threads, count / minBatchSize);
+        const auto batch = (count + jobs - 1) / jobs;
+
+        for (auto start = begin; start < end; start += batch) {
+
+            const auto stop = std::min(start + batch, end);
+            pool->submit([&f, start, stop] { f(start, stop); });
+        }
+
+        pool->wait();
+    }
+
+    void gather() {
+
+        for (size_t i = 0; i < objects.size(); ++i) {
+
+            auto object = objects[i];
+
+            object->matrixWorldNeedsUpdate = false;
+
+            trs.autoUpdate[i] = object->matrixAutoUpdate;
+            if (!object->matrixAutoUpdate) continue;
+
+            const auto& p = object->position;
+            const auto& q = object->quaternion;
+            const auto& s = object->scale;
+
+            auto* position = &trs.positions[i * 3];
+            position[0] = p.x, position[1] = p.y, position[2] = p.z;
+            q.toArray(trs.quaternions, i * 4);
+            auto* scale = &trs.scales[i * 3];
+            scale[0] = s.x, scale[1] = s.y, scale[2] = s.z;
+        }
+    }
+
+    // composes each run of objects with matrixAutoUpdate in one batch
+    void compose(size_t begin, size_t end) {
+
+        auto* local = storage->local.data();
+
+        for (size_t i = begin; i < end;) {
+
+            if (!trs.autoUpdate[i]) {
+
+                ++i;
+                continue;
+            }
+
+            auto j = i + 1;
+            while (j < end && trs.autoUpdate[j]) ++j;
+
+            math::composeMatrices(&trs.positions[i * 3], &trs.quaternions[i * 4], &trs.scales[i * 3], local + i, j - i);
+
+            i = j;
+        }
+    }
+
+    void multiply(size_t begin, size_t end) {
+
+        const auto* local = storage->local.data();
+        auto* world = storage->world.data();
+
+        for (size_t i = begin; i < end; ++i) {
+
+            const auto parent = parents[i];
+
+            if (parent >= 0) {
+
+                world[i].multiplyMatrices(world[parent], local[i]);
+
+            } else if (rootParent) {
+
+                world[i].multiplyMatrices(*rootParent->matrixWorld, local[i]);
+
+            } else {
+
+                world[i].copy(local[i]);
+            }
+        }
+    }
+
+    void update() {
+
+        if (structureChanged()) rebuild();
+
+        gather();
+
+        parallelFor(0, objects.size(), [this](size_t begin, size_t end) { compose(begin, end); });
+
+        for (size_t level = 0; level < levels.size(); ++level) {
+
+            const auto begin = levels[level];
+            const auto end = level + 1 < levels.size() ? levels[level + 1] : objects.size();
+
+            parallelFor(begin, end, [this](size_t begin, size_t end) { multiply(begin, end); });
+        }
+
+        for (auto object : detached) {
+
+            object->updateMatrixWorld(true);
+        }
+    }
+};
+
+TransformSystem::TransformSystem(Object3D& root, unsigned int threads)
+    : pimpl_(std::make_unique<Impl>(root, threads)) {}
+
+void TransformSystem::rebuild() {
+
+    pimpl_->rebuild();
+}
+
+void TransformSystem::update() {
+
+    pimpl_->update();
+}
+
+size_t TransformSystem::size() const {
+
+    return pimpl_->objects.size();
+}
+
+TransformSystem::~TransformSystem() = default;
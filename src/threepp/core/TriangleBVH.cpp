@@ -0,0 +1,320 @@
+
+#include "threepp/core/TriangleBVH.hpp"
+
+#include "threepp/core/BufferGeometry.hpp"
+#include "threepp/math/Ray.hpp"
+#include "threepp/math/bvh.hpp"
+#include "threepp/utils/SmallVector.hpp"
+#include "threepp/utils/ThreadPool.hpp"
+
+#include <cstring>
+#include <istream>
+#include <optional>
+#include <ostream>
+
+using namespace threepp;
+
+namespace {
+
+    using bvh::invalid;
+    using bvh::Node;
+
+    // triangle tests cost more than node visits, so leaves are kept small
+    constexpr uint32_t maxLeafSize = 4;
+
+    constexpr char magic[4] = {'T', 'B', 'V', 'H'};
+    constexpr uint32_t formatVersion = 1;
+
+    struct Item {
+        uint32_t triangle;
+        Box3 box;
+        Vector3 centroid;
+    };
+
+    size_t countTriangles(const BufferGeometry& geometry) {
+
+        if (const auto index = geometry.getIndex()) return index->count() / 3;
+        if (const auto position = geometry.getAttribute<float>("position")) return position->count() / 3;
+
+        return 0;
+    }
+
+    template<class T>
+    void write(std::ostream& out, const T& value) {
+
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<class T>
+    bool read(std::istream& in, T& value) {
+
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    // bytes left to read, or nothing if the stream cannot seek
+    std::optional<uint64_t> remaining(std::istream& in) {
+
+        const auto position = in.tellg();
+        if (position < 0) return std::nullopt;
+
+        in.seekg(0, std::ios::end);
+        const auto end = in.tellg();
+        in.seekg(position);
+
+        if (end < position || !in) return std::nullopt;
+
+        return static_cast<uint64_t>(end - position);
+    }
+
+}// namespace
+
+struct TriangleBVH::Impl {
+
+    std::vector<Node> nodes;
+    // triangle of each leaf slot, nodes cover triangles[begin, end)
+    std::vector<uint32_t> triangles;
+
+    Box3 emptyBox;
+
+    void build(const BufferGeometry& geometry, unsigned int threads) {
+
+        const auto index = geometry.getIndex();
+        const auto position = geometry.getAttribute<float>("position");
+        const auto count = countTriangles(geometry);
+
+        if (count == 0) return;
+
+        std::vector<Item> items(count);
+
+        const auto gather = [&](size_t begin, size_t end) {
+            Vector3 v;
+            for (auto t = begin; t < end; ++t) {
+
+                auto& item = items[t];
+                item.triangle = static_cast<uint32_t>(t);
+
+                for (unsigned i = 0; i < 3; ++i) {
+
+                    const auto vertex = index ? index->getX(t * 3 + i) : t * 3 + i;
+                    position->setFromBufferAttribute(v, vertex);
+                    item.box.expandByPoint(v);
+                }
+
+                item.box.getCenter(item.centroid);
+            }
+        };
+
+        std::unique_ptr<utils::ThreadPool> pool;
+        threads = std::max(threads, 1u);
+
+        if (threads > 1 && count > parallelThreshold) {
+
+            pool = std::make_unique<utils::ThreadPool>(threads);
+
+            const auto batch = (count + threads - 1) / threads;
+            for (size_t begin = 0; begin < count; begin += batch) {
+
+                pool->submit([&, begin] { gather(begin, std::min(begin + batch, count)); });
+            }
+            pool->wait();
+
+        } else {
+
+            gather(0, count);
+        }
+
+        // subtrees up to this size are built as independent jobs
+        const auto taskSize = std::max<uint32_t>(parallelThreshold / 4, static_cast<uint32_t>(count / (threads * 4)));
+
+        nodes = bvh::Builder<Item>(items, maxLeafSize, pool.get(), taskSize).build();
+
+        triangles.resize(count);
+        for (size_t i = 0; i < count; ++i) triangles[i] = items[i].triangle;
+    }
+
+    void intersectRay(const Ray& ray, const std::function<float(unsigned int)>& visitor, float near, float far) const {
+
+        if (nodes.empty()) return;
+
+        const auto& origin = ray.origin;
+        const Vector3 invDir(1.f / ray.direction.x, 1.f / ray.direction.y, 1.f / ray.direction.z);
+
+        struct Entry {
+            uint32_t node;
+            float distance;
+        };
+
+        float entry;
+        if (!bvh::intersectsBox(nodes.front().box, origin, invDir, near, far, entry)) return;
+
+        utils::SmallVector<Entry, 64> stack;
+        stack.push_back({0, entry});
+
+        while (!stack.empty()) {
+
+            const auto current = stack.back();
+            stack.pop_back();
+
+            // far may have shrunk since the node was pushed
+            if (current.distance > far) continue;
+
+            const auto& node = nodes[current.node];
+
+            if (node.isLeaf()) {
+
+                for (auto i = node.begin; i < node.end; ++i) {
+
+                    far = std::min(far, visitor(triangles[i]));
+                }
+                continue;
+            }
+
+            float leftEntry, rightEntry;
+            const bool hitsLeft = bvh::intersectsBox(nodes[node.left].box, origin, invDir, near, far, leftEntry);
+            const bool hitsRight = bvh::intersectsBox(nodes[node.right].box, origin, invDir, near, far, rightEntry);
+
+            // the nearer child is pushed last, so it is visited first
+            if (hitsLeft && hitsRight) {
+
+                if (leftEntry <= rightEntry) {
+
+                    stack.push_back({node.right, rightEntry});
+                    stack.push_back({node.left, leftEntry});
+
+                } else {
+
+                    stack.push_back({node.left, leftEntry});
+                    stack.push_back({node.right, rightEntry});
+                }
+
+            } else if (hitsLeft) {
+
+                stack.push_back({node.left, leftEntry});
+
+            } else if (hitsRight) {
+
+                stack.push_back({node.right, rightEntry});
+            }
+        }
+    }
+
+    void serialize(std::ostream& out) const {
+
+        out.write(magic, sizeof(magic));
+        write(out, formatVersion);
+        write(out, static_cast<uint32_t>(nodes.size()));
+        write(out, static_cast<uint32_t>(triangles.size()));
+
+        for (const auto& node : nodes) {
+
+            const auto& min = node.box.min();
+            const auto& max = node.box.max();
+            const float box[6]{min.x, min.y, min.z, max.x, max.y, max.z};
+            out.write(reinterpret_cast<const char*>(box), sizeof(box));
+
+            const uint32_t links[5]{node.begin, node.end, node.left, node.right, node.parent};
+            out.write(reinterpret_cast<const char*>(links), sizeof(links));
+        }
+
+        out.write(reinterpret_cast<const char*>(triangles.data()), static_cast<std::streamsize>(triangles.size() * sizeof(uint32_t)));
+    }
+
+    bool deserialize(std::istream& in) {
+
+        char header[4];
+        uint32_t version, nodeCount, triangleCount;
+
+        if (!in.read(header, sizeof(header)) || std::memcmp(header, magic, sizeof(magic)) != 0) return false;
+        if (!read(in, version) || version != formatVersion) return false;
+        if (!read(in, nodeCount) || !read(in, triangleCount)) return false;
+
+        // a binary tree with non-empty leaves has fewer than twice as many nodes as triangles,
+        // so a corrupt header is rejected before anything is allocated
+        if (nodeCount > 2 * static_cast<uint64_t>(triangleCount)) return false;
+
+        constexpr uint64_t nodeSize = 6 * sizeof(float) + 5 * sizeof(uint32_t);
+        const auto size = nodeCount * nodeSize + triangleCount * static_cast<uint64_t>(sizeof(uint32_t));
+        if (const auto available = remaining(in); available && *available < size) return false;
+
+        nodes.resize(nodeCount);
+        for (uint32_t i = 0; i < nodeCount; ++i) {
+
+            auto& node = nodes[i];
+
+            float box[6];
+            uint32_t links[5];
+            if (!read(in, box) || !read(in, links)) return false;
+
+            node.box.set({box[0], box[1], box[2]}, {box[3], box[4], box[5]});
+            node.begin = links[0];
+            node.end = links[1];
+            node.left = links[2];
+            node.right = links[3];
+            node.parent = links[4];
+
+            if (node.begin > node.end || node.end > triangleCount) return false;
+            // children come after their parent, which rules out cycles
+            if (!node.isLeaf() && (node.left <= i || node.right <= i || node.left >= nodeCount || node.right >= nodeCount)) return false;
+        }
+
+        triangles.resize(triangleCount);
+        if (!in.read(reinterpret_cast<char*>(triangles.data()), static_cast<std::streamsize>(triangles.size() * sizeof(uint32_t)))) return false;
+
+        for (auto triangle : triangles) {
+
+            if (triangle >= triangleCount) return false;
+        }
+
+        return true;
+    }
+};
+
+TriangleBVH::TriangleBVH()
+    : pimpl_(std::make_unique<Impl>()) {}
+
+TriangleBVH::TriangleBVH(const BufferGeometry& geometry, unsigned int threads)
+    : pimpl_(std::make_unique<Impl>()) {
+
+    pimpl_->build(geometry, threads);
+}
+
+void TriangleBVH::intersectRay(const Ray& ray, const std::function<float(unsigned int)>& visitor, float near, float far) const {
+
+    pimpl_->intersectRay(ray, visitor, near, far);
+}
+
+bool TriangleBVH::matches(const BufferGeometry& geometry) const {
+
+    return countTriangles(geometry) == pimpl_->triangles.size();
+}
+
+size_t TriangleBVH::triangleCount() const {
+
+    return pimpl_->triangles.size();
+}
+
+const Box3& TriangleBVH::bounds() const {
+
+    return pimpl_->nodes.empty() ? pimpl_->emptyBox : pimpl_->nodes.front().box;
+}
+
+void TriangleBVH::serialize(std::ostream& out) const {
+
+    pimpl_->serialize(out);
+}
+
+std::shared_ptr<TriangleBVH> TriangleBVH::deserialize(std::istream& in) {
+
+    std::shared_ptr<TriangleBVH> tree(new TriangleBVH());
+
+    if (!tree->pimpl_->deserialize(in)) return nullptr;
+
+    return tree;
+}
+
+std::shared_ptr<TriangleBVH> TriangleBVH::create(const BufferGeometry& geometry, unsigned int threads) {
+
+    return std::make_shared<TriangleBVH>(geometry, threads);
+}
+
+TriangleBVH::~TriangleBVH() = default;
@@ -99,7 +99,7 @@ struct CameraHelper::Impl {
 
         camera.updateProjectionMatrix();
 
-        scope.matrix = camera.matrixWorld;
+        scope.shareMatrix(camera.matrixWorld);
         scope.matrixAutoUpdate = false;
 
         update();
@@ -12,7 +12,7 @@ DirectionalLightHelper::DirectionalLightHelper(DirectionalLight& light, float si
 
     this->light.updateMatrixWorld();
 
-    this->matrix = this->light.matrixWorld;
+    this->shareMatrix(this->light.matrixWorld);
     this->matrixAutoUpdate = false;
 
     auto geometry = BufferGeometry::create();
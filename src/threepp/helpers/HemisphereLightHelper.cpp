@@ -28,7 +28,7 @@ struct HemisphereLightHelper::Impl {
         : scope(scope), light(light) {
 
         this->light.updateMatrixWorld();
-        this->scope.matrix = light.matrixWorld;
+        this->scope.shareMatrix(light.matrixWorld);
         this->scope.matrixAutoUpdate = false;
 
         auto geometry = OctahedronGeometry::create(size);
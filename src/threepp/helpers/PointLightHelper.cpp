@@ -20,7 +20,7 @@ PointLightHelper::PointLightHelper(PointLight& light, float sphereSize, std::opt
 
     this->light.updateMatrixWorld();
 
-    this->matrix = this->light.matrixWorld;
+    this->shareMatrix(this->light.matrixWorld);
     this->matrixAutoUpdate = false;
 
     update();
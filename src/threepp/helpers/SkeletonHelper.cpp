@@ -62,7 +62,7 @@ SkeletonHelper::SkeletonHelper(Object3D& object)
     m->toneMapped = false;
     m->transparent = true;
 
-    this->matrix = object.matrixWorld;
+    this->shareMatrix(object.matrixWorld);
     this->matrixAutoUpdate = false;
 }
 
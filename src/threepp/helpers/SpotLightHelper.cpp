@@ -15,7 +15,7 @@ SpotLightHelper::SpotLightHelper(SpotLight& light, std::optional<Color> color)
 
     this->light.updateMatrixWorld();
 
-    this->matrix = this->light.matrixWorld;
+    this->shareMatrix(this->light.matrixWorld);
     this->matrixAutoUpdate = false;
 
     auto geometry = BufferGeometry::create();
@@ -18,12 +18,12 @@ namespace {
         unsigned char* pixels;
 
         ImageStruct(const std::vector<unsigned char>& data, int channels, bool flipY): channels(channels) {
-            stbi_set_flip_vertically_on_load(flipY);
+            stbi_set_flip_vertically_on_load_thread(flipY);
             pixels = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, nullptr, channels);
         }
 
         ImageStruct(const std::filesystem::path& imagePath, int channels, bool flipY): channels(channels) {
-            stbi_set_flip_vertically_on_load(flipY);
+            stbi_set_flip_vertically_on_load_thread(flipY);
             pixels = stbi_load(imagePath.string().c_str(), &width, &height, nullptr, channels);
         }
 
@@ -0,0 +1,44 @@
+
+#include "threepp/loaders/MipmapChain.hpp"
+
+#include <algorithm>
+
+using namespace threepp;
+
+std::vector<Image> threepp::generateMipmapChain(Image& image, unsigned int channels) {
+
+    std::vector<Image> chain;
+    chain.emplace_back(image.data(), image.width, image.height, image.flipped());
+
+    while (chain.back().width > 1 || chain.back().height > 1) {
+
+        auto& src = chain.back();
+        const auto& srcData = src.data();
+        const auto srcWidth = src.width;
+        const auto srcHeight = src.height;
+
+        const auto width = std::max(1u, srcWidth / 2);
+        const auto height = std::max(1u, srcHeight / 2);
+
+        std::vector<unsigned char> data(width * height * channels);
+        for (unsigned y = 0; y < height; ++y) {
+            const auto y0 = std::min(y * 2, srcHeight - 1);
+            const auto y1 = std::min(y * 2 + 1, srcHeight - 1);
+            for (unsigned x = 0; x < width; ++x) {
+                const auto x0 = std::min(x * 2, srcWidth - 1);
+                const auto x1 = std::min(x * 2 + 1, srcWidth - 1);
+                for (unsigned c = 0; c < channels; ++c) {
+                    const unsigned sum = srcData[(y0 * srcWidth + x0) * channels + c] +
+                                         srcData[(y0 * srcWidth + x1) * channels + c] +
+                                         srcData[(y1 * srcWidth + x0) * channels + c] +
+                                         srcData[(y1 * srcWidth + x1) * channels + c];
+                    data[(y * width + x) * channels + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+
+        chain.emplace_back(std::move(data), width, height, image.flipped());
+    }
+
+    return chain;
+}
@@ -0,0 +1,17 @@
+
+#ifndef THREEPP_MIPMAPCHAIN_HPP
+#define THREEPP_MIPMAPCHAIN_HPP
+
+#include "threepp/textures/Image.hpp"
+
+#include <vector>
+
+namespace threepp {
+
+    // Builds the full mipmap chain of an 8-bit image (level 0 included) using a 2x2 box filter.
+    // Odd sizes round down, repeating the last row or column.
+    std::vector<Image> generateMipmapChain(Image& image, unsigned int channels);
+
+}// namespace threepp
+
+#endif//THREEPP_MIPMAPCHAIN_HPP
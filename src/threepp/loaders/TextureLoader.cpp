@@ -2,9 +2,13 @@
 #include "threepp/loaders/TextureLoader.hpp"
 
 #include "threepp/loaders/ImageLoader.hpp"
+#include "threepp/loaders/MipmapChain.hpp"
+#include "threepp/utils/ThreadPool.hpp"
 
 #include <iostream>
+#include <mutex>
 #include <regex>
+#include <thread>
 #include <vector>
 
 using namespace threepp;
@@ -24,12 +28,16 @@ struct TextureLoader::Impl {
 
     bool useCache_;
     ImageLoader imageLoader_;
+    std::mutex cacheMutex_;
     std::unordered_map<std::string, std::weak_ptr<Texture>> cache_;
+    std::unique_ptr<utils::ThreadPool> pool_;
 
     explicit Impl(bool useCache): useCache_(useCache) {}
 
     std::shared_ptr<Texture> checkCache(const std::string& name) {
 
+        std::lock_guard<std::mutex> lck(cacheMutex_);
+
         std::shared_ptr<Texture> tex;
 
         if (useCache_ && cache_.count(name)) {
@@ -66,11 +74,69 @@ struct TextureLoader::Impl {
         texture->format = isJPEG ? Format::RGB : Format::RGBA;
         texture->needsUpdate();
 
-        if (useCache_) cache_[path.string()] = texture;
+        if (useCache_) {
+            std::lock_guard<std::mutex> lck(cacheMutex_);
+            cache_[path.string()] = texture;
+        }
 
         return texture;
     }
 
+    std::future<std::shared_ptr<Texture>> loadAsync(const std::filesystem::path& path, bool flipY, bool generateMipmaps) {
+
+        auto promise = std::make_shared<std::promise<std::shared_ptr<Texture>>>();
+        auto future = promise->get_future();
+
+        if (auto cachedTexture = checkCache(path.string())) {
+
+            promise->set_value(cachedTexture);
+            return future;
+        }
+
+        if (!std::filesystem::exists(path)) {
+            std::cerr << "[TextureLoader] No such file: '" << absolute(path).string() << "'!" << std::endl;
+            promise->set_value(nullptr);
+            return future;
+        }
+
+        if (!pool_) {
+            pool_ = std::make_unique<utils::ThreadPool>(std::thread::hardware_concurrency());
+        }
+
+        // the texture is created on the calling thread (ids and uuids are not thread safe),
+        // but nobody else can observe it until the future is ready.
+        auto texture = Texture::create();
+        texture->name = path.stem().string();
+
+        pool_->submit([this, path, flipY, generateMipmaps, texture, promise] {
+            bool isJPEG = checkIsJPEG(path.string());
+            const auto channels = isJPEG ? 3 : 4;
+
+            auto image = imageLoader_.load(path, channels, flipY);
+
+            texture->format = isJPEG ? Format::RGB : Format::RGBA;
+            if (isJPEG) texture->unpackAlignment = 1;// odd sized mip levels are not 4-byte aligned
+
+            if (image) {
+                if (generateMipmaps) {
+                    texture->mipmaps = generateMipmapChain(*image, channels);
+                    texture->generateMipmaps = false;
+                }
+                texture->image = std::move(image);
+                texture->needsUpdate();
+            }
+
+            if (useCache_) {
+                std::lock_guard<std::mutex> lck(cacheMutex_);
+                cache_[path.string()] = texture;
+            }
+
+            promise->set_value(texture);
+        });
+
+        return future;
+    }
+
     std::shared_ptr<Texture> loadFromMemory(const std::string& name, const std::vector<unsigned char>& data, bool flipY) {
 
         if (auto cachedTexture = checkCache(name)) {
@@ -88,7 +154,10 @@ struct TextureLoader::Impl {
         texture->format = isJPEG ? Format::RGB : Format::RGBA;
         texture->needsUpdate();
 
-        if (useCache_) cache_[name] = texture;
+        if (useCache_) {
+            std::lock_guard<std::mutex> lck(cacheMutex_);
+            cache_[name] = texture;
+        }
 
         return texture;
     }
@@ -107,8 +176,14 @@ std::shared_ptr<Texture> TextureLoader::loadFromMemory(const std::string& name,
     return pimpl_->loadFromMemory(name, data, flipY);
 }
 
+std::future<std::shared_ptr<Texture>> TextureLoader::loadAsync(const std::filesystem::path& path, bool flipY, bool generateMipmaps) {
+
+    return pimpl_->loadAsync(path, flipY, generateMipmaps);
+}
+
 void TextureLoader::clearCache() {
 
+    std::lock_guard<std::mutex> lck(pimpl_->cacheMutex_);
     pimpl_->cache_.clear();
 }
 
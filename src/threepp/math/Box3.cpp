@@ -6,28 +6,34 @@
 
 #include "threepp/math/Plane.hpp"
 #include "threepp/math/Triangle.hpp"
+#include "threepp/math/batch.hpp"
+
+#include <algorithm>
+#include <vector>
 
 using namespace threepp;
 
 namespace {
 
-    Vector3 _vector;
+    thread_local Vector3 _vector;
+
+    thread_local Vector3 _v0;
+    thread_local Vector3 _v1;
+    thread_local Vector3 _v2;
 
-    Vector3 _v0;
-    Vector3 _v1;
-    Vector3 _v2;
+    thread_local Vector3 _f0;
+    thread_local Vector3 _f1;
+    thread_local Vector3 _f2;
 
-    Vector3 _f0;
-    Vector3 _f1;
-    Vector3 _f2;
+    thread_local Vector3 _center;
+    thread_local Vector3 _extents;
 
-    Vector3 _center;
-    Vector3 _extents;
+    thread_local std::vector<float> _positions;
 
-    Vector3 _triangleNormal;
-    Vector3 _testAxis;
+    thread_local Vector3 _triangleNormal;
+    thread_local Vector3 _testAxis;
 
-    std::array<Vector3, 8> _points;
+    thread_local std::array<Vector3, 8> _points;
 
 
     bool satForAxes(const std::vector<float>& axes, const Vector3& v0, const Vector3& v1, const Vector3& v2, const Vector3& extents) {
@@ -190,11 +196,29 @@ Box3& Box3::expandByObject(Object3D& object, bool presice) {
         if (presice && geometry->getAttributes().count("position")) {
 
             const auto position = geometry->getAttribute<float>("position");
-            for (unsigned i = 0, l = position->count(); i < l; i++) {
 
-                position->setFromBufferAttribute(_vector, i);
-                _vector.applyMatrix4(*object.matrixWorld);
-                this->expandByPoint(_vector);
+            if (position->itemSize() >= 3) {
+
+                // transform a packed copy of the positions in one pass
+                const auto count = static_cast<size_t>(position->count());
+                const auto* data = position->itemData();
+                const auto stride = position->itemStride();
+
+                _positions.resize(count * 3);
+                for (size_t i = 0; i < count; i++) {
+
+                    std::copy(data + i * stride, data + i * stride + 3, _positions.begin() + static_cast<std::ptrdiff_t>(i * 3));
+                }
+
+                math::applyMatrix4(*object.matrixWorld, _positions.data(), count);
+
+                Vector3 min, max;
+                math::computeBounds(_positions.data(), count, 3, min, max);
+                if (count > 0) {
+
+                    this->expandByPoint(min);
+                    this->expandByPoint(max);
+                }
             }
 
         } else {
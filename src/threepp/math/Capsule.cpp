@@ -10,9 +10,9 @@ using namespace threepp;
 
 namespace {
 
-    Vector3 _v1;
-    Vector3 _v2;
-    Vector3 _v3;
+    thread_local Vector3 _v1;
+    thread_local Vector3 _v2;
+    thread_local Vector3 _v3;
 
     const float EPS = 1e-10;
 
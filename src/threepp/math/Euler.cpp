@@ -14,6 +14,14 @@ using namespace threepp;
 Euler::Euler(float x, float y, float z, Euler::RotationOrders order)
     : x(x), y(y), z(z), order_() {}
 
+Euler::Euler(const Euler& other)
+    : x(other.x()), y(other.y()), z(other.z()), order_(other.order_) {}
+
+Euler& Euler::operator=(const Euler& other) {
+
+    return copy(other);
+}
+
 
 Euler::RotationOrders Euler::getOrder() const {
 
@@ -21,8 +29,10 @@ Euler::RotationOrders Euler::getOrder() const {
 }
 void Euler::setOrder(Euler::RotationOrders value) {
 
+    if (stale_) refresh();
+
     this->order_ = value;
-    onChangeCallback_();
+    changed();
 }
 
 Euler& Euler::set(float x, float y, float z, const std::optional<RotationOrders>& order) {
@@ -32,18 +42,18 @@ Euler& Euler::set(float x, float y, float z, const std::optional<RotationOrders>
     this->z.value_ = z;
     this->order_ = order.value_or(this->order_);
 
-    this->onChangeCallback_();
+    this->changed();
 
     return *this;
 }
 
 Euler& Euler::copy(const Euler& euler) {
-    this->x = euler.x;
-    this->y = euler.y;
-    this->z = euler.z;
+    this->x.value_ = euler.x();
+    this->y.value_ = euler.y();
+    this->z.value_ = euler.z();
     this->order_ = euler.order_;
 
-    this->onChangeCallback_();
+    this->changed();
 
     return *this;
 }
@@ -164,7 +174,7 @@ Euler& Euler::setFromRotationMatrix(const Matrix4& m, std::optional<RotationOrde
             break;
     }
 
-    if (update) this->onChangeCallback_();
+    if (update) this->changed();
 
     return *this;
 }
@@ -185,9 +195,7 @@ Euler& Euler::setFromVector3(const Vector3& v, std::optional<RotationOrders> ord
 Euler& Euler::_onChange(std::function<void()> callback) {
 
     this->onChangeCallback_ = std::move(callback);
-    this->x.setCallback(this->onChangeCallback_);
-    this->y.setCallback(this->onChangeCallback_);
-    this->z.setCallback(this->onChangeCallback_);
+    attach();
 
     return *this;
 }
@@ -196,3 +204,32 @@ bool Euler::equals(const Euler& euler) const {
 
     return ( euler.x == this->x ) && ( euler.y == this->y ) && ( euler.z == this->z ) && ( euler.order_ == this->order_ );
 }
+
+void Euler::link(Quaternion& quaternion) {
+
+    this->quaternion_ = &quaternion;
+    quaternion.euler_ = this;
+
+    attach();
+    quaternion.attach();
+}
+
+void Euler::attach() {
+
+    for (auto c : {&x, &y, &z}) {
+        c->owner_ = this;
+    }
+}
+
+void Euler::refresh() {
+
+    stale_ = false;
+    setFromQuaternion(*quaternion_, std::nullopt, false);
+}
+
+void Euler::changed() {
+
+    stale_ = false;
+    if (quaternion_) quaternion_->stale_ = true;
+    if (onChangeCallback_) onChangeCallback_();
+}
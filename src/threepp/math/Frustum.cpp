@@ -7,8 +7,8 @@
 using namespace threepp;
 
 namespace {
-    Sphere _sphere{};
-    Vector3 _vector{};
+    thread_local Sphere _sphere{};
+    thread_local Vector3 _vector{};
 }// namespace
 
 Frustum::Frustum(Plane p0, Plane p1, Plane p2, Plane p3, Plane p4, Plane p5)
@@ -56,13 +56,8 @@ Frustum& Frustum::setFromProjectionMatrix(const Matrix4& m) {
 
 bool Frustum::intersectsObject(Object3D& object) const {
 
-    auto geometry = object.geometry();
-
-    if (!geometry->boundingSphere) geometry->computeBoundingSphere();
-
-    _sphere.copy(geometry->boundingSphere.value()).applyMatrix4(*object.matrixWorld);
-
-    return this->intersectsSphere(_sphere);
+    // cached by the object until it moves or its geometry changes
+    return this->intersectsSphere(*object.worldBoundingSphere());
 }
 
 bool Frustum::intersectsSprite(const Sprite& sprite) const {
@@ -112,6 +107,27 @@ bool Frustum::intersectsBox(const Box3& box) const {
     return true;
 }
 
+bool Frustum::containsBox(const Box3& box) const {
+
+    for (int i = 0; i < 6; i++) {
+
+        const auto& plane = planes_[i];
+
+        // corner at min distance
+
+        _vector.x = plane.normal.x > 0 ? box.min().x : box.max().x;
+        _vector.y = plane.normal.y > 0 ? box.min().y : box.max().y;
+        _vector.z = plane.normal.z > 0 ? box.min().z : box.max().z;
+
+        if (plane.distanceToPoint(_vector) < 0) {
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool Frustum::containsPoint(const Vector3& point) const {
 
     for (int i = 0; i < 6; i++) {
@@ -0,0 +1,422 @@
+
+#include "threepp/math/Octree.hpp"
+
+#include "threepp/core/BufferGeometry.hpp"
+#include "threepp/math/Capsule.hpp"
+#include "threepp/math/Line3.hpp"
+#include "threepp/math/Plane.hpp"
+#include "threepp/math/Ray.hpp"
+#include "threepp/math/Sphere.hpp"
+#include "threepp/math/octants.hpp"
+#include "threepp/objects/Mesh.hpp"
+#include "threepp/utils/SmallVector.hpp"
+#include "threepp/utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace threepp;
+
+namespace {
+
+    // as in three.js, nodes with more than 8 triangles are split, at most 16 levels deep
+    constexpr uint32_t maxLeafSize = 8;
+    constexpr int maxDepth = 16;
+
+    struct Face {
+        Vector3 a, b, c;
+        Plane plane;
+        Box3 box;
+        Vector3 centroid;
+
+        Face() = default;
+
+        Face(const Vector3& a, const Vector3& b, const Vector3& c)
+            : a(a), b(b), c(c) {
+
+            plane.setFromCoplanarPoints(a, b, c);
+            box.expandByPoint(a).expandByPoint(b).expandByPoint(c);
+            box.getCenter(centroid);
+        }
+
+        [[nodiscard]] bool degenerate() const {
+
+            return plane.normal.lengthSq() == 0;
+        }
+    };
+
+    struct FaceTraits {
+
+        static void expand(Box3& box, const Face& face) {
+
+            box.union_(face.box);
+        }
+
+        static const Vector3& centroid(const Face& face) {
+
+            return face.centroid;
+        }
+    };
+
+    // candidate faces of the current query, reused between queries
+    thread_local std::vector<uint32_t> _candidates;
+
+    // with edges false, only contacts with the interior of the face are reported
+    std::optional<Octree::Collision> triangleCapsuleIntersect(const Capsule& capsule, const Face& face, bool edges) {
+
+        const auto& plane = face.plane;
+
+        const auto d1 = plane.distanceToPoint(capsule.start) - capsule.radius;
+        const auto d2 = plane.distanceToPoint(capsule.end) - capsule.radius;
+
+        if ((d1 > 0 && d2 > 0) || (d1 < -capsule.radius && d2 < -capsule.radius)) {
+
+            return std::nullopt;
+        }
+
+        const auto delta = std::abs(d1 / (std::abs(d1) + std::abs(d2)));
+        const auto intersectPoint = Vector3().copy(capsule.start).lerp(capsule.end, delta);
+
+        if (Triangle::containsPoint(intersectPoint, face.a, face.b, face.c)) {
+
+            return Octree::Collision{plane.normal, std::abs(std::min(d1, d2))};
+        }
+
+        if (!edges) return std::nullopt;
+
+        const auto r2 = capsule.radius * capsule.radius;
+
+        const Line3 line1(capsule.start, capsule.end);
+        const std::array<Line3, 3> lines{Line3(face.a, face.b), Line3(face.b, face.c), Line3(face.c, face.a)};
+
+        for (const auto& line2 : lines) {
+
+            const auto [point1, point2] = capsule.lineLineMinimumPoints(line1, line2);
+
+            if (point1.distanceToSquared(point2) < r2) {
+
+                const auto normal = Vector3().copy(point1).sub(point2).normalize();
+                return Octree::Collision{normal, capsule.radius - point1.distanceTo(point2)};
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<Octree::Collision> triangleSphereIntersect(const Sphere& sphere, const Face& face, bool edges) {
+
+        const auto& plane = face.plane;
+
+        if (!sphere.intersectsPlane(plane)) return std::nullopt;
+
+        const auto depth = std::abs(plane.distanceToSphere(sphere));
+        const auto r2 = sphere.radius * sphere.radius - depth * depth;
+
+        Vector3 planePoint;
+        plane.projectPoint(sphere.center, planePoint);
+
+        if (Triangle::containsPoint(sphere.center, face.a, face.b, face.c)) {
+
+            return Octree::Collision{plane.normal, depth};
+        }
+
+        if (!edges) return std::nullopt;
+
+        std::array<Line3, 3> lines{Line3(face.a, face.b), Line3(face.b, face.c), Line3(face.c, face.a)};
+
+        Vector3 closest;
+        for (auto& line : lines) {
+
+            line.closestPointToPoint(planePoint, true, closest);
+
+            const auto d = closest.distanceToSquared(sphere.center);
+            if (d < r2) {
+
+                const auto normal = Vector3().copy(sphere.center).sub(closest).normalize();
+                return Octree::Collision{normal, sphere.radius - std::sqrt(d)};
+            }
+        }
+
+        return std::nullopt;
+    }
+
+}// namespace
+
+struct Octree::Impl {
+
+    std::vector<Face> faces;
+    std::vector<octants::Node> nodes;
+    // faces[0, built) are in the tree
+    size_t built = 0;
+
+    Box3 emptyBox;
+
+    void build(unsigned int threads) {
+
+        faces.erase(std::remove_if(faces.begin(), faces.end(), [](const Face& face) { return face.degenerate(); }), faces.end());
+
+        nodes.clear();
+        built = faces.size();
+
+        if (faces.empty()) return;
+
+        const auto count = static_cast<uint32_t>(faces.size());
+
+        std::unique_ptr<utils::ThreadPool> pool;
+        threads = std::max(threads, 1u);
+        if (threads > 1 && count > parallelThreshold) pool = std::make_unique<utils::ThreadPool>(threads);
+
+        // subtrees up to this size are built as independent jobs
+        const auto taskSize = std::max<uint32_t>(parallelThreshold / 8, count / (threads * 4));
+
+        nodes = octants::Builder<Face, FaceTraits>(faces, {}, maxLeafSize, maxDepth, pool.get(), taskSize).build();
+    }
+
+    // collects the faces of every leaf whose bounds pass the test
+    template<class Test>
+    std::vector<uint32_t>& candidates(const Test& test) const {
+
+        auto& result = _candidates;
+        result.clear();
+
+        if (nodes.empty() || !test(nodes.front().box)) return result;
+
+        utils::SmallVector<uint32_t, 64> stack;
+        stack.push_back(0);
+
+        while (!stack.empty()) {
+
+            const auto& node = nodes[stack.back()];
+            stack.pop_back();
+
+            if (node.isLeaf()) {
+
+                for (auto i = node.begin; i < node.end; ++i) result.push_back(i);
+                continue;
+            }
+
+            for (auto i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+
+                if (test(nodes[i].box)) stack.push_back(i);
+            }
+        }
+
+        return result;
+    }
+
+    void addMesh(const Mesh& mesh, size_t offset) {
+
+        const auto geometry = mesh.geometry();
+        const auto index = geometry->getIndex();
+        const auto position = geometry->getAttribute<float>("position");
+        const auto& matrix = *mesh.matrixWorld;
+        const auto count = countTriangles(mesh);
+
+        Vector3 a, b, c;
+        for (size_t t = 0; t < count; ++t) {
+
+            const auto vertex = [&](unsigned i) { return index ? index->getX(t * 3 + i) : t * 3 + i; };
+
+            position->setFromBufferAttribute(a, vertex(0));
+            position->setFromBufferAttribute(b, vertex(1));
+            position->setFromBufferAttribute(c, vertex(2));
+
+            faces[offset + t] = Face(a.applyMatrix4(matrix), b.applyMatrix4(matrix), c.applyMatrix4(matrix));
+        }
+    }
+
+    static size_t countTriangles(const Mesh& mesh) {
+
+        const auto geometry = mesh.geometry();
+        if (!geometry) return 0;
+
+        const auto position = geometry->getAttribute<float>("position");
+        if (!position) return 0;
+
+        if (const auto index = geometry->getIndex()) return index->count() / 3;
+
+        return position->count() / 3;
+    }
+};
+
+Octree::Octree()
+    : pimpl_(std::make_unique<Impl>()) {}
+
+Octree& Octree::addTriangle(const Triangle& triangle) {
+
+    pimpl_->faces.emplace_back(triangle.a(), triangle.b(), triangle.c());
+
+    return *this;
+}
+
+Octree& Octree::build(unsigned int threads) {
+
+    pimpl_->build(threads);
+
+    return *this;
+}
+
+Octree& Octree::fromGraphNode(Object3D& group, unsigned int threads) {
+
+    group.updateWorldMatrix(true, true);
+
+    std::vector<std::pair<const Mesh*, size_t>> meshes;
+    auto offset = pimpl_->faces.size();
+
+    group.traverseType<Mesh>([&](Mesh& mesh) {
+        meshes.emplace_back(&mesh, offset);
+        offset += Impl::countTriangles(mesh);
+    });
+
+    pimpl_->faces.resize(offset);
+
+    threads = std::max(threads, 1u);
+    if (threads > 1 && offset > parallelThreshold) {
+
+        utils::ThreadPool pool(threads);
+        for (const auto& [mesh, start] : meshes) {
+
+            pool.submit([this, mesh = mesh, start = start] { pimpl_->addMesh(*mesh, start); });
+        }
+        pool.wait();
+
+    } else {
+
+        for (const auto& [mesh, start] : meshes) pimpl_->addMesh(*mesh, start);
+    }
+
+    return build(threads);
+}
+
+void Octree::clear() {
+
+    pimpl_->faces.clear();
+    pimpl_->nodes.clear();
+    pimpl_->built = 0;
+}
+
+std::optional<Octree::Collision> Octree::sphereIntersect(const Sphere& sphere) const {
+
+    const auto& faces = pimpl_->faces;
+    const auto& candidates = pimpl_->candidates([&](const Box3& box) { return sphere.intersectsBox(box); });
+
+    Sphere _sphere = sphere;
+    bool hit = false;
+
+    // face contacts are resolved first, so that the inner edges of a flat, finely tessellated floor
+    // are no longer touched and do not push the sphere sideways
+    for (auto edges : {false, true}) {
+
+        for (auto i : candidates) {
+
+            if (const auto result = triangleSphereIntersect(_sphere, faces[i], edges)) {
+
+                hit = true;
+                _sphere.center.add(Vector3().copy(result->normal).multiplyScalar(result->depth));
+            }
+        }
+    }
+
+    if (!hit) return std::nullopt;
+
+    auto collisionVector = Vector3().copy(_sphere.center).sub(sphere.center);
+    const auto depth = collisionVector.length();
+
+    return Collision{collisionVector.normalize(), depth};
+}
+
+std::optional<Octree::Collision> Octree::capsuleIntersect(const Capsule& capsule) const {
+
+    const auto& faces = pimpl_->faces;
+    const auto& candidates = pimpl_->candidates([&](const Box3& box) { return capsule.intersectsBox(box); });
+
+    auto _capsule = capsule.clone();
+    bool hit = false;
+
+    // face contacts first, see sphereIntersect
+    for (auto edges : {false, true}) {
+
+        for (auto i : candidates) {
+
+            if (const auto result = triangleCapsuleIntersect(_capsule, faces[i], edges)) {
+
+                hit = true;
+                _capsule.translate(Vector3().copy(result->normal).multiplyScalar(result->depth));
+            }
+        }
+    }
+
+    if (!hit) return std::nullopt;
+
+    Vector3 center, originalCenter;
+    _capsule.getCenter(center);
+    capsule.getCenter(originalCenter);
+
+    auto collisionVector = center.sub(originalCenter);
+    const auto depth = collisionVector.length();
+
+    return Collision{collisionVector.normalize(), depth};
+}
+
+std::optional<Octree::RayHit> Octree::rayIntersect(const Ray& ray) const {
+
+    const auto& faces = pimpl_->faces;
+    const auto& nodes = pimpl_->nodes;
+
+    if (ray.direction.lengthSq() == 0 || nodes.empty()) return std::nullopt;
+
+    const auto& origin = ray.origin;
+    const Vector3 invDir(1.f / ray.direction.x, 1.f / ray.direction.y, 1.f / ray.direction.z);
+    // the box test is in units of the ray parameter, hit distances are not
+    const auto length = ray.direction.length();
+
+    auto distance = std::numeric_limits<float>::infinity();
+    std::optional<RayHit> hit;
+
+    utils::SmallVector<uint32_t, 64> stack;
+    stack.push_back(0);
+
+    Vector3 point;
+    while (!stack.empty()) {
+
+        const auto& node = nodes[stack.back()];
+        stack.pop_back();
+
+        // nodes beyond the nearest hit so far are skipped
+        if (!bvh::intersectsBox(node.box, origin, invDir, 0, distance / length)) continue;
+
+        if (!node.isLeaf()) {
+
+            for (auto i = node.firstChild; i < node.firstChild + node.childCount; ++i) stack.push_back(i);
+            continue;
+        }
+
+        for (auto i = node.begin; i < node.end; ++i) {
+
+            const auto& face = faces[i];
+            if (!ray.intersectTriangle(face.a, face.b, face.c, true, point)) continue;
+
+            const auto newDistance = point.distanceTo(origin);
+            if (newDistance < distance) {
+
+                distance = newDistance;
+                hit = RayHit{distance, Triangle(face.a, face.b, face.c), point};
+            }
+        }
+    }
+
+    return hit;
+}
+
+size_t Octree::triangleCount() const {
+
+    return pimpl_->built;
+}
+
+const Box3& Octree::bounds() const {
+
+    return pimpl_->nodes.empty() ? pimpl_->emptyBox : pimpl_->nodes.front().box;
+}
+
+Octree::~Octree() = default;
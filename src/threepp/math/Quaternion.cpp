@@ -15,6 +15,14 @@ using namespace threepp;
 Quaternion::Quaternion(float x, float y, float z, float w)
     : x(x), y(y), z(z), w(w) {}
 
+Quaternion::Quaternion(const Quaternion& other)
+    : x(other.x()), y(other.y()), z(other.z()), w(other.w()) {}
+
+Quaternion& Quaternion::operator=(const Quaternion& other) {
+
+    return copy(other);
+}
+
 float Quaternion::operator[](unsigned int index) const {
     switch (index) {
         case 0:
@@ -37,7 +45,7 @@ Quaternion& Quaternion::set(float x, float y, float z, float w) {
     this->z.value_ = z;
     this->w.value_ = w;
 
-    this->onChangeCallback_();
+    this->changed();
 
     return *this;
 }
@@ -49,7 +57,7 @@ Quaternion& Quaternion::copy(const Quaternion& quaternion) {
     this->z.value_ = quaternion.z();
     this->w.value_ = quaternion.w();
 
-    this->onChangeCallback_();
+    this->changed();
 
     return *this;
 }
@@ -117,7 +125,7 @@ Quaternion& Quaternion::setFromEuler(const Euler& euler, bool update) {
     }
 
     if (update) {
-        this->onChangeCallback_();
+        this->changed();
     }
 
     return *this;
@@ -136,7 +144,7 @@ Quaternion& Quaternion::setFromAxisAngle(const Vector3& axis, float angle) {
     this->z.value_ = axis.z * s;
     this->w.value_ = std::cos(halfAngle);
 
-    this->onChangeCallback_();
+    this->changed();
 
     return *this;
 }
@@ -192,7 +200,7 @@ Quaternion& Quaternion::setFromRotationMatrix(const Matrix4& m) {
         this->z.value_ = 0.25f * s;
     }
 
-    this->onChangeCallback_();
+    this->changed();
 
     return *this;
 }
@@ -200,6 +208,9 @@ Quaternion& Quaternion::setFromRotationMatrix(const Matrix4& m) {
 Quaternion& Quaternion::setFromUnitVectors(const Vector3& vFrom, const Vector3& vTo) {
     // assumes direction vectors vFrom and vTo are normalized
 
+    // all components are overwritten below, before normalize() reads them
+    stale_ = false;
+
     const auto EPS = 0.000001f;
 
     auto r = vFrom.dot(vTo) + 1;
@@ -262,18 +273,18 @@ Quaternion& Quaternion::slerp(const Quaternion& qb, float t) {
     if (t == 0) return *this;
     if (t == 1) return this->copy(qb);
 
-    const float x = this->x.value_, y = this->y.value_, z = this->z.value_, w = this->w.value_;
+    const float x = this->x(), y = this->y(), z = this->z(), w = this->w();
 
     // http://www.euclideanspace.com/maths/algebra/realNormedAlgebra/quaternions/slerp/
 
-    float cosHalfTheta = w * qb.w.value_ + x * qb.x.value_ + y * qb.y.value_ + z * qb.z.value_;
+    float cosHalfTheta = w * qb.w() + x * qb.x() + y * qb.y() + z * qb.z();
 
     if (cosHalfTheta < 0) {
 
-        this->w.value_ = -qb.w.value_;
-        this->x.value_ = -qb.x.value_;
-        this->y.value_ = -qb.y.value_;
-        this->z.value_ = -qb.z.value_;
+        this->w.value_ = -qb.w();
+        this->x.value_ = -qb.x();
+        this->y.value_ = -qb.y();
+        this->z.value_ = -qb.z();
 
         cosHalfTheta = -cosHalfTheta;
 
@@ -303,7 +314,7 @@ Quaternion& Quaternion::slerp(const Quaternion& qb, float t) {
         this->z.value_ = s * z + t * this->z.value_;
 
         this->normalize();
-        this->onChangeCallback_();
+        this->changed();
 
         return *this;
     }
@@ -313,12 +324,12 @@ Quaternion& Quaternion::slerp(const Quaternion& qb, float t) {
     const float ratioA = std::sin((1 - t) * halfTheta) / sinHalfTheta,
                 ratioB = std::sin(t * halfTheta) / sinHalfTheta;
 
-    this->w = (w * ratioA + this->w.value_ * ratioB);
-    this->x = (x * ratioA + this->x.value_ * ratioB);
-    this->y = (y * ratioA + this->y.value_ * ratioB);
-    this->z = (z * ratioA + this->z.value_ * ratioB);
+    this->w.value_ = (w * ratioA + this->w.value_ * ratioB);
+    this->x.value_ = (x * ratioA + this->x.value_ * ratioB);
+    this->y.value_ = (y * ratioA + this->y.value_ * ratioB);
+    this->z.value_ = (z * ratioA + this->z.value_ * ratioB);
 
-    this->onChangeCallback_();
+    this->changed();
 
     return *this;
 }
@@ -342,11 +353,11 @@ Quaternion& Quaternion::invert() {
 
 Quaternion& Quaternion::conjugate() {
 
-    this->x.value_ *= -1;
-    this->y.value_ *= -1;
-    this->z.value_ *= -1;
+    this->x.value_ = -this->x();
+    this->y.value_ = -this->y();
+    this->z.value_ = -this->z();
 
-    this->onChangeCallback_();
+    this->changed();
 
     return *this;
 }
@@ -387,7 +398,7 @@ Quaternion& Quaternion::normalize() {
         this->w.value_ = this->w * l;
     }
 
-    this->onChangeCallback_();
+    this->changed();
 
     return *this;
 }
@@ -414,14 +425,14 @@ Quaternion& Quaternion::multiplyQuaternions(const Quaternion& a, const Quaternio
     this->z.value_ = qaz * qbw + qaw * qbz + qax * qby - qay * qbx;
     this->w.value_ = qaw * qbw - qax * qbx - qay * qby - qaz * qbz;
 
-    this->onChangeCallback_();
+    this->changed();
 
     return *this;
 }
 
 Quaternion Quaternion::clone() const {
 
-    return Quaternion(x.value_, y.value_, z.value_, w.value_);
+    return Quaternion(x(), y(), z(), w());
 }
 
 bool Quaternion::equals(const Quaternion& v) const {
@@ -432,14 +443,31 @@ bool Quaternion::equals(const Quaternion& v) const {
 Quaternion& Quaternion::_onChange(std::function<void()> callback) {
 
     this->onChangeCallback_ = std::move(callback);
-    this->x.setCallback(this->onChangeCallback_);
-    this->y.setCallback(this->onChangeCallback_);
-    this->z.setCallback(this->onChangeCallback_);
-    this->w.setCallback(this->onChangeCallback_);
+    attach();
 
     return *this;
 }
 
+void Quaternion::attach() {
+
+    for (auto c : {&x, &y, &z, &w}) {
+        c->owner_ = this;
+    }
+}
+
+void Quaternion::refresh() {
+
+    stale_ = false;
+    setFromEuler(*euler_, false);
+}
+
+void Quaternion::changed() {
+
+    stale_ = false;
+    if (euler_) euler_->stale_ = true;
+    if (onChangeCallback_) onChangeCallback_();
+}
+
 bool Quaternion::operator==(const Quaternion& other) const {
 
     return equals(other);
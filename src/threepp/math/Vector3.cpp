@@ -6,6 +6,7 @@
 #include "threepp/math/Matrix4.hpp"
 #include "threepp/math/Quaternion.hpp"
 #include "threepp/math/Spherical.hpp"
+#include "threepp/math/simd.hpp"
 
 #include "threepp/cameras/Camera.hpp"
 
@@ -204,14 +205,14 @@ Vector3& Vector3::applyNormalMatrix(const Matrix3& m) {
 
 Vector3& Vector3::applyMatrix4(const Matrix4& m) {
 
-    const auto x_ = this->x, y_ = this->y, z_ = this->z;
-    const auto& e = m.elements;
+    float r[4];
+    simd::store(r, simd::transformPoint(m.elements.data(), x, y, z));
 
-    const auto w = 1.0f / (e[3] * x + e[7] * y + e[11] * z + e[15]);
+    const auto w = 1.0f / r[3];
 
-    this->x = (e[0] * x_ + e[4] * y_ + e[8] * z_ + e[12]) * w;
-    this->y = (e[1] * x_ + e[5] * y_ + e[9] * z_ + e[13]) * w;
-    this->z = (e[2] * x_ + e[6] * y_ + e[10] * z_ + e[14]) * w;
+    this->x = r[0] * w;
+    this->y = r[1] * w;
+    this->z = r[2] * w;
 
     return *this;
 }
@@ -0,0 +1,126 @@
+
+#include "threepp/math/batch.hpp"
+
+#include "threepp/math/infinity.hpp"
+#include "threepp/math/simd.hpp"
+
+#include <cmath>
+
+using namespace threepp;
+
+void math::applyMatrix4(const Matrix4& m, float* data, size_t count, size_t stride) {
+
+    const auto* e = m.elements.data();
+
+    float r[4];
+    for (size_t i = 0; i < count; ++i) {
+
+        auto* p = data + i * stride;
+
+        simd::store(r, simd::transformPoint(e, p[0], p[1], p[2]));
+
+        const auto w = 1.0f / r[3];
+        p[0] = r[0] * w;
+        p[1] = r[1] * w;
+        p[2] = r[2] * w;
+    }
+}
+
+void math::transformDirections(const Matrix4& m, float* data, size_t count, size_t stride) {
+
+    const auto* e = m.elements.data();
+    const auto c0 = simd::load(e), c1 = simd::load(e + 4), c2 = simd::load(e + 8);
+
+    float r[4];
+    for (size_t i = 0; i < count; ++i) {
+
+        auto* p = data + i * stride;
+
+        simd::store(r, simd::madd(c2, simd::splat(p[2]), simd::madd(c1, simd::splat(p[1]), simd::mul(c0, simd::splat(p[0])))));
+
+        const auto l = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+        const auto d = std::isnan(l) ? 1 : l;
+        p[0] = r[0] / d;
+        p[1] = r[1] / d;
+        p[2] = r[2] / d;
+    }
+}
+
+void math::computeBounds(const float* data, size_t count, size_t stride, Vector3& min, Vector3& max) {
+
+    auto lo = simd::splat(Infinity<float>);
+    auto hi = simd::splat(-Infinity<float>);
+
+    // the 4th lane reads the float after the item, which is past the end of the array for the last item when items
+    // are packed or when xyz ends an interleaved item, so the last item is always loaded separately
+    const auto wide = count > 0 ? count - 1 : 0;
+
+    for (size_t i = 0; i < wide; ++i) {
+
+        const auto v = simd::load(data + i * stride);
+        // NaN components are skipped, as the second operand is returned when either is NaN
+        lo = simd::min(v, lo);
+        hi = simd::max(v, hi);
+    }
+
+    for (size_t i = wide; i < count; ++i) {
+
+        const auto* p = data + i * stride;
+        const auto v = simd::set(p[0], p[1], p[2], 0);
+        lo = simd::min(v, lo);
+        hi = simd::max(v, hi);
+    }
+
+    float r[4];
+    simd::store(r, lo);
+    min.set(r[0], r[1], r[2]);
+    simd::store(r, hi);
+    max.set(r[0], r[1], r[2]);
+}
+
+void math::multiplyMatrices(const Matrix4* a, const Matrix4* b, Matrix4* out, size_t count) {
+
+    for (size_t i = 0; i < count; ++i) {
+
+        simd::multiplyMatrices(a[i].elements.data(), b[i].elements.data(), out[i].elements.data());
+    }
+}
+
+void math::composeMatrices(const float* positions, const float* quaternions, const float* scales, Matrix4* out, size_t count) {
+
+    for (size_t i = 0; i < count; ++i) {
+
+        const auto* p = positions + i * 3;
+        const auto* q = quaternions + i * 4;
+        const auto* s = scales + i * 3;
+        auto& te = out[i].elements;
+
+        const float x = q[0], y = q[1], z = q[2], w = q[3];
+        const float x2 = x + x, y2 = y + y, z2 = z + z;
+        const float xx = x * x2, xy = x * y2, xz = x * z2;
+        const float yy = y * y2, yz = y * z2, zz = z * z2;
+        const float wx = w * x2, wy = w * y2, wz = w * z2;
+
+        const float sx = s[0], sy = s[1], sz = s[2];
+
+        te[0] = (1 - (yy + zz)) * sx;
+        te[1] = (xy + wz) * sx;
+        te[2] = (xz - wy) * sx;
+        te[3] = 0;
+
+        te[4] = (xy - wz) * sy;
+        te[5] = (1 - (xx + zz)) * sy;
+        te[6] = (yz + wx) * sy;
+        te[7] = 0;
+
+        te[8] = (xz + wy) * sz;
+        te[9] = (yz - wx) * sz;
+        te[10] = (1 - (xx + yy)) * sz;
+        te[11] = 0;
+
+        te[12] = p[0];
+        te[13] = p[1];
+        te[14] = p[2];
+        te[15] = 1;
+    }
+}
@@ -0,0 +1,315 @@
+
+#ifndef THREEPP_BVH_HPP
+#define THREEPP_BVH_HPP
+
+// Binned SAH construction shared by the bounding volume hierarchies (SceneBVH, TriangleBVH, InstancedMesh).
+// Items are any type with a Box3 box and a Vector3 centroid; the builder reorders them so that
+// every node covers a contiguous range. Node indices of children are always larger than their parent's.
+
+#include "threepp/math/Box3.hpp"
+#include "threepp/utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace threepp::bvh {
+
+    constexpr uint32_t invalid = std::numeric_limits<uint32_t>::max();
+
+    struct Node {
+        Box3 box;
+        // items of the subtree are items[begin, end)
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        uint32_t left = invalid;
+        uint32_t right = invalid;
+        uint32_t parent = invalid;
+
+        [[nodiscard]] bool isLeaf() const {
+
+            return left == invalid;
+        }
+    };
+
+    inline float component(const Vector3& v, int axis) {
+
+        return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+    }
+
+    inline float surfaceArea(const Box3& box) {
+
+        if (box.isEmpty()) return 0;
+
+        const auto& min = box.min();
+        const auto& max = box.max();
+        const float dx = max.x - min.x, dy = max.y - min.y, dz = max.z - min.z;
+
+        return 2 * (dx * dy + dy * dz + dz * dx);
+    }
+
+    // slab test, clipped to [near, far]. On a hit, entry is the distance at which the ray enters the box.
+    inline bool intersectsBox(const Box3& box, const Vector3& origin, const Vector3& invDir, float near, float far, float& entry) {
+
+        float tmin = near, tmax = far;
+
+        for (int axis = 0; axis < 3; ++axis) {
+
+            const float t1 = (component(box.min(), axis) - component(origin, axis)) * component(invDir, axis);
+            const float t2 = (component(box.max(), axis) - component(origin, axis)) * component(invDir, axis);
+
+            tmin = std::max(tmin, std::min(t1, t2));
+            tmax = std::min(tmax, std::max(t1, t2));
+        }
+
+        entry = tmin;
+
+        return tmin <= tmax;
+    }
+
+    inline bool intersectsBox(const Box3& box, const Vector3& origin, const Vector3& invDir, float near, float far) {
+
+        float entry;
+        return intersectsBox(box, origin, invDir, near, far, entry);
+    }
+
+    // a subtree built on a worker thread, into its own node array
+    template<class NodeType>
+    struct Task {
+        uint32_t placeholder;
+        uint32_t begin;
+        uint32_t end;
+        int depth;
+        std::vector<NodeType> nodes;
+    };
+
+    // builds every task on the pool, then moves its nodes into nodes, its root replacing the placeholder.
+    // relink(node, map) passes the child and parent indices of a task node through map.
+    template<class NodeType, class Build, class Relink>
+    void runTasks(utils::ThreadPool& pool, std::vector<NodeType>& nodes, std::vector<Task<NodeType>>& tasks, const Build& build, const Relink& relink) {
+
+        for (auto& task : tasks) {
+
+            pool.submit([&build, &task] { build(task); });
+        }
+        pool.wait();
+
+        for (auto& task : tasks) {
+
+            const auto offset = static_cast<uint32_t>(nodes.size());
+            const auto placeholder = task.placeholder;
+            const auto parent = nodes[placeholder].parent;
+
+            const auto map = [&](uint32_t i) {
+                if (i == invalid) return invalid;
+                return i == 0 ? placeholder : offset + i - 1;
+            };
+
+            for (auto& node : task.nodes) relink(node, map);
+            task.nodes.front().parent = parent;
+
+            nodes[placeholder] = task.nodes.front();
+            nodes.insert(nodes.end(), task.nodes.begin() + 1, task.nodes.end());
+        }
+    }
+
+    // recomputes the bounds of every node from its items, children before parents
+    template<class Item>
+    void refit(std::vector<Node>& nodes, const std::vector<Item>& items) {
+
+        for (auto i = nodes.size(); i-- > 0;) {
+
+            auto& node = nodes[i];
+            node.box.makeEmpty();
+
+            if (node.isLeaf()) {
+
+                for (auto j = node.begin; j < node.end; ++j) node.box.union_(items[j].box);
+
+            } else {
+
+                node.box.copy(nodes[node.left].box).union_(nodes[node.right].box);
+            }
+        }
+    }
+
+    template<class Item>
+    class Builder {
+
+    public:
+        static constexpr int binCount = 16;
+        // cost of visiting a node, relative to testing one item
+        static constexpr float traversalCost = 1;
+
+        // with a pool, subtrees of up to taskSize items are built as independent jobs
+        Builder(std::vector<Item>& items, uint32_t maxLeafSize, utils::ThreadPool* pool = nullptr, uint32_t taskSize = 0)
+            : items_(items), maxLeafSize_(maxLeafSize), pool_(pool), taskSize_(taskSize) {}
+
+        std::vector<Node> build() {
+
+            std::vector<Node> nodes;
+            if (items_.empty()) return nodes;
+
+            const auto count = static_cast<uint32_t>(items_.size());
+
+            std::vector<Task<Node>> tasks;
+            buildNode(nodes, 0, count, invalid, pool_ && taskSize_ < count ? &tasks : nullptr);
+
+            if (!tasks.empty()) {
+
+                const auto build = [this](Task<Node>& task) {
+                    buildNode(task.nodes, task.begin, task.end, invalid, nullptr);
+                };
+                const auto relink = [](Node& node, const auto& map) {
+                    node.left = map(node.left);
+                    node.right = map(node.right);
+                    node.parent = map(node.parent);
+                };
+
+                runTasks(*pool_, nodes, tasks, build, relink);
+            }
+
+            return nodes;
+        }
+
+    private:
+        std::vector<Item>& items_;
+        uint32_t maxLeafSize_;
+        utils::ThreadPool* pool_;
+        uint32_t taskSize_;
+
+        // builds the subtree over items[begin, end) into nodes, returning its index
+        uint32_t buildNode(std::vector<Node>& nodes, uint32_t begin, uint32_t end, uint32_t parent, std::vector<Task<Node>>* tasks) {
+
+            const auto index = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+
+            Node node;
+            node.begin = begin;
+            node.end = end;
+            node.parent = parent;
+
+            Box3 centroids;
+            for (auto i = begin; i < end; ++i) {
+
+                node.box.union_(items_[i].box);
+                centroids.expandByPoint(items_[i].centroid);
+            }
+
+            const auto mid = split(begin, end, node.box, centroids);
+
+            if (mid != invalid) {
+
+                node.left = child(nodes, begin, mid, index, tasks);
+                node.right = child(nodes, mid, end, index, tasks);
+            }
+
+            nodes[index] = node;
+
+            return index;
+        }
+
+        uint32_t child(std::vector<Node>& nodes, uint32_t begin, uint32_t end, uint32_t parent, std::vector<Task<Node>>* tasks) {
+
+            if (tasks && end - begin <= taskSize_) {
+
+                const auto index = static_cast<uint32_t>(nodes.size());
+                nodes.emplace_back().parent = parent;
+                tasks->push_back({index, begin, end, 0, {}});
+
+                return index;
+            }
+
+            return buildNode(nodes, begin, end, parent, tasks);
+        }
+
+        // partitions items[begin, end) along the cheapest binned SAH split, returns the split position or invalid for a leaf
+        uint32_t split(uint32_t begin, uint32_t end, const Box3& box, const Box3& centroids) {
+
+            const auto count = end - begin;
+            if (count <= 1) return invalid;
+
+            struct Bin {
+                Box3 box;
+                uint32_t count = 0;
+            };
+
+            float bestCost = std::numeric_limits<float>::infinity();
+            int bestAxis = -1;
+            int bestBin = 0;
+
+            const auto& cmin = centroids.min();
+            const auto& cmax = centroids.max();
+
+            for (int axis = 0; axis < 3; ++axis) {
+
+                const float extent = component(cmax, axis) - component(cmin, axis);
+                if (extent <= 0) continue;
+
+                const float scale = binCount / extent;
+                std::array<Bin, binCount> bins;
+
+                for (auto i = begin; i < end; ++i) {
+
+                    const auto b = std::min(binCount - 1, static_cast<int>((component(items_[i].centroid, axis) - component(cmin, axis)) * scale));
+                    bins[b].box.union_(items_[i].box);
+                    ++bins[b].count;
+                }
+
+                // area and count to the right of each split, swept from the right
+                std::array<float, binCount> rightArea{};
+                std::array<uint32_t, binCount> rightCount{};
+                Box3 right;
+                uint32_t n = 0;
+                for (int b = binCount - 1; b > 0; --b) {
+
+                    right.union_(bins[b].box);
+                    n += bins[b].count;
+                    rightArea[b] = surfaceArea(right);
+                    rightCount[b] = n;
+                }
+
+                Box3 left;
+                n = 0;
+                for (int b = 0; b < binCount - 1; ++b) {
+
+                    left.union_(bins[b].box);
+                    n += bins[b].count;
+
+                    if (n == 0 || rightCount[b + 1] == 0) continue;
+
+                    const float cost = n * surfaceArea(left) + rightCount[b + 1] * rightArea[b + 1];
+                    if (cost < bestCost) {
+
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestBin = b;
+                    }
+                }
+            }
+
+            const float area = surfaceArea(box);
+            const float splitCost = area > 0 ? traversalCost + bestCost / area : bestCost;
+
+            if (bestAxis < 0 || splitCost >= static_cast<float>(count)) {
+
+                if (count <= maxLeafSize_) return invalid;
+
+                // no useful split, e.g. all centroids coincide
+                if (bestAxis < 0) return begin + count / 2;
+            }
+
+            const float scale = binCount / (component(cmax, bestAxis) - component(cmin, bestAxis));
+            const auto it = std::partition(items_.begin() + begin, items_.begin() + end, [&](const Item& item) {
+                return std::min(binCount - 1, static_cast<int>((component(item.centroid, bestAxis) - component(cmin, bestAxis)) * scale)) <= bestBin;
+            });
+
+            return static_cast<uint32_t>(it - items_.begin());
+        }
+    };
+
+}// namespace threepp::bvh
+
+#endif//THREEPP_BVH_HPP
@@ -0,0 +1,159 @@
+
+#ifndef THREEPP_OCTANTS_HPP
+#define THREEPP_OCTANTS_HPP
+
+// Octant construction shared by the loose octrees (Octree, PointOctree).
+// Each item lives in the one octant holding its centroid, and nodes are bounded by their items,
+// so no item is stored or tested twice. The builder reorders items so that every node covers a contiguous range.
+// Children of a node are stored next to each other, at larger indices than their parent.
+
+#include "threepp/math/bvh.hpp"
+
+namespace threepp::octants {
+
+    using bvh::invalid;
+
+    struct Node {
+        Box3 box;
+        // items of the subtree are items[begin, end)
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        uint32_t firstChild = invalid;
+        uint32_t childCount = 0;
+        uint32_t parent = invalid;
+
+        [[nodiscard]] bool isLeaf() const {
+
+            return firstChild == invalid;
+        }
+    };
+
+    // Traits provide expand(Box3&, const Item&), growing a node box by an item, and centroid(const Item&)
+    template<class Item, class Traits>
+    class Builder {
+
+    public:
+        // with a pool, subtrees of up to taskSize items are built as independent jobs
+        Builder(std::vector<Item>& items, const Traits& traits, uint32_t maxLeafSize, int maxDepth, utils::ThreadPool* pool = nullptr, uint32_t taskSize = 0)
+            : items_(items), traits_(traits), maxLeafSize_(maxLeafSize), maxDepth_(maxDepth), pool_(pool), taskSize_(taskSize) {}
+
+        std::vector<Node> build() {
+
+            std::vector<Node> nodes;
+            if (items_.empty()) return nodes;
+
+            const auto count = static_cast<uint32_t>(items_.size());
+
+            std::vector<bvh::Task<Node>> tasks;
+            nodes.emplace_back();
+            buildNode(nodes, 0, 0, count, 0, pool_ ? &tasks : nullptr);
+
+            if (!tasks.empty()) {
+
+                const auto build = [this](bvh::Task<Node>& task) {
+                    task.nodes.emplace_back();
+                    buildNode(task.nodes, 0, task.begin, task.end, task.depth, nullptr);
+                };
+                const auto relink = [](Node& node, const auto& map) {
+                    node.firstChild = map(node.firstChild);
+                    node.parent = map(node.parent);
+                };
+
+                bvh::runTasks(*pool_, nodes, tasks, build, relink);
+            }
+
+            return nodes;
+        }
+
+    private:
+        std::vector<Item>& items_;
+        Traits traits_;
+        uint32_t maxLeafSize_;
+        int maxDepth_;
+        utils::ThreadPool* pool_;
+        uint32_t taskSize_;
+
+        // fills nodes[index] with the subtree over items[begin, end)
+        void buildNode(std::vector<Node>& nodes, uint32_t index, uint32_t begin, uint32_t end, int depth, std::vector<bvh::Task<Node>>* tasks) {
+
+            Node node;
+            node.begin = begin;
+            node.end = end;
+            node.parent = nodes[index].parent;
+
+            Box3 centroids;
+            for (auto i = begin; i < end; ++i) {
+
+                traits_.expand(node.box, items_[i]);
+                centroids.expandByPoint(traits_.centroid(items_[i]));
+            }
+
+            nodes[index] = node;
+
+            if (end - begin <= maxLeafSize_ || depth >= maxDepth_) return;
+
+            // split the items into octants around the center of their centroids
+
+            Vector3 center;
+            centroids.getCenter(center);
+
+            const auto first = items_.begin() + begin;
+            const auto last = items_.begin() + end;
+
+            const auto below = [this, &center](int axis) {
+                return [this, axis, value = bvh::component(center, axis)](const Item& item) {
+                    return bvh::component(traits_.centroid(item), axis) < value;
+                };
+            };
+
+            const auto x = std::partition(first, last, below(0));
+            const auto y0 = std::partition(first, x, below(1));
+            const auto y1 = std::partition(x, last, below(1));
+
+            const std::array<decltype(first), 9> bounds{
+                    first, std::partition(first, y0, below(2)),
+                    y0, std::partition(y0, x, below(2)),
+                    x, std::partition(x, y1, below(2)),
+                    y1, std::partition(y1, last, below(2)),
+                    last};
+
+            uint32_t childCount = 0;
+            for (int i = 0; i < 8; ++i) {
+
+                if (bounds[i + 1] - bounds[i] == end - begin) return;// coincident centroids
+                if (bounds[i + 1] != bounds[i]) ++childCount;
+            }
+
+            const auto firstChild = static_cast<uint32_t>(nodes.size());
+            nodes[index].firstChild = firstChild;
+            nodes[index].childCount = childCount;
+
+            for (uint32_t i = 0; i < childCount; ++i) nodes.emplace_back().parent = index;
+
+            auto child = firstChild;
+            for (int i = 0; i < 8; ++i) {
+
+                if (bounds[i + 1] == bounds[i]) continue;
+
+                const auto childBegin = static_cast<uint32_t>(bounds[i] - items_.begin());
+                const auto childEnd = static_cast<uint32_t>(bounds[i + 1] - items_.begin());
+
+                if (tasks && childEnd - childBegin <= taskSize_) {
+
+                    nodes[child].begin = childBegin;
+                    nodes[child].end = childEnd;
+                    tasks->push_back({child, childBegin, childEnd, depth + 1, {}});
+
+                } else {
+
+                    buildNode(nodes, child, childBegin, childEnd, depth + 1, tasks);
+                }
+
+                ++child;
+            }
+        }
+    };
+
+}// namespace threepp::octants
+
+#endif//THREEPP_OCTANTS_HPP
@@ -0,0 +1,105 @@
+
+#ifndef THREEPP_SIMD_HPP
+#define THREEPP_SIMD_HPP
+
+// Minimal 4-wide float abstraction used by the math kernels.
+// SSE2 and NEON are baseline on x86-64 and arm64, so the implementation is chosen at build time.
+// min(a, b)/max(a, b) return b when a is NaN on all paths.
+// Define THREEPP_NO_SIMD to force the scalar fallback.
+
+#if !defined(THREEPP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define THREEPP_SIMD_SSE
+#include <emmintrin.h>
+#elif !defined(THREEPP_NO_SIMD) && (defined(__aarch64__) || defined(_M_ARM64))
+#define THREEPP_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#include <algorithm>
+
+namespace threepp::simd {
+
+#if defined(THREEPP_SIMD_SSE)
+
+    struct float4 {
+        __m128 v;
+    };
+
+    inline float4 load(const float* p) { return {_mm_loadu_ps(p)}; }
+    inline void store(float* p, float4 a) { _mm_storeu_ps(p, a.v); }
+    inline float4 set(float x, float y, float z, float w) { return {_mm_setr_ps(x, y, z, w)}; }
+    inline float4 splat(float s) { return {_mm_set1_ps(s)}; }
+    inline float4 add(float4 a, float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+    inline float4 mul(float4 a, float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+    inline float4 madd(float4 a, float4 b, float4 c) { return {_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v)}; }
+    inline float4 min(float4 a, float4 b) { return {_mm_min_ps(a.v, b.v)}; }
+    inline float4 max(float4 a, float4 b) { return {_mm_max_ps(a.v, b.v)}; }
+
+#elif defined(THREEPP_SIMD_NEON)
+
+    struct float4 {
+        float32x4_t v;
+    };
+
+    inline float4 load(const float* p) { return {vld1q_f32(p)}; }
+    inline void store(float* p, float4 a) { vst1q_f32(p, a.v); }
+    inline float4 set(float x, float y, float z, float w) {
+        const float data[4]{x, y, z, w};
+        return {vld1q_f32(data)};
+    }
+    inline float4 splat(float s) { return {vdupq_n_f32(s)}; }
+    inline float4 add(float4 a, float4 b) { return {vaddq_f32(a.v, b.v)}; }
+    inline float4 mul(float4 a, float4 b) { return {vmulq_f32(a.v, b.v)}; }
+    // separate multiply and add, so results match the SSE and scalar paths
+    inline float4 madd(float4 a, float4 b, float4 c) { return {vaddq_f32(vmulq_f32(a.v, b.v), c.v)}; }
+    inline float4 min(float4 a, float4 b) { return {vminnmq_f32(a.v, b.v)}; }
+    inline float4 max(float4 a, float4 b) { return {vmaxnmq_f32(a.v, b.v)}; }
+
+#else
+
+    struct float4 {
+        float v[4];
+    };
+
+    inline float4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+    inline void store(float* p, float4 a) { std::copy(a.v, a.v + 4, p); }
+    inline float4 set(float x, float y, float z, float w) { return {{x, y, z, w}}; }
+    inline float4 splat(float s) { return {{s, s, s, s}}; }
+    inline float4 add(float4 a, float4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+    inline float4 mul(float4 a, float4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+    inline float4 madd(float4 a, float4 b, float4 c) { return add(mul(a, b), c); }
+    // like minps/maxps
+    inline float min(float a, float b) { return a < b ? a : b; }
+    inline float max(float a, float b) { return a > b ? a : b; }
+    inline float4 min(float4 a, float4 b) { return {{min(a.v[0], b.v[0]), min(a.v[1], b.v[1]), min(a.v[2], b.v[2]), min(a.v[3], b.v[3])}}; }
+    inline float4 max(float4 a, float4 b) { return {{max(a.v[0], b.v[0]), max(a.v[1], b.v[1]), max(a.v[2], b.v[2]), max(a.v[3], b.v[3])}}; }
+
+#endif
+
+    // out = a * b, for column-major 4x4 matrices. out may alias a or b.
+    inline void multiplyMatrices(const float* a, const float* b, float* out) {
+
+        const auto a0 = load(a), a1 = load(a + 4), a2 = load(a + 8), a3 = load(a + 12);
+
+        float4 columns[4];
+        for (int i = 0; i < 4; ++i) {
+
+            const auto* bc = b + i * 4;
+            columns[i] = madd(a3, splat(bc[3]), madd(a2, splat(bc[2]), madd(a1, splat(bc[1]), mul(a0, splat(bc[0])))));
+        }
+
+        for (int i = 0; i < 4; ++i) {
+
+            store(out + i * 4, columns[i]);
+        }
+    }
+
+    // m * (x, y, z, 1), returning all four components
+    inline float4 transformPoint(const float* m, float x, float y, float z) {
+
+        return add(madd(load(m + 8), splat(z), madd(load(m + 4), splat(y), mul(load(m), splat(x)))), load(m + 12));
+    }
+
+}// namespace threepp::simd
+
+#endif//THREEPP_SIMD_HPP
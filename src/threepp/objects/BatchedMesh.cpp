@@ -0,0 +1,450 @@
+
+#include "threepp/objects/BatchedMesh.hpp"
+
+#include "threepp/cameras/Camera.hpp"
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/math/Frustum.hpp"
+#include "threepp/math/MathUtils.hpp"
+#include "threepp/textures/DataTexture.hpp"
+#include "threepp/utils/RangeAllocator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace threepp;
+
+namespace {
+
+    thread_local Matrix4 _batchMatrix;
+    thread_local Matrix4 _batchWorldMatrix;
+    thread_local Sphere _sphere;
+
+    const std::string batchIdName{"batchId"};
+
+}// namespace
+
+struct BatchedMesh::Impl {
+
+    struct Geometry {
+        bool active = false;
+        bool visible = true;
+
+        size_t vertexStart{}, vertexCount{};
+        size_t indexStart{}, indexCount{};
+
+        Sphere sphere;
+    };
+
+    BatchedMesh& mesh;
+    BufferGeometry& shared;
+
+    size_t maxGeometryCount;
+
+    utils::RangeAllocator vertices;
+    utils::RangeAllocator indices;
+
+    std::vector<Geometry> geometries;
+    std::vector<int> freeIds;
+
+    std::shared_ptr<DataTexture> texture;
+
+    DrawRanges visible;
+    bool visibleNeedsUpdate = true;
+
+    DrawRanges culled;
+    std::optional<unsigned int> culledCamera;
+
+    Impl(BatchedMesh& mesh, size_t maxGeometryCount, size_t maxVertexCount, size_t maxIndexCount)
+        : mesh(mesh), shared(*mesh.geometry()),
+          maxGeometryCount(maxGeometryCount),
+          vertices(maxVertexCount), indices(maxIndexCount) {
+
+        // layout (1 matrix = 4 pixels), as the bone texture of Skeleton
+        const auto size = std::max(math::ceilPowerOfTwo(std::sqrt(static_cast<float>(maxGeometryCount * 4))), 4);
+
+        std::vector<float> matrices(size * size * 4);
+        for (size_t i = 0; i < maxGeometryCount; ++i) {
+
+            Matrix4().toArray(matrices, i * 16);
+        }
+
+        texture = DataTexture::create(matrices, size, size);
+        texture->format = Format::RGBA;
+        texture->type = Type::Float;
+
+        shared.setIndex(std::vector<unsigned int>(maxIndexCount));
+        shared.setAttribute(batchIdName, FloatBufferAttribute::create(std::vector<float>(maxVertexCount), 1));
+    }
+
+    // the first geometry sets the attributes of the batch
+    void setLayout(const BufferGeometry& geometry) {
+
+        const auto capacity = static_cast<size_t>(shared.getAttribute(batchIdName)->count());
+
+        for (const auto& [name, attribute] : geometry.getAttributes()) {
+
+            if (!attribute->typed<float>()) {
+
+                throw std::invalid_argument("BatchedMesh: attribute '" + name + "' is not a float attribute");
+            }
+
+            const auto itemSize = attribute->itemSize();
+            shared.setAttribute(name, FloatBufferAttribute::create(std::vector<float>(capacity * itemSize), itemSize, attribute->normalized()));
+        }
+    }
+
+    void checkLayout(const BufferGeometry& geometry) const {
+
+        const auto& attributes = geometry.getAttributes();
+
+        if (!attributes.count("position")) {
+
+            throw std::invalid_argument("BatchedMesh: geometry has no position attribute");
+        }
+
+        if (attributes.size() + 1 != shared.getAttributes().size()) {
+
+            throw std::invalid_argument("BatchedMesh: geometry attributes differ from those of the batch");
+        }
+
+        for (const auto& [name, attribute] : attributes) {
+
+            const auto* target = shared.getAttributes().count(name) ? shared.getAttributes().at(name).get() : nullptr;
+
+            if (!target || target->itemSize() != attribute->itemSize() || !attribute->typed<float>()) {
+
+                throw std::invalid_argument("BatchedMesh: attribute '" + name + "' differs from that of the batch");
+            }
+        }
+    }
+
+    int addGeometry(const BufferGeometry& geometry) {
+
+        if (shared.getAttributes().size() == 1) {
+
+            setLayout(geometry);
+        }
+
+        checkLayout(geometry);
+
+        const auto position = geometry.getAttribute<float>("position");
+        const auto index = geometry.getIndex();
+
+        const auto vertexCount = static_cast<size_t>(position->count());
+        const auto indexCount = index ? static_cast<size_t>(index->count()) : vertexCount;
+
+        if (freeIds.empty() && geometries.size() == maxGeometryCount) {
+
+            throw std::runtime_error("BatchedMesh: maximum geometry count reached");
+        }
+
+        const auto vertexStart = vertices.allocate(vertexCount);
+        if (!vertexStart) {
+
+            throw std::runtime_error("BatchedMesh: not enough room for the vertices of the geometry");
+        }
+
+        const auto indexStart = indices.allocate(indexCount);
+        if (!indexStart) {
+
+            vertices.release(*vertexStart, vertexCount);
+            throw std::runtime_error("BatchedMesh: not enough room for the indices of the geometry");
+        }
+
+        int id;
+        if (!freeIds.empty()) {
+
+            id = freeIds.back();
+            freeIds.pop_back();
+
+        } else {
+
+            id = static_cast<int>(geometries.size());
+            geometries.emplace_back();
+        }
+
+        auto& g = geometries[id];
+        g.active = true;
+        g.visible = true;
+        g.vertexStart = *vertexStart;
+        g.vertexCount = vertexCount;
+        g.indexStart = *indexStart;
+        g.indexCount = indexCount;
+
+        // copy the vertices
+
+        for (const auto& [name, attribute] : geometry.getAttributes()) {
+
+            const auto source = attribute->typed<float>();
+            auto target = shared.getAttribute<float>(name);
+
+            const auto itemSize = static_cast<size_t>(source->itemSize());
+            const auto* data = source->itemData();
+            const auto stride = source->itemStride();
+            auto& array = target->array();
+
+            for (size_t i = 0; i < vertexCount; ++i) {
+
+                std::copy_n(data + i * stride, itemSize, array.data() + (g.vertexStart + i) * itemSize);
+            }
+
+            target->addUpdateRange(static_cast<int>(g.vertexStart * itemSize), static_cast<int>(vertexCount * itemSize));
+            target->needsUpdate();
+        }
+
+        auto batchId = shared.getAttribute<float>(batchIdName);
+        std::fill_n(batchId->array().data() + g.vertexStart, vertexCount, static_cast<float>(id));
+        batchId->addUpdateRange(static_cast<int>(g.vertexStart), static_cast<int>(vertexCount));
+        batchId->needsUpdate();
+
+        // copy the indices, offset to the vertices of the geometry in the shared buffers
+
+        auto sharedIndex = shared.getIndex();
+        auto& indexArray = sharedIndex->array();
+
+        for (size_t i = 0; i < indexCount; ++i) {
+
+            const auto local = index ? index->getX(static_cast<int>(i)) : static_cast<unsigned int>(i);
+            indexArray[g.indexStart + i] = static_cast<unsigned int>(g.vertexStart) + local;
+        }
+
+        sharedIndex->addUpdateRange(static_cast<int>(g.indexStart), static_cast<int>(indexCount));
+        sharedIndex->needsUpdate();
+
+        // bounds of the geometry in its own space
+
+        Box3 box;
+        for (size_t i = 0; i < vertexCount; ++i) {
+
+            box.expandByPoint(Vector3(position->getX(static_cast<int>(i)), position->getY(static_cast<int>(i)), position->getZ(static_cast<int>(i))));
+        }
+        box.getBoundingSphere(g.sphere);
+
+        setMatrixAt(id, Matrix4());
+
+        shared.boundingBox.reset();
+        shared.boundingSphere.reset();
+
+        visibleNeedsUpdate = true;
+
+        return id;
+    }
+
+    Geometry& get(int id) {
+
+        if (id < 0 || id >= static_cast<int>(geometries.size()) || !geometries[id].active) {
+
+            throw std::out_of_range("BatchedMesh: no geometry with id " + std::to_string(id));
+        }
+
+        return geometries[id];
+    }
+
+    void removeGeometry(int id) {
+
+        auto& g = get(id);
+
+        vertices.release(g.vertexStart, g.vertexCount);
+        indices.release(g.indexStart, g.indexCount);
+
+        g.active = false;
+        freeIds.push_back(id);
+
+        shared.boundingBox.reset();
+        shared.boundingSphere.reset();
+
+        visibleNeedsUpdate = true;
+    }
+
+    void setMatrixAt(int id, const Matrix4& matrix) {
+
+        matrix.toArray(texture->image->data<float>(), id * 16);
+        texture->needsUpdate();
+    }
+
+    void getMatrixAt(int id, Matrix4& matrix) {
+
+        matrix.fromArray(texture->image->data<float>(), id * 16);
+    }
+
+    // the world matrix of a geometry, in _batchWorldMatrix
+    void worldMatrix(int id) {
+
+        getMatrixAt(id, _batchMatrix);
+        _batchWorldMatrix.multiplyMatrices(*mesh.matrixWorld, _batchMatrix);
+    }
+
+    static void push(DrawRanges& ranges, const Geometry& g) {
+
+        ranges.starts.push_back(static_cast<int>(g.indexStart));
+        ranges.counts.push_back(static_cast<int>(g.indexCount));
+    }
+
+    static void clear(DrawRanges& ranges) {
+
+        ranges.starts.clear();
+        ranges.counts.clear();
+    }
+
+    void cull(const Frustum& frustum, const Camera& camera) {
+
+        clear(culled);
+
+        for (size_t id = 0; id < geometries.size(); ++id) {
+
+            const auto& g = geometries[id];
+            if (!g.active || !g.visible) continue;
+
+            worldMatrix(static_cast<int>(id));
+            _sphere.copy(g.sphere).applyMatrix4(_batchWorldMatrix);
+
+            if (frustum.intersectsSphere(_sphere)) push(culled, g);
+        }
+
+        culledCamera = camera.id;
+    }
+
+    const DrawRanges& drawRanges(const Camera& camera) {
+
+        if (mesh.perObjectFrustumCulled && culledCamera == camera.id) return culled;
+
+        if (visibleNeedsUpdate) {
+
+            clear(visible);
+
+            for (const auto& g : geometries) {
+
+                if (g.active && g.visible) push(visible, g);
+            }
+
+            visibleNeedsUpdate = false;
+        }
+
+        return visible;
+    }
+
+    void raycast(Raycaster& raycaster, std::vector<Intersection>& intersects) {
+
+        const auto first = intersects.size();
+
+        for (size_t id = 0; id < geometries.size(); ++id) {
+
+            const auto& g = geometries[id];
+            if (!g.active || !g.visible || g.indexCount == 0) continue;
+
+            worldMatrix(static_cast<int>(id));
+            _sphere.copy(g.sphere).applyMatrix4(_batchWorldMatrix);
+
+            if (!raycaster.ray.intersectsSphere(_sphere)) continue;
+
+            const auto hits = intersects.size();
+
+            mesh.raycastGeometry(raycaster, intersects, _batchWorldMatrix, DrawRange{static_cast<int>(g.indexStart), static_cast<int>(g.indexCount)});
+
+            for (auto i = hits; i < intersects.size(); ++i) {
+
+                intersects[i].batchId = static_cast<int>(id);
+            }
+        }
+
+        if (raycaster.firstHitOnly && intersects.size() > first + 1) {
+
+            const auto nearest = std::min_element(intersects.begin() + static_cast<std::ptrdiff_t>(first), intersects.end(), [](const auto& a, const auto& b) {
+                return a.distance < b.distance;
+            });
+
+            std::iter_swap(intersects.begin() + static_cast<std::ptrdiff_t>(first), nearest);
+            intersects.erase(intersects.begin() + static_cast<std::ptrdiff_t>(first) + 1, intersects.end());
+        }
+    }
+};
+
+BatchedMesh::BatchedMesh(size_t maxGeometryCount, size_t maxVertexCount, size_t maxIndexCount, std::shared_ptr<Material> material)
+    : Mesh(BufferGeometry::create(), std::move(material)),
+      pimpl_(std::make_unique<Impl>(*this, maxGeometryCount, maxVertexCount, maxIndexCount)) {
+
+    // culled per geometry instead
+    this->frustumCulled = false;
+}
+
+std::string BatchedMesh::type() const {
+
+    return "BatchedMesh";
+}
+
+int BatchedMesh::addGeometry(const BufferGeometry& geometry) {
+
+    return pimpl_->addGeometry(geometry);
+}
+
+void BatchedMesh::removeGeometry(int id) {
+
+    pimpl_->removeGeometry(id);
+}
+
+void BatchedMesh::setMatrixAt(int id, const Matrix4& matrix) {
+
+    pimpl_->get(id);
+    pimpl_->setMatrixAt(id, matrix);
+}
+
+void BatchedMesh::getMatrixAt(int id, Matrix4& matrix) const {
+
+    pimpl_->get(id);
+    pimpl_->getMatrixAt(id, matrix);
+}
+
+void BatchedMesh::setVisibleAt(int id, bool visible) {
+
+    auto& g = pimpl_->get(id);
+
+    if (g.visible != visible) {
+
+        g.visible = visible;
+        pimpl_->visibleNeedsUpdate = true;
+    }
+}
+
+bool BatchedMesh::getVisibleAt(int id) const {
+
+    return pimpl_->get(id).visible;
+}
+
+size_t BatchedMesh::geometryCount() const {
+
+    return pimpl_->geometries.size() - pimpl_->freeIds.size();
+}
+
+DataTexture& BatchedMesh::matricesTexture() const {
+
+    return *pimpl_->texture;
+}
+
+void BatchedMesh::cull(const Frustum& frustum, const Camera& camera) {
+
+    pimpl_->cull(frustum, camera);
+}
+
+const BatchedMesh::DrawRanges& BatchedMesh::drawRanges(const Camera& camera) {
+
+    return pimpl_->drawRanges(camera);
+}
+
+void BatchedMesh::raycast(Raycaster& raycaster, std::vector<Intersection>& intersects) {
+
+    if (!material()) return;
+
+    pimpl_->raycast(raycaster, intersects);
+}
+
+std::shared_ptr<BatchedMesh> BatchedMesh::create(size_t maxGeometryCount, size_t maxVertexCount, size_t maxIndexCount, std::shared_ptr<Material> material) {
+
+    return utils::makePooled<BatchedMesh>(maxGeometryCount, maxVertexCount, maxIndexCount, std::move(material));
+}
+
+BatchedMesh::~BatchedMesh() {
+
+    pimpl_->texture->dispose();
+    geometry_->dispose();
+}
@@ -3,6 +3,15 @@
 
 #include "threepp/objects/Group.hpp"
 
+#include "threepp/math/Sphere.hpp"
+#include "threepp/objects/Line.hpp"
+#include "threepp/objects/Mesh.hpp"
+#include "threepp/objects/Points.hpp"
+#include "threepp/objects/SkinnedMesh.hpp"
+#include "threepp/objects/Sprite.hpp"
+
+#include <typeinfo>
+
 using namespace threepp;
 
 std::string Group::type() const {
@@ -19,5 +28,72 @@ std::shared_ptr<Object3D> Group::clone(bool recursive) {
 
 std::shared_ptr<Group> Group::create() {
 
-    return std::make_shared<Group>();
+    return utils::makePooled<Group>();
+}
+
+void Group::updateSubtreeBounds() {
+
+    Box3 box;
+    bool cullable = true;
+
+    for (auto child : children) {
+
+        // nested groups are always updated, even if this one turns out not to be cullable
+        if (!expandBySubtree(*child, box)) cullable = false;
+    }
+
+    if (cullable) {
+
+        subtreeBounds_ = box;
+
+    } else {
+
+        subtreeBounds_.reset();
+    }
+}
+
+const std::optional<Box3>& Group::subtreeBounds() const {
+
+    return subtreeBounds_;
+}
+
+bool Group::expandBySubtree(Object3D& object, Box3& box) {
+
+    if (auto group = object.as<Group>()) {
+
+        group->updateSubtreeBounds();
+
+        if (!group->subtreeBounds_) return false;
+
+        box.union_(*group->subtreeBounds_);
+        return group->frustumCulled;
+    }
+
+    bool cullable = true;
+
+    if (object.is<Mesh>() || object.is<Line>() || object.is<Points>() || object.is<Sprite>()) {
+
+        // skinned meshes update their skeleton while being projected, even when culled
+        if (!object.frustumCulled || object.is<SkinnedMesh>()) {
+
+            cullable = false;
+
+        } else if (auto sphere = object.worldBoundingSphere()) {
+
+            box.expandByPoint(Vector3(sphere->center).subScalar(sphere->radius));
+            box.expandByPoint(Vector3(sphere->center).addScalar(sphere->radius));
+        }
+
+    } else if (typeid(object) != typeid(Object3D)) {
+
+        // lights, LODs, cameras etc. are handled while being projected
+        cullable = false;
+    }
+
+    for (auto child : object.children) {
+
+        if (!expandBySubtree(*child, box)) cullable = false;
+    }
+
+    return cullable;
 }
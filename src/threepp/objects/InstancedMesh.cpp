@@ -3,28 +3,147 @@
 
 #include "threepp/objects/InstancedMesh.hpp"
 
+#include "threepp/cameras/Camera.hpp"
 #include "threepp/core/Raycaster.hpp"
+#include "threepp/math/Frustum.hpp"
+#include "threepp/math/bvh.hpp"
+#include "threepp/math/simd.hpp"
+#include "threepp/utils/SmallVector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
 
 using namespace threepp;
 
 namespace {
 
-    Matrix4 _instanceLocalMatrix;
-    Matrix4 _instanceWorldMatrix;
+    thread_local Matrix4 _instanceLocalMatrix;
+    thread_local Matrix4 _instanceWorldMatrix;
+    thread_local Matrix4 _inverseMatrix;
+    thread_local Ray _ray;
+
+    constexpr uint32_t maxLeafSize = 4;
+
+    struct InstanceItem {
+        uint32_t instance;
+        Box3 box;
+        Vector3 centroid;
+    };
 
-    std::vector<Intersection> _instanceIntersects;
+    struct Candidate {
+        uint32_t instance;
+        float distance;
+    };
 
 }// namespace
 
+// hierarchy over the bounds of the instances, in the local space of the mesh
+struct InstancedMesh::InstanceBVH {
+
+    std::vector<InstanceItem> items;
+    std::vector<bvh::Node> nodes;
+
+    // state the hierarchy was built from
+    const BufferGeometry* geometry = nullptr;
+    Box3 geometryBox;
+    unsigned int version = 0;
+
+    // raycasts from several threads may find the hierarchy outdated at the same time
+    std::mutex mutex;
+
+    void update(const InstancedMesh& mesh, BufferGeometry& shared) {
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!shared.boundingBox) shared.computeBoundingBox();
+
+        const auto& box = *shared.boundingBox;
+        const auto version = mesh.instanceMatrix->version;
+
+        if (geometry == &shared && geometryBox.equals(box) && items.size() == mesh.count) {
+
+            if (this->version == version) return;
+
+            // the instances moved, keep the topology and refit the bounds
+            for (auto& item : items) bounds(mesh, box, item);
+            bvh::refit(nodes, items);
+
+            this->version = version;
+            return;
+        }
+
+        items.resize(mesh.count);
+        for (uint32_t i = 0; i < items.size(); ++i) {
+
+            items[i].instance = i;
+            bounds(mesh, box, items[i]);
+        }
+
+        nodes = bvh::Builder<InstanceItem>(items, maxLeafSize).build();
+
+        geometry = &shared;
+        geometryBox.copy(box);
+        this->version = version;
+    }
+
+    static void bounds(const InstancedMesh& mesh, const Box3& box, InstanceItem& item) {
+
+        mesh.getMatrixAt(item.instance, _instanceLocalMatrix);
+        item.box.copy(box).applyMatrix4(_instanceLocalMatrix);
+        item.box.getCenter(item.centroid);
+    }
+
+    // appends the instances whose bounds the ray hits, with the distance at which it enters them
+    void intersectRay(const Ray& ray, std::vector<Candidate>& candidates) const {
+
+        if (nodes.empty()) return;
+
+        const auto& origin = ray.origin;
+        const Vector3 invDir(1.f / ray.direction.x, 1.f / ray.direction.y, 1.f / ray.direction.z);
+        const auto far = std::numeric_limits<float>::infinity();
+
+        utils::SmallVector<uint32_t, 64> stack;
+        stack.push_back(0);
+
+        while (!stack.empty()) {
+
+            const auto& node = nodes[stack.back()];
+            stack.pop_back();
+
+            if (!bvh::intersectsBox(node.box, origin, invDir, 0, far)) continue;
+
+            if (node.isLeaf()) {
+
+                for (auto i = node.begin; i < node.end; ++i) {
+
+                    float entry;
+                    if (bvh::intersectsBox(items[i].box, origin, invDir, 0, far, entry)) {
+
+                        candidates.push_back({items[i].instance, entry});
+                    }
+                }
+                continue;
+            }
+
+            stack.push_back(node.right);
+            stack.push_back(node.left);
+        }
+    }
+};
+
 
 InstancedMesh::InstancedMesh(
         std::shared_ptr<BufferGeometry> geometry,
         std::shared_ptr<Material> material,
         size_t count)
     : Mesh(std::move(geometry), std::move(material)),
-      count(count), instanceMatrix(FloatBufferAttribute::create(std::vector<float>(count * 16), 16)) {
+      count(count), instanceMatrix(FloatBufferAttribute::create(std::vector<float>(count * 16), 16)),
+      instanceBVH_(std::make_unique<InstanceBVH>()) {
 
     this->frustumCulled = false;
+
+    levels_.emplace_back(geometry_, 0.f);
 }
 
 
@@ -33,6 +152,49 @@ std::string InstancedMesh::type() const {
     return "InstancedMesh";
 }
 
+size_t InstancedMesh::capacity() const {
+
+    return instanceMatrix->count();
+}
+
+void InstancedMesh::reserve(size_t capacity) {
+
+    if (capacity <= this->capacity()) return;
+
+    instanceMatrix->resize(static_cast<int>(capacity));
+    if (instanceColor) instanceColor->resize(static_cast<int>(capacity));
+}
+
+size_t InstancedMesh::addInstance(const Matrix4& matrix) {
+
+    if (count == capacity()) reserve(std::max<size_t>(16, capacity() * 2));
+
+    const auto index = count++;
+    setMatrixAt(index, matrix);
+    if (instanceColor) setColorAt(index, Color(1, 1, 1));
+
+    return index;
+}
+
+void InstancedMesh::removeInstance(size_t index) {
+
+    if (index >= count) return;
+
+    const auto last = --count;
+    if (index == last) return;
+
+    std::copy_n(instanceMatrix->array().data() + last * 16, 16, instanceMatrix->array().data() + index * 16);
+    instanceMatrix->addUpdateRange(static_cast<int>(index * 16), 16);
+    instanceMatrix->needsUpdate();
+
+    if (instanceColor) {
+
+        std::copy_n(instanceColor->array().data() + last * 3, 3, instanceColor->array().data() + index * 3);
+        instanceColor->addUpdateRange(static_cast<int>(index * 3), 3);
+        instanceColor->needsUpdate();
+    }
+}
+
 void InstancedMesh::getColorAt(size_t index, Color& color) const {
 
     color.fromArray(this->instanceColor->array(), index * 3);
@@ -47,59 +209,235 @@ void InstancedMesh::setColorAt(size_t index, const Color& color) {
 
     if (!this->instanceColor) {
 
-        this->instanceColor = FloatBufferAttribute ::create(std::vector<float>(count * 3), 3);
+        this->instanceColor = FloatBufferAttribute ::create(std::vector<float>(capacity() * 3), 3);
     }
 
     color.toArray(this->instanceColor->array(), index * 3);
+
+    this->instanceColor->addUpdateRange(static_cast<int>(index * 3), 3);
+    this->instanceColor->needsUpdate();
 }
 
 void InstancedMesh::setMatrixAt(size_t index, const Matrix4& matrix) const {
 
     matrix.toArray(this->instanceMatrix->array(), index * 16);
+
+    this->instanceMatrix->addUpdateRange(static_cast<int>(index * 16), 16);
+    this->instanceMatrix->needsUpdate();
+}
+
+void InstancedMesh::addLevel(std::shared_ptr<BufferGeometry> geometry, float distance) {
+
+    const auto position = std::upper_bound(levels_.begin() + 1, levels_.end(), distance, [](float distance, const Level& level) {
+        return distance < level.distance;
+    });
+
+    levels_.emplace(position, std::move(geometry), distance);
+}
+
+const std::vector<InstancedMesh::Level>& InstancedMesh::levels() const {
+
+    return levels_;
+}
+
+void InstancedMesh::cull(const Frustum& frustum, const Camera& camera) {
+
+    levels_.front().geometry = geometry_;
+
+    for (auto& level : levels_) {
+
+        if (!level.instanceMatrix) {
+
+            level.instanceMatrix = FloatBufferAttribute::create(std::vector<float>(capacity() * 16), 16);
+
+        } else if (level.instanceMatrix->count() < instanceMatrix->count()) {
+
+            level.instanceMatrix->resize(instanceMatrix->count());
+        }
+
+        if (instanceColor && !level.instanceColor) {
+
+            level.instanceColor = FloatBufferAttribute::create(std::vector<float>(capacity() * 3), 3);
+
+        } else if (instanceColor && level.instanceColor->count() < instanceColor->count()) {
+
+            level.instanceColor->resize(instanceColor->count());
+        }
+
+        level.count = 0;
+    }
+
+    culledCamera_ = camera.id;
+
+    if (!geometry_->boundingSphere) geometry_->computeBoundingSphere();
+    const auto& sphere = *geometry_->boundingSphere;
+
+    const auto& world = matrixWorld->elements;
+    const auto meshScale = matrixWorld->getMaxScaleOnAxis();
+    const auto& planes = frustum.planes();
+
+    Vector3 cameraPosition;
+    cameraPosition.setFromMatrixPosition(*camera.matrixWorld);
+
+    const auto& matrices = instanceMatrix->array();
+    const auto* colors = instanceColor ? instanceColor->array().data() : nullptr;
+
+    // bounding spheres of four instances at a time, tested against each plane at once
+
+    alignas(16) float x[4], y[4], z[4], radius[4], inside[4], distance[4];
+    float center[4];
+
+    for (size_t first = 0; first < count; first += 4) {
+
+        const auto lanes = std::min<size_t>(4, count - first);
+
+        for (size_t lane = 0; lane < 4; ++lane) {
+
+            if (lane >= lanes) {
+
+                x[lane] = y[lane] = z[lane] = radius[lane] = 0;
+                continue;
+            }
+
+            const auto* m = matrices.data() + (first + lane) * 16;
+
+            simd::store(center, simd::transformPoint(m, sphere.center.x, sphere.center.y, sphere.center.z));
+            simd::store(center, simd::transformPoint(world.data(), center[0], center[1], center[2]));
+
+            const auto sx = m[0] * m[0] + m[1] * m[1] + m[2] * m[2];
+            const auto sy = m[4] * m[4] + m[5] * m[5] + m[6] * m[6];
+            const auto sz = m[8] * m[8] + m[9] * m[9] + m[10] * m[10];
+
+            x[lane] = center[0];
+            y[lane] = center[1];
+            z[lane] = center[2];
+            radius[lane] = sphere.radius * meshScale * std::sqrt(std::max(sx, std::max(sy, sz)));
+        }
+
+        const auto cx = simd::load(x), cy = simd::load(y), cz = simd::load(z), r = simd::load(radius);
+
+        // smallest signed distance of the spheres to any plane, negative when outside
+        auto minimum = simd::splat(std::numeric_limits<float>::infinity());
+        for (const auto& plane : planes) {
+
+            const auto& n = plane.normal;
+            const auto d = simd::madd(simd::splat(n.z), cz, simd::madd(simd::splat(n.y), cy, simd::mul(simd::splat(n.x), cx)));
+            minimum = simd::min(minimum, simd::add(d, simd::add(r, simd::splat(plane.constant))));
+        }
+        simd::store(inside, minimum);
+
+        const auto dx = simd::add(cx, simd::splat(-cameraPosition.x));
+        const auto dy = simd::add(cy, simd::splat(-cameraPosition.y));
+        const auto dz = simd::add(cz, simd::splat(-cameraPosition.z));
+        simd::store(distance, simd::madd(dz, dz, simd::madd(dy, dy, simd::mul(dx, dx))));
+
+        for (size_t lane = 0; lane < lanes; ++lane) {
+
+            if (inside[lane] < 0) continue;
+
+            auto l = levels_.size() - 1;
+            while (l > 0 && distance[lane] < levels_[l].distance * levels_[l].distance) --l;
+
+            auto& level = levels_[l];
+            const auto instance = first + lane;
+
+            std::copy_n(matrices.data() + instance * 16, 16, level.instanceMatrix->array().data() + level.count * 16);
+            if (colors) std::copy_n(colors + instance * 3, 3, level.instanceColor->array().data() + level.count * 3);
+
+            ++level.count;
+        }
+    }
+
+    // upload the visible instances only
+
+    for (auto& level : levels_) {
+
+        if (level.count == 0) continue;
+
+        level.instanceMatrix->updateRange = {0, static_cast<int>(level.count * 16)};
+        level.instanceMatrix->needsUpdate();
+
+        if (colors) {
+
+            level.instanceColor->updateRange = {0, static_cast<int>(level.count * 3)};
+            level.instanceColor->needsUpdate();
+        }
+    }
+}
+
+const InstancedMesh::Level* InstancedMesh::culledLevel(const BufferGeometry* geometry, const Camera& camera) const {
+
+    if (!cullInstances || culledCamera_ != camera.id) return nullptr;
+
+    for (const auto& level : levels_) {
+
+        if (level.geometry.get() == geometry) return &level;
+    }
+
+    return nullptr;
 }
 
 void InstancedMesh::dispose() {
 
     if (!disposed) {
         disposed = true;
-        dispatchEvent("dispose", this);
+        dispatchEvent(events::dispose, this);
     }
 }
 
 void InstancedMesh::raycast(Raycaster& raycaster, std::vector<Intersection>& intersects) {
 
-    const auto& matrixWorld = this->matrixWorld;
-    const auto raycastTimes = this->count;
+    if (!material() || count == 0) return;
 
-    _mesh.setGeometry(geometry_);
-    _mesh.setMaterials(materials_);
+    instanceBVH_->update(*this, *geometry_);
 
-    if (!_mesh.material()) return;
+    // find the candidate instances in the local space of the mesh
 
-    for (int instanceId = 0; instanceId < raycastTimes; instanceId++) {
+    _inverseMatrix.copy(*matrixWorld).invert();
+    _ray.copy(raycaster.ray).applyMatrix4(_inverseMatrix);
 
-        // calculate the world matrix for each instance
+    thread_local std::vector<Candidate> candidates;
+    candidates.clear();
+    instanceBVH_->intersectRay(_ray, candidates);
 
-        this->getMatrixAt(instanceId, _instanceLocalMatrix);
+    // nearest first, so that firstHitOnly can stop at the first instance entered behind the closest hit
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.distance < b.distance;
+    });
 
-        _instanceWorldMatrix.multiplyMatrices(*matrixWorld, _instanceLocalMatrix);
+    const auto first = intersects.size();
+    auto closest = std::numeric_limits<float>::infinity();
+    Vector3 localPoint;
+
+    for (const auto& candidate : candidates) {
+
+        if (raycaster.firstHitOnly && candidate.distance > closest) break;
 
-        // the mesh represents this single instance
+        this->getMatrixAt(candidate.instance, _instanceLocalMatrix);
+        _instanceWorldMatrix.multiplyMatrices(*matrixWorld, _instanceLocalMatrix);
 
-        _mesh.matrixWorld->copy(_instanceWorldMatrix);
+        const auto hits = intersects.size();
 
-        _mesh.raycast(raycaster, _instanceIntersects);
+        raycastGeometry(raycaster, intersects, _instanceWorldMatrix);
 
-        // process the result of raycast
+        for (auto i = hits; i < intersects.size(); i++) {
 
-        for (auto& intersect : _instanceIntersects) {
+            auto& intersect = intersects[i];
+            intersect.instanceId = static_cast<int>(candidate.instance);
 
-            intersect.instanceId = instanceId;
-            intersect.object = this;
-            intersects.emplace_back(intersect);
+            localPoint.copy(intersect.point).applyMatrix4(_inverseMatrix);
+            closest = std::min(closest, _ray.origin.distanceTo(localPoint));
         }
+    }
+
+    if (raycaster.firstHitOnly && intersects.size() > first + 1) {
+
+        const auto nearest = std::min_element(intersects.begin() + static_cast<std::ptrdiff_t>(first), intersects.end(), [](const auto& a, const auto& b) {
+            return a.distance < b.distance;
+        });
 
-        _instanceIntersects.clear();
+        std::iter_swap(intersects.begin() + static_cast<std::ptrdiff_t>(first), nearest);
+        intersects.erase(intersects.begin() + static_cast<std::ptrdiff_t>(first) + 1, intersects.end());
     }
 }
 
@@ -112,5 +450,5 @@ std::shared_ptr<InstancedMesh> InstancedMesh::create(
         std::shared_ptr<Material> material,
         size_t count) {
 
-    return std::make_shared<InstancedMesh>(std::move(geometry), std::move(material), count);
+    return utils::makePooled<InstancedMesh>(std::move(geometry), std::move(material), count);
 }
@@ -14,7 +14,7 @@ std::string LOD::type() const {
 
 std::shared_ptr<LOD> LOD::create() {
 
-    return std::make_shared<LOD>();
+    return utils::makePooled<LOD>();
 }
 
 LOD& LOD::addLevel(Object3D& object, float distance) {
@@ -11,9 +11,9 @@ using namespace threepp;
 
 namespace {
 
-    Sphere _sphere;
-    Matrix4 _inverseMatrix;
-    Ray _ray;
+    thread_local Sphere _sphere;
+    thread_local Matrix4 _inverseMatrix;
+    thread_local Ray _ray;
 
 }// namespace
 
@@ -51,7 +51,7 @@ std::shared_ptr<Object3D> Line::clone(bool recursive) {
 
 std::shared_ptr<Line> Line::create(const std::shared_ptr<BufferGeometry>& geometry, const std::shared_ptr<Material>& material) {
 
-    return std::make_shared<Line>(geometry, (material));
+    return utils::makePooled<Line>(geometry, (material));
 }
 
 void Line::computeLineDistances() {
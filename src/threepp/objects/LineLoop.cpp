@@ -26,5 +26,5 @@ std::shared_ptr<Object3D> LineLoop::clone(bool recursive) {
 
 std::shared_ptr<LineLoop> LineLoop::create(const std::shared_ptr<BufferGeometry>& geometry, const std::shared_ptr<Material>& material) {
 
-    return std::make_shared<LineLoop>(geometry, (material));
+    return utils::makePooled<LineLoop>(geometry, (material));
 }
@@ -57,5 +57,5 @@ std::shared_ptr<LineSegments> LineSegments::create(
         const std::shared_ptr<BufferGeometry>& geometry,
         const std::shared_ptr<Material>& material) {
 
-    return std::make_shared<LineSegments>(geometry, (material));
+    return utils::makePooled<LineSegments>(geometry, (material));
 }
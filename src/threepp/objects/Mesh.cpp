@@ -5,6 +5,7 @@
 
 #include "threepp/core/Face3.hpp"
 #include "threepp/core/Raycaster.hpp"
+#include "threepp/core/TriangleBVH.hpp"
 
 #include "threepp/materials/MeshBasicMaterial.hpp"
 
@@ -19,10 +20,10 @@ using namespace threepp;
 namespace {
 
     std::optional<Intersection> checkIntersection(
-            Object3D* object, Material* material, Raycaster& raycaster, Ray& ray,
+            Object3D* object, const Matrix4& matrixWorld, Material* material, Raycaster& raycaster, Ray& ray,
             const Vector3& pA, const Vector3& pB, const Vector3& pC, Vector3& point) {
 
-        static Vector3 _intersectionPointWorld{};
+        thread_local Vector3 _intersectionPointWorld{};
 
         if (material->side == Side::Back) {
 
@@ -36,7 +37,7 @@ namespace {
         if (point.isNan()) return std::nullopt;
 
         _intersectionPointWorld.copy(point);
-        _intersectionPointWorld.applyMatrix4(*object->matrixWorld);
+        _intersectionPointWorld.applyMatrix4(matrixWorld);
 
         const auto distance = raycaster.ray.origin.distanceTo(_intersectionPointWorld);
 
@@ -51,7 +52,7 @@ namespace {
     }
 
     std::optional<Intersection> checkBufferGeometryIntersection(
-            Object3D* object, Material* material,
+            Object3D* object, const Matrix4& matrixWorld, Material* material,
             Raycaster& raycaster, Ray& ray,
             const FloatBufferAttribute& position,
             const std::vector<std::shared_ptr<BufferAttribute>>* morphPosition,
@@ -60,10 +61,10 @@ namespace {
             const FloatBufferAttribute* uv2,
             unsigned int a, unsigned int b, unsigned int c) {
 
-        static Vector3 _vA{};
-        static Vector3 _vB{};
-        static Vector3 _vC{};
-        static Vector3 _intersectionPoint{};
+        thread_local Vector3 _vA{};
+        thread_local Vector3 _vB{};
+        thread_local Vector3 _vC{};
+        thread_local Vector3 _intersectionPoint{};
 
         position.setFromBufferAttribute(_vA, a);
         position.setFromBufferAttribute(_vB, b);
@@ -129,13 +130,13 @@ namespace {
             skinned->boneTransform(c, _vC);
         }
 
-        auto intersection = checkIntersection(object, material, raycaster, ray, _vA, _vB, _vC, _intersectionPoint);
+        auto intersection = checkIntersection(object, matrixWorld, material, raycaster, ray, _vA, _vB, _vC, _intersectionPoint);
 
         if (intersection) {
 
-            static Vector2 _uvA{};
-            static Vector2 _uvB{};
-            static Vector2 _uvC{};
+            thread_local Vector2 _uvA{};
+            thread_local Vector2 _uvB{};
+            thread_local Vector2 _uvC{};
 
             if (uv) {
 
@@ -196,25 +197,30 @@ std::vector<Material*> Mesh::materials() {
 
 void Mesh::raycast(Raycaster& raycaster, std::vector<Intersection>& intersects) {
 
+    raycastGeometry(raycaster, intersects, *matrixWorld);
+}
+
+void Mesh::raycastGeometry(Raycaster& raycaster, std::vector<Intersection>& intersects, const Matrix4& matrixWorld, std::optional<DrawRange> range) {
+
     if (material() == nullptr) return;
 
-    static Sphere _sphere{};
+    thread_local Sphere _sphere{};
 
     // Checking boundingSphere distance to ray
 
     if (!geometry_->boundingSphere) geometry_->computeBoundingSphere();
 
     _sphere.copy(*geometry_->boundingSphere);
-    _sphere.applyMatrix4(*matrixWorld);
+    _sphere.applyMatrix4(matrixWorld);
 
     if (!raycaster.ray.intersectsSphere(_sphere)) return;
 
     //
 
-    static Ray _ray{};
-    static Matrix4 _inverseMatrix{};
+    thread_local Ray _ray{};
+    thread_local Matrix4 _inverseMatrix{};
 
-    _inverseMatrix.copy(*matrixWorld).invert();
+    _inverseMatrix.copy(matrixWorld).invert();
     _ray.copy(raycaster.ray).applyMatrix4(_inverseMatrix);
 
     // Check boundingBox before continuing
@@ -224,126 +230,112 @@ void Mesh::raycast(Raycaster& raycaster, std::vector<Intersection>& intersects)
         if (!_ray.intersectsBox(*geometry_->boundingBox)) return;
     }
 
-    std::optional<Intersection> intersection;
-
     const auto index = geometry_->getIndex();
     const auto position = geometry_->getAttribute<float>("position");
     const auto morphPosition = geometry_->getMorphAttribute("position");
     const auto morphTargetsRelative = geometry_->morphTargetsRelative;
     const auto uv = geometry_->getAttribute<float>("uv");
     const auto uv2 = geometry_->getAttribute<float>("uv2");
-    const auto groups = geometry_->groups;
-    const auto drawRange = geometry_->drawRange;
-
-    if (index != nullptr) {
-
-        // indexed buffer geometry
+    const auto& groups = geometry_->groups;
+    const auto drawRange = range.value_or(geometry_->drawRange);
 
-        if (numMaterials() > 1) {
+    if (position == nullptr) return;
 
-            for (auto& group : groups) {
+    const auto count = index ? index->count() : position->count();
+    const auto first = intersects.size();
 
-                auto groupMaterial = materials_[group.materialIndex].get();
+    // tests the triangle starting at position j of the index, or of the position attribute for non-indexed geometry
+    const auto intersectTriangle = [&](int j, Material* material, std::optional<unsigned int> materialIndex) {
+        const auto a = index ? index->getX(j) : j;
+        const auto b = index ? index->getX(j + 1) : j + 1;
+        const auto c = index ? index->getX(j + 2) : j + 2;
 
-                const auto start = std::max(group.start, drawRange.start);
-                const auto end = std::min((group.start + group.count), (drawRange.start + drawRange.count));
+        auto intersection = checkBufferGeometryIntersection(
+                this, matrixWorld, material, raycaster, _ray, *position,
+                morphPosition, morphTargetsRelative, uv, uv2, a, b, c);
 
-                for (int j = start, jl = end; j < jl; j += 3) {
+        if (!intersection) return false;
 
-                    const auto a = index->getX(j);
-                    const auto b = index->getX(j + 1);
-                    const auto c = index->getX(j + 2);
+        intersection->faceIndex = j / 3;// triangle number in buffer semantics
+        if (materialIndex) intersection->face->materialIndex = *materialIndex;
+        intersects.emplace_back(*intersection);
 
-                    intersection = checkBufferGeometryIntersection(
-                            this, groupMaterial, raycaster, _ray, *position,
-                            morphPosition, morphTargetsRelative, uv, uv2, a, b, c);
+        return true;
+    };
 
-                    if (intersection) {
+    // the hierarchy holds rest positions, so it is not used for morphed or skinned meshes
+    const auto& tree = geometry_->boundsTree;
+    const bool useTree = tree && tree->matches(*geometry_) && (!morphPosition || morphPosition->empty()) && !is<SkinnedMesh>();
 
-                        intersection->faceIndex = j / 3;// triangle number in indexed buffer semantics
-                        intersection->face->materialIndex = group.materialIndex;
-                        intersects.emplace_back(*intersection);
-                    }
-                }
-            }
+    if (useTree) {
 
-        } else {
+        auto far = std::numeric_limits<float>::infinity();
+        Vector3 localPoint;
 
-            const int start = std::max(0, drawRange.start);
-            const int end = std::min(index->count(), (drawRange.start + drawRange.count));
+        tree->intersectRay(_ray, [&](unsigned int triangle) {
+            const auto j = static_cast<int>(triangle * 3);
+            if (j < drawRange.start || j >= drawRange.start + drawRange.count) return far;
 
-            for (int i = start, il = end; i < il; i += 3) {
+            bool hit = false;
 
-                const auto a = index->getX(i);
-                const auto b = index->getX(i + 1);
-                const auto c = index->getX(i + 2);
+            if (numMaterials() > 1) {
 
-                intersection = checkBufferGeometryIntersection(
-                        this, material(), raycaster, _ray, *position,
-                        morphPosition, morphTargetsRelative, uv, uv2, a, b, c);
+                for (const auto& group : groups) {
 
-                if (intersection) {
+                    if (j < group.start || j >= group.start + group.count) continue;
 
-                    intersection->faceIndex = i / 3;// triangle number in indexed buffer semantics
-                    intersects.emplace_back(*intersection);
+                    hit = intersectTriangle(j, materials_[group.materialIndex].get(), group.materialIndex) || hit;
                 }
-            }
-        }
 
-    } else if (position != nullptr) {
+            } else {
 
-        // non-indexed buffer geometry
+                hit = intersectTriangle(j, material(), std::nullopt);
+            }
 
-        if (numMaterials() > 1) {
+            if (hit && raycaster.firstHitOnly) {
 
-            for (auto& group : groups) {
+                // order along the local ray matches the order of world distances
+                localPoint.copy(intersects.back().point).applyMatrix4(_inverseMatrix);
+                far = std::min(far, _ray.origin.distanceTo(localPoint));
+            }
 
-                auto groupMaterial = materials_[group.materialIndex].get();
+            return far;
+        });
 
-                const auto start = std::max(group.start, drawRange.start);
-                const auto end = std::min((group.start + group.count), (drawRange.start + drawRange.count));
+    } else if (numMaterials() > 1) {
 
-                for (int j = start, jl = end; j < jl; j += 3) {
+        for (const auto& group : groups) {
 
-                    const auto a = j;
-                    const auto b = j + 1;
-                    const auto c = j + 2;
+            auto groupMaterial = materials_[group.materialIndex].get();
 
-                    intersection = checkBufferGeometryIntersection(
-                            this, groupMaterial, raycaster, _ray, *position,
-                            morphPosition, morphTargetsRelative, uv, uv2, a, b, c);
+            const auto start = std::max(group.start, drawRange.start);
+            const auto end = std::min(std::min(group.start + group.count, drawRange.start + drawRange.count), count);
 
-                    if (intersection) {
+            for (int j = start; j < end; j += 3) {
 
-                        intersection->faceIndex = j / 3;// triangle number in non-indexed buffer semantics
-                        intersection->face->materialIndex = group.materialIndex;
-                        intersects.emplace_back(*intersection);
-                    }
-                }
+                intersectTriangle(j, groupMaterial, group.materialIndex);
             }
+        }
 
-        } else {
+    } else {
 
-            const int start = std::max(0, drawRange.start);
-            const int end = std::min(position->count(), (drawRange.start + drawRange.count));
+        const int start = std::max(0, drawRange.start);
+        const int end = std::min(count, (drawRange.start + drawRange.count));
 
-            for (int i = start, il = end; i < il; i += 3) {
+        for (int i = start; i < end; i += 3) {
 
-                const int a = i;
-                const int b = i + 1;
-                const int c = i + 2;
+            intersectTriangle(i, material(), std::nullopt);
+        }
+    }
 
-                intersection = checkBufferGeometryIntersection(
-                        this, material(), raycaster, _ray, *position,
-                        morphPosition, morphTargetsRelative, uv, uv2, a, b, c);
+    if (raycaster.firstHitOnly && intersects.size() > first + 1) {
 
-                if (intersection) {
+        const auto closest = std::min_element(intersects.begin() + static_cast<std::ptrdiff_t>(first), intersects.end(), [](const auto& a, const auto& b) {
+            return a.distance < b.distance;
+        });
 
-                    intersection->faceIndex = i / 3;// triangle number in non-indexed buffer semantics
-                    intersects.emplace_back(*intersection);
-                }
-            }
-        }
+        std::iter_swap(intersects.begin() + static_cast<std::ptrdiff_t>(first), closest);
+        intersects.erase(intersects.begin() + static_cast<std::ptrdiff_t>(first) + 1, intersects.end());
     }
 }
 
@@ -397,10 +389,10 @@ size_t Mesh::numMaterials() const {
 
 std::shared_ptr<Mesh> Mesh::create(std::shared_ptr<BufferGeometry> geometry, std::shared_ptr<Material> material) {
 
-    return std::make_shared<Mesh>(std::move(geometry), std::move(material));
+    return utils::makePooled<Mesh>(std::move(geometry), std::move(material));
 }
 
 std::shared_ptr<Mesh> Mesh::create(std::shared_ptr<BufferGeometry> geometry, std::vector<std::shared_ptr<Material>> materials) {
 
-    return std::make_shared<Mesh>(std::move(geometry), std::move(materials));
+    return utils::makePooled<Mesh>(std::move(geometry), std::move(materials));
 }
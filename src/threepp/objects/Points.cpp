@@ -1,5 +1,6 @@
 
 #include "threepp/objects/Points.hpp"
+#include "threepp/core/PointOctree.hpp"
 #include "threepp/core/Raycaster.hpp"
 
 #include <cmath>
@@ -8,10 +9,10 @@ using namespace threepp;
 
 namespace {
 
-    Sphere _sphere;
-    Vector3 _position;
-    Matrix4 _inverseMatrix;
-    Ray _ray;
+    thread_local Sphere _sphere;
+    thread_local Vector3 _position;
+    thread_local Matrix4 _inverseMatrix;
+    thread_local Ray _ray;
 
     void testPoint(
             const Vector3& point,
@@ -110,7 +111,23 @@ void Points::raycast(Raycaster& raycaster, std::vector<Intersection>& intersects
     const auto index = geometry->getIndex();
     const auto positionAttribute = geometry->getAttribute<float>("position");
 
-    if (index) {
+    // the octree holds vertices, so it is only used for non-indexed geometry
+    const auto& tree = geometry->pointsTree;
+
+    if (!index && tree && positionAttribute && tree->matches(*positionAttribute)) {
+
+        const auto start = static_cast<unsigned int>(std::max(0, drawRange.start));
+        const auto end = static_cast<unsigned int>(std::min(positionAttribute->count(), (drawRange.start + drawRange.count)));
+
+        tree->intersectRay(_ray, localThreshold, [&](unsigned int i) {
+            if (i < start || i >= end) return;
+
+            positionAttribute->setFromBufferAttribute(_position, i);
+
+            testPoint(_position, i, localThresholdSq, *matrixWorld, raycaster, intersects, this);
+        });
+
+    } else if (index) {
 
         const auto start = std::max(0, drawRange.start);
         const auto end = std::min(index->count(), (drawRange.start + drawRange.count));
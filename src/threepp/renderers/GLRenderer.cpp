@@ -4,13 +4,16 @@
 #include "threepp/renderers/GLRenderTarget.hpp"
 
 #include "threepp/renderers/gl/GLAttributes.hpp"
+#include "threepp/renderers/gl/GLAutoInstancing.hpp"
 #include "threepp/renderers/gl/GLBackground.hpp"
 #include "threepp/renderers/gl/GLBindingStates.hpp"
 #include "threepp/renderers/gl/GLBufferRenderer.hpp"
 #include "threepp/renderers/gl/GLGeometries.hpp"
 #include "threepp/renderers/gl/GLMaterials.hpp"
+#include "threepp/renderers/gl/GLMemory.hpp"
 #include "threepp/renderers/gl/GLMorphTargets.hpp"
 #include "threepp/renderers/gl/GLObjects.hpp"
+#include "threepp/renderers/gl/GLPicking.hpp"
 #include "threepp/renderers/gl/GLPrograms.hpp"
 #include "threepp/renderers/gl/GLRenderLists.hpp"
 #include "threepp/renderers/gl/GLRenderStates.hpp"
@@ -22,6 +25,7 @@
 #include "threepp/materials/RawShaderMaterial.hpp"
 #include "threepp/math/Frustum.hpp"
 
+#include "threepp/objects/BatchedMesh.hpp"
 #include "threepp/objects/Group.hpp"
 #include "threepp/objects/InstancedMesh.hpp"
 #include "threepp/objects/LOD.hpp"
@@ -38,6 +42,7 @@
 #include <GLES3/gl32.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 
 
@@ -54,7 +59,7 @@ struct GLRenderer::Impl {
 
             auto material = static_cast<Material*>(event.target);
 
-            material->removeEventListener("dispose", this);
+            material->removeEventListener(events::dispose, this);
 
             scope_->deallocateMaterial(material);
         }
@@ -104,6 +109,14 @@ struct GLRenderer::Impl {
 
     Frustum _frustum;
 
+    // static objects of the current scene
+
+    SceneBVH* _bvh = nullptr;
+    std::vector<Object3D*> _bvhObjects;
+
+    // set during the picking pass, which must not request texture levels
+    bool _picking = false;
+
     // clipping
 
     bool _clippingEnabled = false;
@@ -115,6 +128,15 @@ struct GLRenderer::Impl {
 
     Vector3 _vector3;
 
+    // texture streaming
+
+    Sphere _streamingSphere;
+    std::optional<size_t> _lastStreamingFrame;
+
+    // memory budget
+
+    std::optional<size_t> _lastEvictionFrame;
+
     gl::GLInfo _info;
 
     gl::GLBackground background;
@@ -135,6 +157,8 @@ struct GLRenderer::Impl {
     std::unique_ptr<gl::GLIndexedBufferRenderer> indexedBufferRenderer;
 
     gl::GLShadowMap shadowMap;
+    gl::GLPicking picking;
+    gl::GLAutoInstancing autoInstancing;
 
     Impl(GLRenderer& scope, WindowSize size, const GLRenderer::Parameters& parameters)
         : scope(scope), _size(size),
@@ -142,6 +166,7 @@ struct GLRenderer::Impl {
           bufferRenderer(std::make_unique<gl::GLBufferRenderer>(_info)),
           indexedBufferRenderer(std::make_unique<gl::GLIndexedBufferRenderer>(_info)),
           clipping(properties),
+          attributes(_info),
           bindingStates(attributes),
           geometries(attributes, _info, bindingStates),
           textures(state, properties, _info),
@@ -184,14 +209,24 @@ struct GLRenderer::Impl {
 
     void render(Scene* scene, Camera* camera) {
 
+        if (renderStateStack.empty()) picking.poll(false);
+
         // update scene graph
 
+        const auto matrixWorldUpdates = Object3D::matrixWorldUpdates();
+
         if (scene->autoUpdate) scene->updateMatrixWorld();
 
         // update camera matrices and frustum
 
         if (camera->parent == nullptr) camera->updateMatrixWorld();
 
+        _info.render.matrices = Object3D::matrixWorldUpdates() - matrixWorldUpdates;
+
+        _bvh = scene->bvh.get();
+
+        if (scope.groupCulling) updateGroupBounds(*scene, _bvh);
+
         //
         //    if ( scene.isScene === true ) scene.onBeforeRender( _this, scene, camera, _currentRenderTarget );
 
@@ -211,7 +246,19 @@ struct GLRenderer::Impl {
 
         renderListStack.emplace_back(currentRenderList);
 
+        textures.streamingEnabled = scope.textureStreaming;
+        textures.streamingBudget = scope.textureStreamingBudget;
+
         projectObject(scene, camera, 0, scope.sortObjects);
+        if (_bvh) projectStatic(scene, camera, scope.sortObjects);
+
+        if (scope.autoInstancing) {
+
+            for (auto mesh : autoInstancing.merge(*currentRenderList)) {
+
+                objects.update(mesh);
+            }
+        }
 
         currentRenderList->finish();
 
@@ -228,7 +275,7 @@ struct GLRenderer::Impl {
 
         shadowMap.render(scope, shadowsArray, scene, camera);
 
-        currentRenderState->setupLights();
+        currentRenderState->setupLights(scope.clusteredLighting);
         currentRenderState->setupLightsView(camera);
 
         if (_clippingEnabled) clipping.endShadows();
@@ -258,6 +305,20 @@ struct GLRenderer::Impl {
             textures.updateRenderTargetMipmap(_currentRenderTarget);
         }
 
+        // stream pending texture levels once per frame
+
+        if (scope.textureStreaming && _lastStreamingFrame != _info.render.frame) {
+
+            _lastStreamingFrame = _info.render.frame;
+            textures.updateStreaming();
+        }
+
+        if (scope.memoryBudget && _lastEvictionFrame != _info.render.frame) {
+
+            _lastEvictionFrame = _info.render.frame;
+            enforceMemoryBudget(*scope.memoryBudget);
+        }
+
         //
 
         //    if ( scene.isScene === true ) scene.onAfterRender( _this, scene, camera );
@@ -348,7 +409,18 @@ struct GLRenderer::Impl {
             }
         }
 
-        bindingStates.setup(object, material, program, geometry, index);
+        // culled instances are drawn from their compacted level, other passes draw all of them
+        const InstancedMesh::Level* level = nullptr;
+        if (auto im = object->as<InstancedMesh>(); im && !_picking) level = im->culledLevel(geometry, *camera);
+
+        if (level) {
+
+            bindingStates.setup(object, material, program, geometry, index, level->instanceMatrix.get(), level->instanceColor.get());
+
+        } else {
+
+            bindingStates.setup(object, material, program, geometry, index);
+        }
 
         gl::BufferRenderer* renderer = bufferRenderer.get();
 
@@ -422,9 +494,32 @@ struct GLRenderer::Impl {
             renderer->setMode(GL_TRIANGLES);
         }
 
-        if (auto im = object->as<InstancedMesh>()) {
+        if (auto batched = object->as<BatchedMesh>()) {
+
+            const auto& ranges = batched->drawRanges(*camera);
+
+            if (rangeFactor == 1) {
+
+                renderer->renderMultiDraw(ranges.starts, ranges.counts);
+
+            } else {
+
+                thread_local BatchedMesh::DrawRanges wireframeRanges;
+                wireframeRanges.starts.resize(ranges.starts.size());
+                wireframeRanges.counts.resize(ranges.counts.size());
+
+                for (size_t i = 0; i < ranges.starts.size(); ++i) {
+
+                    wireframeRanges.starts[i] = ranges.starts[i] * rangeFactor;
+                    wireframeRanges.counts[i] = ranges.counts[i] * rangeFactor;
+                }
+
+                renderer->renderMultiDraw(wireframeRanges.starts, wireframeRanges.counts);
+            }
+
+        } else if (auto im = object->as<InstancedMesh>()) {
 
-            renderer->renderInstances(drawStart, drawCount, im->count);
+            renderer->renderInstances(drawStart, drawCount, level ? level->count : im->count);
 
         } else if (auto g = dynamic_cast<InstancedBufferGeometry*>(geometry)) {
 
@@ -438,14 +533,39 @@ struct GLRenderer::Impl {
         }
     }
 
+    static void updateGroupBounds(Object3D& root, const SceneBVH* bvh) {
+
+        // nested groups are updated by their outermost group
+        root.traverse([bvh](Object3D& object) {
+            if (bvh && bvh->coversSubtree(object)) return TraverseResult::SkipChildren;
+
+            if (auto group = object.as<Group>()) {
+
+                group->updateSubtreeBounds();
+                return TraverseResult::SkipChildren;
+            }
+
+            return TraverseResult::Continue;
+        });
+    }
+
     void projectObject(Object3D* object, Camera* camera, unsigned int groupOrder, bool sortObjects) {
         if (!object->visible) return;
 
+        // static subtrees are projected from the bvh query
+        if (_bvh && _bvh->coversSubtree(*object)) return;
+
         bool visible = object->layers.test(camera->layers);
 
         if (visible) {
 
-            if (object->is<Group>()) {
+            if (auto group = object->as<Group>()) {
+
+                if (scope.groupCulling && group->frustumCulled) {
+
+                    const auto& bounds = group->subtreeBounds();
+                    if (bounds && !_frustum.intersectsBox(*bounds)) return;
+                }
 
                 groupOrder = object->renderOrder;
 
@@ -478,6 +598,13 @@ struct GLRenderer::Impl {
                     if (material->visible) {
 
                         currentRenderList->push(object, geometry, material.get(), groupOrder, _vector3.z, std::nullopt);
+
+                        if (scope.textureStreaming && !_picking) {
+
+                            _streamingSphere.center.set(0, 0, 0);
+                            _streamingSphere.radius = 0.7071067811865476f;
+                            requestStreamingLevels(object, {material.get()}, camera);
+                        }
                     }
                 }
 
@@ -494,42 +621,164 @@ struct GLRenderer::Impl {
                     }
                 }
 
-                if (!object->frustumCulled || _frustum.intersectsObject(*object)) {
+                if (_bvh && _bvh->contains(*object)) {
 
-                    if (sortObjects) {
+                    // projected from the bvh query
 
-                        _vector3.setFromMatrixPosition(*object->matrixWorld)
-                                .applyMatrix4(_projScreenMatrix);
-                    }
+                } else if (!object->frustumCulled || _frustum.intersectsObject(*object)) {
 
-                    auto geometry = objects.update(object);
-                    const auto& materials = object->materials();
+                    pushRenderable(object, camera, groupOrder, sortObjects);
+                }
+            }
+        }
+
+        for (const auto& child : object->children) {
 
-                    if (materials.size() > 1) {
+            projectObject(child, camera, groupOrder, sortObjects);
+        }
+    }
 
-                        const auto& groups = geometry->groups;
+    // static objects that intersect the frustum, pushed as projectObject would have
+    void projectStatic(Scene* scene, Camera* camera, bool sortObjects) {
 
-                        for (const auto& group : groups) {
+        _bvhObjects.clear();
+        _bvh->intersectFrustum(_frustum, _bvhObjects);
 
-                            Material* groupMaterial = materials.at(group.materialIndex);
+        for (auto object : _bvhObjects) {
 
-                            if (groupMaterial && groupMaterial->visible) {
+            if (!object->layers.test(camera->layers)) continue;
 
-                                currentRenderList->push(object, geometry, groupMaterial, groupOrder, _vector3.z, group);
-                            }
-                        }
+            std::optional<unsigned int> groupOrder;
 
-                    } else if (materials.front()->visible) {
+            auto ancestor = object->parent;
+            while (ancestor && ancestor != scene && ancestor->visible) {
 
-                        currentRenderList->push(object, geometry, materials.front(), groupOrder, _vector3.z, std::nullopt);
-                    }
+                if (!groupOrder && ancestor->is<Group>() && ancestor->layers.test(camera->layers)) {
+
+                    groupOrder = ancestor->renderOrder;
                 }
+
+                ancestor = ancestor->parent;
             }
+
+            if (ancestor != scene || !object->visible || !scene->visible) continue;
+
+            pushRenderable(object, camera, groupOrder.value_or(0), sortObjects);
         }
+    }
 
-        for (const auto& child : object->children) {
+    void pushRenderable(Object3D* object, Camera* camera, unsigned int groupOrder, bool sortObjects) {
 
-            projectObject(child, camera, groupOrder, sortObjects);
+        if (sortObjects) {
+
+            _vector3.setFromMatrixPosition(*object->matrixWorld)
+                    .applyMatrix4(_projScreenMatrix);
+        }
+
+        auto im = object->as<InstancedMesh>();
+        const auto cullInstances = im && im->cullInstances && !_picking;
+        if (cullInstances) im->cull(_frustum, *camera);
+
+        if (auto batched = object->as<BatchedMesh>(); batched && batched->perObjectFrustumCulled && !_picking) {
+
+            batched->cull(_frustum, *camera);
+        }
+
+        auto geometry = objects.update(object);
+        const auto& materials = object->materials();
+
+        if (cullInstances) {
+
+            // a render item per level with visible instances
+            for (const auto& level : im->levels()) {
+
+                if (level.count > 0) pushGeometry(object, level.geometry.get(), materials, groupOrder);
+            }
+
+        } else {
+
+            pushGeometry(object, geometry, materials, groupOrder);
+        }
+
+        if (scope.textureStreaming && !_picking) {
+
+            if (!geometry->boundingSphere) geometry->computeBoundingSphere();
+            _streamingSphere.copy(*geometry->boundingSphere);
+            requestStreamingLevels(object, materials, camera);
+        }
+    }
+
+    void pushGeometry(Object3D* object, BufferGeometry* geometry, const std::vector<Material*>& materials, unsigned int groupOrder) {
+
+        if (materials.size() > 1) {
+
+            const auto& groups = geometry->groups;
+
+            for (const auto& group : groups) {
+
+                Material* groupMaterial = materials.at(group.materialIndex);
+
+                if (groupMaterial && groupMaterial->visible) {
+
+                    currentRenderList->push(object, geometry, groupMaterial, groupOrder, _vector3.z, group);
+                }
+            }
+
+        } else if (materials.front()->visible) {
+
+            currentRenderList->push(object, geometry, materials.front(), groupOrder, _vector3.z, std::nullopt);
+        }
+    }
+
+    void enforceMemoryBudget(size_t budget) {
+
+        const auto& memory = _info.memory;
+
+        if (memory.totalBytes() <= budget) return;
+        if (_info.render.frame < scope.evictAfterFrames) return;
+
+        const auto frame = _info.render.frame - scope.evictAfterFrames + 1;
+
+        // least recently used first, whatever the resource kind
+        std::vector<gl::EvictionCandidate> candidates;
+        for (const auto& [lastUsedFrame, texture] : textures.getEvictionCandidates(frame)) {
+
+            candidates.push_back({lastUsedFrame, [this, texture = texture] { textures.evictTexture(*texture); }});
+        }
+        for (const auto& [lastUsedFrame, geometry] : objects.getEvictionCandidates(frame)) {
+
+            candidates.push_back({lastUsedFrame, [this, geometry = geometry] { objects.evict(geometry); }});
+        }
+
+        gl::evictLeastRecentlyUsed(candidates, memory, budget);
+    }
+
+    // _streamingSphere holds the object's local bounding sphere
+    void requestStreamingLevels(Object3D* object, const std::vector<Material*>& materials, Camera* camera) {
+
+        _streamingSphere.applyMatrix4(*object->matrixWorld);
+
+        const auto& e = camera->projectionMatrix.elements;
+        float ndcRadius = _streamingSphere.radius * e[5];
+
+        if (e[15] == 0) {// perspective
+
+            const auto depth = -_vector3.copy(_streamingSphere.center).applyMatrix4(camera->matrixWorldInverse).z;
+            ndcRadius /= std::max(depth, 1e-4f);
+        }
+
+        // diameter in pixels: the ndc range [-1, 1] spans the viewport height
+        const auto screenSize = ndcRadius * _currentViewport.w;
+
+        for (auto material : materials) {
+
+            if (!material) continue;
+
+            if (auto m = dynamic_cast<MaterialWithMap*>(material); m && m->map) textures.requestStreamingLevel(*m->map, screenSize);
+            if (auto m = dynamic_cast<MaterialWithAlphaMap*>(material); m && m->alphaMap) textures.requestStreamingLevel(*m->alphaMap, screenSize);
+            if (auto m = dynamic_cast<MaterialWithEmissive*>(material); m && m->emissiveMap) textures.requestStreamingLevel(*m->emissiveMap, screenSize);
+            if (auto m = dynamic_cast<MaterialWithSpecularMap*>(material); m && m->specularMap) textures.requestStreamingLevel(*m->specularMap, screenSize);
+            if (auto m = dynamic_cast<MaterialWithNormalMap*>(material); m && m->normalMap) textures.requestStreamingLevel(*m->normalMap, screenSize);
         }
     }
 
@@ -594,7 +843,7 @@ struct GLRenderer::Impl {
 
             // new material
 
-            material->addEventListener("dispose", &onMaterialDispose);
+            material->addEventListener(events::dispose, &onMaterialDispose);
         }
 
         std::shared_ptr<gl::GLProgram> program = nullptr;
@@ -675,6 +924,7 @@ struct GLRenderer::Impl {
 
         materialProperties->outputEncoding = parameters.outputEncoding;
         materialProperties->instancing = parameters.instancing;
+        materialProperties->batching = parameters.batching;
         materialProperties->skinning = parameters.skinning;
         materialProperties->numClippingPlanes = parameters.numClippingPlanes;
         materialProperties->numIntersection = parameters.numClipIntersection;
@@ -729,6 +979,7 @@ struct GLRenderer::Impl {
         bool needsProgramChange = false;
         bool isInstancedMesh = object->type() == "InstancedMesh";
         bool isSkinnedMesh = object->type() == "SkinnedMesh";
+        bool isBatchedMesh = object->type() == "BatchedMesh";
 
         if (material->version == materialProperties->version) {
 
@@ -748,6 +999,14 @@ struct GLRenderer::Impl {
 
                 needsProgramChange = true;
 
+            } else if (isBatchedMesh && !materialProperties->batching) {
+
+                needsProgramChange = true;
+
+            } else if (!isBatchedMesh && materialProperties->batching) {
+
+                needsProgramChange = true;
+
             } else if (isSkinnedMesh && !materialProperties->skinning) {
 
                 needsProgramChange = true;
@@ -876,6 +1135,11 @@ struct GLRenderer::Impl {
         // auto-setting of texture unit for bone texture must go before other textures
         // otherwise textures used for skinning can take over texture units reserved for other material textures
 
+        if (auto batched = object->as<BatchedMesh>()) {
+
+            p_uniforms->setValue("batchingTexture", &batched->matricesTexture(), &textures);
+        }
+
         if (auto skinned = object->as<SkinnedMesh>()) {
 
             const auto& bindMatrix = skinned->bindMatrix;
@@ -905,6 +1169,19 @@ struct GLRenderer::Impl {
             }
         }
 
+        // clustered light textures are bound for every draw, ahead of the material textures
+
+        if (materialProperties->needsLights && lights.state.clustered) {
+
+            auto& clusters = lights.clusters;
+
+            p_uniforms->setValue("clusterLightTexture", clusters.lightTexture.get(), &textures);
+            p_uniforms->setValue("clusterGridTexture", clusters.gridTexture.get(), &textures);
+            p_uniforms->setValue("clusterIndexTexture", clusters.indexTexture.get(), &textures);
+            p_uniforms->setValue("clusterProjectionMatrix", clusters.projectionMatrix);
+            p_uniforms->setValue("clusterDepth", clusters.depth);
+        }
+
         if (refreshMaterial || materialProperties->receiveShadow != object->receiveShadow) {
 
             materialProperties->receiveShadow = object->receiveShadow;
@@ -1069,6 +1346,109 @@ struct GLRenderer::Impl {
         state.setScissorTest(_currentScissorTest.value_or(false));
     }
 
+    void pick(Scene* scene, Camera* camera, const Vector2& coords, unsigned int radius, const GLRenderer::PickCallback& callback) {
+
+        picking.poll(false);
+
+        if (scene->autoUpdate) scene->updateMatrixWorld();
+        if (camera->parent == nullptr) camera->updateMatrixWorld();
+
+        _bvh = scene->bvh.get();
+
+        if (scope.groupCulling) updateGroupBounds(*scene, _bvh);
+
+        // the region, snapped to the pixels of the viewport, in normalized device coordinates
+
+        Vector4 viewport;
+        viewport.copy(_viewport).multiplyScalar(static_cast<float>(_pixelRatio)).floor();
+
+        const auto size = 2 * radius + 1;
+        const auto pixelX = std::floor((coords.x * 0.5f + 0.5f) * viewport.z);
+        const auto pixelY = std::floor((coords.y * 0.5f + 0.5f) * viewport.w);
+
+        const Vector2 center((pixelX + 0.5f) / viewport.z * 2 - 1, (pixelY + 0.5f) / viewport.w * 2 - 1);
+        const Vector2 halfSize(static_cast<float>(size) / viewport.z, static_cast<float>(size) / viewport.w);
+
+        // the camera projection, narrowed to the region, which also narrows the culling frustum
+
+        const auto projectionMatrix = camera->projectionMatrix;
+
+        Matrix4 region;
+        region.set(
+                1 / halfSize.x, 0, 0, -center.x / halfSize.x,
+                0, 1 / halfSize.y, 0, -center.y / halfSize.y,
+                0, 0, 1, 0,
+                0, 0, 0, 1);
+        camera->projectionMatrix.premultiply(region);
+
+        _projScreenMatrix.multiplyMatrices(camera->projectionMatrix, camera->matrixWorldInverse);
+        _frustum.setFromProjectionMatrix(_projScreenMatrix);
+
+        currentRenderState = renderStates.get(scene, renderStateStack.size());
+        currentRenderState->init();
+        renderStateStack.emplace_back(currentRenderState);
+
+        currentRenderList = renderLists.get(scene, renderListStack.size());
+        currentRenderList->init();
+        renderListStack.emplace_back(currentRenderList);
+
+        _picking = true;
+
+        projectObject(scene, camera, 0, false);
+        if (_bvh) projectStatic(scene, camera, false);
+
+        currentRenderList->finish();
+
+        // draw the ids
+
+        const auto renderTarget = _currentRenderTarget;
+        const auto activeCubeFace = _currentActiveCubeFace;
+        const auto activeMipmapLevel = _currentActiveMipmapLevel;
+        const auto clippingEnabled = _clippingEnabled;
+
+        _clippingEnabled = false;
+        _currentMaterialId = std::nullopt;
+        _currentCamera = nullptr;
+
+        setRenderTarget(picking.begin(size), 0, 0);
+        picking.clear(state);
+
+        for (const auto list : {&currentRenderList->opaque, &currentRenderList->transparent}) {
+
+            for (const auto& item : *list) {
+
+                auto object = item->object;
+                auto material = picking.material(object, item->geometry, item->material, item->group, _pixelRatio, viewport.w);
+
+                if (!material) continue;
+
+                object->modelViewMatrix.multiplyMatrices(camera->matrixWorldInverse, *object->matrixWorld);
+                object->normalMatrix.getNormalMatrix(object->modelViewMatrix);
+
+                renderBufferDirect(camera, scene, item->geometry, material, object, item->group);
+            }
+        }
+
+        camera->projectionMatrix.copy(projectionMatrix);
+
+        picking.end(*camera, center, halfSize, callback);
+
+        // restore
+
+        _picking = false;
+        _clippingEnabled = clippingEnabled;
+        _currentMaterialId = std::nullopt;
+        _currentCamera = nullptr;
+
+        setRenderTarget(renderTarget, activeCubeFace, activeMipmapLevel);
+
+        renderStateStack.pop_back();
+        currentRenderState = renderStateStack.empty() ? nullptr : renderStateStack.back();
+
+        renderListStack.pop_back();
+        currentRenderList = renderListStack.empty() ? nullptr : renderListStack.back();
+    }
+
     void copyFramebufferToTexture(const Vector2& position, Texture& texture, int level) {
 
         const auto levelScale = std::pow(2, -level);
@@ -1105,8 +1485,11 @@ struct GLRenderer::Impl {
 
     void dispose() {
 
+        picking.dispose();
+        autoInstancing.dispose();
         renderLists.dispose();
         renderStates.dispose();
+        textures.dispose();
         properties.dispose();
         //    cubemaps.dispose();
         objects.dispose();
@@ -1301,6 +1684,16 @@ void GLRenderer::readPixels(const Vector2& position, const WindowSize& size, For
     pimpl_->readPixels(position, size, format, data);
 }
 
+void GLRenderer::pick(Scene& scene, Camera& camera, const Vector2& coords, const PickCallback& callback, unsigned int radius) {
+
+    pimpl_->pick(&scene, &camera, coords, radius, callback);
+}
+
+void GLRenderer::pollPicks(bool wait) {
+
+    pimpl_->picking.poll(wait);
+}
+
 void GLRenderer::resetState() {
 
     pimpl_->reset();
@@ -2,6 +2,8 @@
 #ifndef THREEPP_BUFFER_HPP
 #define THREEPP_BUFFER_HPP
 
+#include <cstddef>
+
 namespace threepp::gl {
 
     struct Buffer {
@@ -9,6 +11,7 @@ namespace threepp::gl {
         int type{};
         int bytesPerElement{};
         unsigned int version{};
+        size_t bytes{};
     };
 
 }// namespace threepp::gl
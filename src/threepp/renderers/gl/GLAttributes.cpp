@@ -1,6 +1,7 @@
 
 #include "threepp/renderers/gl/GLAttributes.hpp"
 #include "threepp/core/InterleavedBufferAttribute.hpp"
+#include "threepp/renderers/gl/GLMemory.hpp"
 
 #ifndef EMSCRIPTEN
 #include <glad/glad.h>
@@ -8,9 +9,76 @@
 #include <GLES3/gl3.h>
 #endif
 
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+
 using namespace threepp;
 using namespace threepp::gl;
 
+namespace {
+
+    // buffers are created for the attribute types createBuffer supports, IntBufferAttribute and FloatBufferAttribute
+    size_t arrayBytes(BufferAttribute* attribute) {
+
+        if (auto attr = attribute->typed<unsigned int>()) return attr->array().size() * sizeof(unsigned int);
+        if (auto attr = attribute->typed<float>()) return attr->array().size() * sizeof(float);
+
+        throw std::runtime_error(std::string("GLAttributes: unsupported attribute array type ") + typeid(*attribute).name());
+    }
+
+    void bufferData(GLenum bufferType, BufferAttribute* attribute, size_t bytes) {
+
+        const auto usage = as_integer(attribute->getUsage());
+
+        if (auto attr = attribute->typed<unsigned int>()) {
+
+            glBufferData(bufferType, (GLsizei) bytes, attr->array().data(), usage);
+
+        } else if (auto attr = attribute->typed<float>()) {
+
+            glBufferData(bufferType, (GLsizei) bytes, attr->array().data(), usage);
+        }
+    }
+
+    // sorted, with overlapping and adjacent ranges merged
+    void mergeRanges(std::vector<UpdateRange>& ranges) {
+
+        std::sort(ranges.begin(), ranges.end(), [](const UpdateRange& a, const UpdateRange& b) {
+            return a.offset < b.offset;
+        });
+
+        size_t merged = 0;
+        for (size_t i = 1; i < ranges.size(); ++i) {
+
+            auto& last = ranges[merged];
+            const auto& range = ranges[i];
+
+            if (range.offset <= last.offset + last.count) {
+
+                last.count = std::max(last.count, range.offset + range.count - last.offset);
+
+            } else {
+
+                ranges[++merged] = range;
+            }
+        }
+
+        ranges.resize(std::min(ranges.size(), merged + 1));
+    }
+
+    template<class T>
+    void bufferSubData(GLenum bufferType, const std::vector<T>& array, const UpdateRange& range) {
+
+        glBufferSubData(bufferType, (GLintptr) (range.offset * sizeof(T)), (GLsizei) (range.count * sizeof(T)), array.data() + range.offset);
+    }
+
+}// namespace
+
+GLAttributes::GLAttributes(GLInfo& info)
+    : info_(info) {}
+
 Buffer GLAttributes::createBuffer(BufferAttribute* attribute, GLenum bufferType) {
 
     const auto usage = attribute->getUsage();
@@ -21,34 +89,61 @@ Buffer GLAttributes::createBuffer(BufferAttribute* attribute, GLenum bufferType)
 
     GLint type;
     GLsizei bytesPerElement;
+    size_t bytes;
     if (attribute->typed<unsigned int>()) {
         type = GL_UNSIGNED_INT;
         bytesPerElement = sizeof(unsigned int);
         auto attr = attribute->typed<unsigned int>();
         const auto& array = attr->array();
-        glBufferData(bufferType, (GLsizei) (array.size() * bytesPerElement), array.data(), as_integer(usage));
+        bytes = array.size() * bytesPerElement;
+        glBufferData(bufferType, (GLsizei) bytes, array.data(), as_integer(usage));
 
     } else if (attribute->typed<float>()) {
         type = GL_FLOAT;
         bytesPerElement = sizeof(float);
         auto attr = attribute->typed<float>();
         const auto& array = attr->array();
-        glBufferData(bufferType, (GLsizei) (array.size() * bytesPerElement), array.data(), as_integer(usage));
+        bytes = array.size() * bytesPerElement;
+        glBufferData(bufferType, (GLsizei) bytes, array.data(), as_integer(usage));
     } else {
 
         throw std::runtime_error("TODO");
     }
 
-    return {buffer, type, bytesPerElement, attribute->version + 1};
+    info_.memory.bufferBytes += bytes;
+
+    attribute->clearUpdateRanges();
+
+    return {buffer, type, bytesPerElement, attribute->version, bytes};
 }
 
 void GLAttributes::updateBuffer(GLuint buffer, BufferAttribute* attribute, GLenum bufferType, int bytesPerElement) {
 
     auto& updateRange = attribute->updateRange;
+    auto& updateRanges = attribute->updateRanges;
 
     glBindBuffer(bufferType, buffer);
 
-    if (updateRange.count == -1) {
+    if (!updateRanges.empty()) {
+
+        mergeRanges(updateRanges);
+
+        for (const auto& range : updateRanges) {
+
+            if (auto attr = attribute->typed<unsigned int>()) {
+
+                bufferSubData(bufferType, attr->array(), range);
+
+            } else if (auto attr = attribute->typed<float>()) {
+
+                bufferSubData(bufferType, attr->array(), range);
+            }
+        }
+
+        updateRanges.clear();
+        updateRange.count = -1;
+
+    } else if (updateRange.count == -1) {
 
         if (attribute->typed<unsigned int>()) {
 
@@ -111,6 +206,8 @@ void GLAttributes::remove(BufferAttribute* attribute) {
 
         glDeleteBuffers(1, &data.buffer);
 
+        info_.memory.bufferBytes -= data.bytes;
+
         buffers_.erase(attribute);
     }
 }
@@ -130,8 +227,26 @@ void GLAttributes::update(BufferAttribute* attribute, GLenum bufferType) {
         auto& data = buffers_.at(attribute);
 
         if (data.version < attribute->version) {
-            updateBuffer(data.buffer, attribute, bufferType, data.bytesPerElement);
-            ++data.version;
+
+            const auto bytes = arrayBytes(attribute);
+
+            if (bytes != data.bytes) {
+
+                // resized, reallocate the storage of the same buffer so that bindings stay valid
+                glBindBuffer(bufferType, data.buffer);
+                bufferData(bufferType, attribute, bytes);
+
+                trackBytes(info_.memory.bufferBytes, data.bytes, bytes);
+
+                attribute->clearUpdateRanges();
+                attribute->updateRange.count = -1;
+
+            } else {
+
+                updateBuffer(data.buffer, attribute, bufferType, data.bytesPerElement);
+            }
+
+            data.version = attribute->version;
         }
     }
 }
@@ -6,6 +6,7 @@
 #include "threepp/core/BufferAttribute.hpp"
 
 #include "threepp/renderers/gl/Buffer.hpp"
+#include "threepp/renderers/gl/GLInfo.hpp"
 
 #include <unordered_map>
 
@@ -13,6 +14,8 @@ namespace threepp::gl {
 
     struct GLAttributes {
 
+        explicit GLAttributes(GLInfo& info);
+
         Buffer createBuffer(BufferAttribute* attribute, unsigned int bufferType);
 
         void updateBuffer(unsigned int buffer, BufferAttribute* attribute, unsigned int bufferType, int bytesPerElement);
@@ -24,6 +27,7 @@ namespace threepp::gl {
         void update(BufferAttribute* attribute, unsigned int bufferType);
 
     private:
+        GLInfo& info_;
         std::unordered_map<BufferAttribute*, Buffer> buffers_;
     };
 
@@ -0,0 +1,192 @@
+
+#include "threepp/renderers/gl/GLAutoInstancing.hpp"
+
+#include "threepp/core/InstancedBufferGeometry.hpp"
+#include "threepp/materials/interfaces.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/renderers/gl/GLRenderLists.hpp"
+
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    // render items drawn the same way whatever their object, but for its world matrix
+    using Key = std::tuple<const GLRenderList*, BufferGeometry*, Material*, int, int, unsigned int, unsigned int, bool>;
+
+    Key keyOf(const GLRenderList& list, const RenderItem& item) {
+
+        const auto group = item.group.value_or(GeometryGroup{0, -1});
+
+        return {&list, item.geometry, item.material, group.start, group.count, item.groupOrder, item.renderOrder, item.object->receiveShadow};
+    }
+
+    bool compatible(const RenderItem& item) {
+
+        // not derived meshes, whose shaders use more than the world matrix
+        if (item.object->type() != "Mesh") return false;
+
+        if (item.object->onBeforeRender) return false;
+        if (dynamic_cast<InstancedBufferGeometry*>(item.geometry)) return false;
+
+        if (auto m = dynamic_cast<MaterialWithMorphTargets*>(item.material); m && (m->morphTargets || m->morphNormals)) return false;
+
+        // mirrored meshes are drawn with the opposite front face
+        return item.object->matrixWorld->determinant() > 0;
+    }
+
+}// namespace
+
+struct GLAutoInstancing::Impl {
+
+    struct Batch {
+        std::vector<RenderItem*> items;
+        std::shared_ptr<InstancedMesh> mesh;
+        size_t generation = 0;
+    };
+
+    std::map<Key, Batch> batches;
+    // number of merges of each list. Batches live as long as their list keeps drawing them, whatever the number
+    // of render() calls per frame and whether the frame counter of GLInfo advances.
+    std::unordered_map<const GLRenderList*, size_t> generations;
+
+    std::vector<RenderItem*> opaque;
+    std::vector<InstancedMesh*> merged;
+
+    const std::vector<InstancedMesh*>& merge(GLRenderList& list) {
+
+        merged.clear();
+
+        const auto generation = ++generations[&list];
+
+        for (auto& [key, batch] : batches) {
+
+            if (std::get<0>(key) == &list) batch.items.clear();
+        }
+
+        for (auto item : list.opaque) {
+
+            if (compatible(*item)) batches[keyOf(list, *item)].items.push_back(item);
+        }
+
+        // the first item of each batch draws all of them, in place
+
+        opaque.clear();
+
+        for (auto item : list.opaque) {
+
+            if (!compatible(*item)) {
+
+                opaque.push_back(item);
+                continue;
+            }
+
+            auto& batch = batches.at(keyOf(list, *item));
+
+            if (batch.items.size() < 2) {
+
+                opaque.push_back(item);
+
+            } else if (batch.items.front() == item) {
+
+                instance(batch, generation);
+
+                item->object = batch.mesh.get();
+                item->id = batch.mesh->id;
+
+                opaque.push_back(item);
+                merged.push_back(batch.mesh.get());
+            }
+        }
+
+        list.opaque.swap(opaque);
+
+        evict(list, generation);
+
+        return merged;
+    }
+
+    static void instance(Batch& batch, size_t generation) {
+
+        const auto& items = batch.items;
+
+        if (!batch.mesh) {
+
+            auto first = items.front();
+            auto mesh = static_cast<Mesh*>(first->object);
+
+            batch.mesh = InstancedMesh::create(mesh->shared_geometry(), first->material->shared_from_this(), items.size());
+            batch.mesh->instanceMatrix->setUsage(DrawUsage::Dynamic);
+            batch.mesh->receiveShadow = mesh->receiveShadow;
+        }
+
+        auto& mesh = *batch.mesh;
+
+        mesh.count = 0;
+        mesh.reserve(items.size());
+
+        for (auto item : items) {
+
+            mesh.addInstance(*item->object->matrixWorld);
+        }
+
+        batch.generation = generation;
+    }
+
+    // batches of the list with a single item, and instanced meshes unused since its previous merge
+    void evict(const GLRenderList& list, size_t generation) {
+
+        for (auto it = batches.begin(); it != batches.end();) {
+
+            auto& batch = it->second;
+
+            if (std::get<0>(it->first) != &list) {
+
+                ++it;
+
+            } else if (!batch.mesh) {
+
+                it = batches.erase(it);
+
+            } else if (batch.generation + 1 < generation) {
+
+                batch.mesh->dispose();
+                it = batches.erase(it);
+
+            } else {
+
+                ++it;
+            }
+        }
+    }
+
+    void dispose() {
+
+        for (auto& [key, batch] : batches) {
+
+            if (batch.mesh) batch.mesh->dispose();
+        }
+
+        batches.clear();
+        generations.clear();
+    }
+};
+
+GLAutoInstancing::GLAutoInstancing()
+    : pimpl_(std::make_unique<Impl>()) {}
+
+const std::vector<InstancedMesh*>& GLAutoInstancing::merge(GLRenderList& list) {
+
+    return pimpl_->merge(list);
+}
+
+void GLAutoInstancing::dispose() {
+
+    pimpl_->dispose();
+}
+
+GLAutoInstancing::~GLAutoInstancing() = default;
@@ -0,0 +1,39 @@
+
+#ifndef THREEPP_GLAUTOINSTANCING_HPP
+#define THREEPP_GLAUTOINSTANCING_HPP
+
+#include <memory>
+#include <vector>
+
+namespace threepp {
+
+    class InstancedMesh;
+
+    namespace gl {
+
+        struct GLRenderList;
+
+        // Draws the meshes sharing a geometry and a material with one instanced call. Their opaque render items
+        // are merged into the item of a hidden InstancedMesh, holding their world matrices for the frame.
+        struct GLAutoInstancing {
+
+            GLAutoInstancing();
+
+            // merges the compatible items of the list, returning the instanced meshes whose buffers must be updated.
+            // Instanced meshes not used by the previous merge of the same list are disposed.
+            const std::vector<InstancedMesh*>& merge(GLRenderList& list);
+
+            void dispose();
+
+            ~GLAutoInstancing();
+
+        private:
+            struct Impl;
+            std::unique_ptr<Impl> pimpl_;
+        };
+
+    }// namespace gl
+
+}// namespace threepp
+
+#endif//THREEPP_GLAUTOINSTANCING_HPP
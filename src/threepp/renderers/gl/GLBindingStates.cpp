@@ -36,7 +36,8 @@ struct GLBindingStates::Impl {
           currentState_(defaultState_) {}
 
 
-    void setup(Object3D* object, Material* material, GLProgram* program, BufferGeometry* geometry, BufferAttribute* index) {
+    void setup(Object3D* object, Material* material, GLProgram* program, BufferGeometry* geometry, BufferAttribute* index,
+               BufferAttribute* instanceMatrix, BufferAttribute* instanceColor) {
 
         auto state = getBindingState(geometry, program, material);
 
@@ -64,7 +65,7 @@ struct GLBindingStates::Impl {
 
         if (updateBuffers) {
 
-            setupVertexAttributes(object, material, program, geometry);
+            setupVertexAttributes(object, material, program, geometry, instanceMatrix, instanceColor);
 
             if (index) {
 
@@ -234,7 +235,8 @@ struct GLBindingStates::Impl {
         }
     }
 
-    void setupVertexAttributes(Object3D* object, Material* material, GLProgram* program, BufferGeometry* geometry) {
+    void setupVertexAttributes(Object3D* object, Material* material, GLProgram* program, BufferGeometry* geometry,
+                               BufferAttribute* instanceMatrix = nullptr, BufferAttribute* instanceColor = nullptr) {
 
         initAttributes();
 
@@ -303,7 +305,8 @@ struct GLBindingStates::Impl {
 
                 } else if (name == "instanceMatrix") {
 
-                    auto attribute = attributes_.get(object->as<InstancedMesh>()->instanceMatrix.get());
+                    if (!instanceMatrix) instanceMatrix = object->as<InstancedMesh>()->instanceMatrix.get();
+                    auto attribute = attributes_.get(instanceMatrix);
 
                     auto buffer = attribute.buffer;
                     auto type = attribute.type;
@@ -322,7 +325,8 @@ struct GLBindingStates::Impl {
 
                 } else if (name == "instanceColor") {
 
-                    auto attribute = attributes_.get(object->as<InstancedMesh>()->instanceColor.get());
+                    if (!instanceColor) instanceColor = object->as<InstancedMesh>()->instanceColor.get();
+                    auto attribute = attributes_.get(instanceColor);
 
                     auto buffer = attribute.buffer;
                     auto type = attribute.type;
@@ -431,9 +435,10 @@ GLBindingStates::GLBindingStates(GLAttributes& attributes)
     : pimpl_(std::make_unique<Impl>(attributes)) {
 }
 
-void GLBindingStates::setup(Object3D* object, Material* material, GLProgram* program, BufferGeometry* geometry, BufferAttribute* index) {
+void GLBindingStates::setup(Object3D* object, Material* material, GLProgram* program, BufferGeometry* geometry, BufferAttribute* index,
+                            BufferAttribute* instanceMatrix, BufferAttribute* instanceColor) {
 
-    pimpl_->setup(object, material, program, geometry, index);
+    pimpl_->setup(object, material, program, geometry, index, instanceMatrix, instanceColor);
 }
 
 GLuint GLBindingStates::createVertexArrayObject() const {
@@ -42,7 +42,9 @@ namespace threepp::gl {
 
         explicit GLBindingStates(GLAttributes& attributes);
 
-        void setup(Object3D* object, Material* material, GLProgram* program, BufferGeometry* geometry, BufferAttribute* index);
+        // instanceMatrix and instanceColor replace those of an InstancedMesh, e.g. with its culled instances
+        void setup(Object3D* object, Material* material, GLProgram* program, BufferGeometry* geometry, BufferAttribute* index,
+                   BufferAttribute* instanceMatrix = nullptr, BufferAttribute* instanceColor = nullptr);
 
         [[nodiscard]] unsigned int createVertexArrayObject() const;
 
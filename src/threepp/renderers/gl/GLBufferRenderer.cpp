@@ -33,6 +33,22 @@ void GLBufferRenderer::renderInstances(int start, int count, int primcount) {
     info_.update(count, mode_, primcount);
 }
 
+void GLBufferRenderer::renderMultiDraw(const std::vector<int>& starts, const std::vector<int>& counts) {
+
+    if (starts.empty()) return;
+
+#ifndef EMSCRIPTEN
+    glMultiDrawArrays(mode_, starts.data(), counts.data(), static_cast<GLsizei>(starts.size()));
+#else
+    for (size_t i = 0; i < starts.size(); ++i) {
+
+        glDrawArrays(mode_, starts[i], counts[i]);
+    }
+#endif
+
+    for (auto count : counts) info_.update(count, mode_, 1);
+}
+
 void GLIndexedBufferRenderer::setIndex(const Buffer& value) {
 
     type_ = value.type;
@@ -54,3 +70,25 @@ void GLIndexedBufferRenderer::renderInstances(int start, int count, int primcoun
 
     info_.update(count, mode_, primcount);
 }
+
+void GLIndexedBufferRenderer::renderMultiDraw(const std::vector<int>& starts, const std::vector<int>& counts) {
+
+    if (starts.empty()) return;
+
+#ifndef EMSCRIPTEN
+    offsets_.resize(starts.size());
+    for (size_t i = 0; i < starts.size(); ++i) {
+
+        offsets_[i] = (const GLvoid*) (starts[i] * bytesPerElement_);
+    }
+
+    glMultiDrawElements(mode_, counts.data(), type_, offsets_.data(), static_cast<GLsizei>(starts.size()));
+#else
+    for (size_t i = 0; i < starts.size(); ++i) {
+
+        glDrawElements(mode_, counts[i], type_, (GLvoid*) (starts[i] * bytesPerElement_));
+    }
+#endif
+
+    for (auto count : counts) info_.update(count, mode_, 1);
+}
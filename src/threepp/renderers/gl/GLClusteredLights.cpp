@@ -0,0 +1,242 @@
+
+#include "threepp/renderers/gl/GLClusteredLights.hpp"
+
+#include "threepp/cameras/Camera.hpp"
+#include "threepp/lights/PointLight.hpp"
+#include "threepp/lights/SpotLight.hpp"
+#include "threepp/math/MathUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    constexpr int numClusters = GLClusteredLights::gridX * GLClusteredLights::gridY * GLClusteredLights::gridZ;
+
+    constexpr unsigned int indexTextureWidth = 1024;
+
+    struct ClusterRange {
+
+        int minX, maxX;
+        int minY, maxY;
+        int minZ, maxZ;
+    };
+
+    int depthSlice(float depth, const Vector2& params) {
+
+        const auto slice = std::log(std::max(depth, params.x) / params.x) * params.y * GLClusteredLights::gridZ;
+
+        return static_cast<int>(std::min(slice, static_cast<float>(GLClusteredLights::gridZ - 1)));
+    }
+
+    int tile(float ndc, int count) {
+
+        const auto t = std::clamp((ndc * 0.5f + 0.5f) * static_cast<float>(count), 0.f, static_cast<float>(count - 1));
+
+        return static_cast<int>(t);
+    }
+
+    // grows the texture to hold the given number of rows, keeping power of two heights
+    void ensureRows(std::shared_ptr<DataTexture>& texture, unsigned int width, unsigned int rows) {
+
+        const auto height = static_cast<unsigned int>(math::ceilPowerOfTwo(static_cast<float>(std::max(rows, 1u))));
+
+        if (!texture || texture->image->height < height) {
+
+            texture = DataTexture::create(std::vector<float>(width * height * 4), width, height);
+            texture->format = Format::RGBA;
+            texture->type = Type::Float;
+        }
+    }
+
+}// namespace
+
+GLClusteredLights::GLClusteredLights()
+    : counts_(numClusters), offsets_(numClusters) {
+
+    gridTexture = DataTexture::create(std::vector<float>(numClusters * 4), gridX * gridY, gridZ);
+    gridTexture->format = Format::RGBA;
+    gridTexture->type = Type::Float;
+
+    ensureRows(lightTexture, 4, 1);
+    ensureRows(indexTexture, indexTextureWidth, 1);
+}
+
+void GLClusteredLights::update(const std::vector<Light*>& lights, const Camera& camera) {
+
+    const auto& viewMatrix = camera.matrixWorldInverse;
+    const auto zNear = std::max(camera.near, 0.001f);
+    const auto zFar = std::max(camera.far, zNear * 2);
+
+    projectionMatrix.copy(camera.projectionMatrix);
+    depth.set(zNear, 1.f / std::log(zFar / zNear));
+
+    ensureRows(lightTexture, 4, static_cast<unsigned int>(lights.size()));
+    auto& lightData = lightTexture->image->data<float>();
+
+    std::vector<ClusterRange> ranges;
+    ranges.reserve(lights.size());
+
+    std::fill(counts_.begin(), counts_.end(), 0);
+
+    Vector3 position;
+    Vector3 direction;
+    Vector3 corner;
+
+    for (unsigned i = 0; i < lights.size(); ++i) {
+
+        auto light = lights[i];
+
+        float distance = 0, decay = 1, coneCos = -1, penumbraCos = -1;
+        bool isSpot = false;
+
+        position.setFromMatrixPosition(*light->matrixWorld);
+
+        if (auto spotLight = light->as<SpotLight>()) {
+
+            distance = spotLight->distance;
+            decay = spotLight->decay;
+            coneCos = std::cos(spotLight->angle);
+            penumbraCos = std::cos(spotLight->angle * (1 - spotLight->penumbra));
+            isSpot = true;
+
+            Vector3 target;
+            target.setFromMatrixPosition(*spotLight->target->matrixWorld);
+            direction.copy(position).sub(target).transformDirection(viewMatrix);
+
+        } else if (auto pointLight = light->as<PointLight>()) {
+
+            distance = pointLight->distance;
+            decay = pointLight->decay;
+            direction.set(0, 0, 0);
+        }
+
+        position.applyMatrix4(viewMatrix);
+
+        const auto setTexel = [&](unsigned int texel, float x, float y, float z, float w) {
+            auto* data = &lightData[(i * 4 + texel) * 4];
+            data[0] = x;
+            data[1] = y;
+            data[2] = z;
+            data[3] = w;
+        };
+
+        const auto& color = light->color;
+        setTexel(0, position.x, position.y, position.z, distance);
+        setTexel(1, color.r * light->intensity, color.g * light->intensity, color.b * light->intensity, decay);
+        setTexel(2, direction.x, direction.y, direction.z, coneCos);
+        setTexel(3, penumbraCos, isSpot ? 1.f : 0.f, 0, 0);
+
+        // a distance of 0 means unlimited range
+
+        const auto radius = distance > 0 ? distance : std::numeric_limits<float>::infinity();
+        const auto minDepth = -position.z - radius;
+        const auto maxDepth = -position.z + radius;
+
+        if (maxDepth < zNear || minDepth > zFar) {
+
+            ranges.push_back({0, -1, 0, -1, 0, -1});
+            continue;
+        }
+
+        ClusterRange range{0, gridX - 1, 0, gridY - 1, depthSlice(minDepth, depth), depthSlice(maxDepth, depth)};
+
+        if (std::isfinite(radius) && minDepth > zNear) {
+
+            // screen space bounds of the light's bounding box
+
+            float minX = 1, maxX = -1, minY = 1, maxY = -1;
+            for (int c = 0; c < 8; ++c) {
+
+                corner.set(
+                        position.x + ((c & 1) ? radius : -radius),
+                        position.y + ((c & 2) ? radius : -radius),
+                        position.z + ((c & 4) ? radius : -radius));
+                corner.applyMatrix4(projectionMatrix);
+
+                minX = std::min(minX, corner.x);
+                maxX = std::max(maxX, corner.x);
+                minY = std::min(minY, corner.y);
+                maxY = std::max(maxY, corner.y);
+            }
+
+            if (maxX < -1 || minX > 1 || maxY < -1 || minY > 1) {
+
+                ranges.push_back({0, -1, 0, -1, 0, -1});
+                continue;
+            }
+
+            range.minX = tile(minX, gridX);
+            range.maxX = tile(maxX, gridX);
+            range.minY = tile(minY, gridY);
+            range.maxY = tile(maxY, gridY);
+        }
+
+        for (int z = range.minZ; z <= range.maxZ; ++z) {
+            for (int y = range.minY; y <= range.maxY; ++y) {
+                for (int x = range.minX; x <= range.maxX; ++x) {
+
+                    ++counts_[x + y * gridX + z * gridX * gridY];
+                }
+            }
+        }
+
+        ranges.push_back(range);
+    }
+
+    lightTexture->needsUpdate();
+
+    // prefix sum of counts gives each cluster its slice of the index list
+
+    unsigned int total = 0;
+    auto& gridData = gridTexture->image->data<float>();
+    for (int i = 0; i < numClusters; ++i) {
+
+        offsets_[i] = total;
+        gridData[i * 4] = static_cast<float>(total);
+        gridData[i * 4 + 1] = static_cast<float>(counts_[i]);
+        total += counts_[i];
+    }
+
+    gridTexture->needsUpdate();
+
+    indices_.resize(total);
+    std::fill(counts_.begin(), counts_.end(), 0);
+
+    for (unsigned i = 0; i < ranges.size(); ++i) {
+
+        const auto& range = ranges[i];
+
+        for (int z = range.minZ; z <= range.maxZ; ++z) {
+            for (int y = range.minY; y <= range.maxY; ++y) {
+                for (int x = range.minX; x <= range.maxX; ++x) {
+
+                    const auto cluster = x + y * gridX + z * gridX * gridY;
+                    indices_[offsets_[cluster] + counts_[cluster]++] = i;
+                }
+            }
+        }
+    }
+
+    ensureRows(indexTexture, indexTextureWidth, (total + indexTextureWidth * 4 - 1) / (indexTextureWidth * 4));
+    auto& indexData = indexTexture->image->data<float>();
+    std::transform(indices_.begin(), indices_.end(), indexData.begin(), [](auto index) { return static_cast<float>(index); });
+
+    indexTexture->needsUpdate();
+}
+
+std::pair<unsigned int, unsigned int> GLClusteredLights::getCluster(int x, int y, int z) const {
+
+    const auto cluster = x + y * gridX + z * gridX * gridY;
+
+    return {offsets_[cluster], counts_[cluster]};
+}
+
+unsigned int GLClusteredLights::getLightIndex(unsigned int i) const {
+
+    return indices_.at(i);
+}
@@ -0,0 +1,58 @@
+
+#ifndef THREEPP_GLCLUSTEREDLIGHTS_HPP
+#define THREEPP_GLCLUSTEREDLIGHTS_HPP
+
+#include "threepp/math/Matrix4.hpp"
+#include "threepp/math/Vector2.hpp"
+#include "threepp/textures/DataTexture.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace threepp {
+
+    class Camera;
+    class Light;
+
+    namespace gl {
+
+        // Bins point and spot lights into a view frustum aligned grid of clusters
+        // (screen tiles x exponential depth slices). The fragment shader only
+        // iterates over the lights of its own cluster. Light data, per cluster
+        // ranges and light indices are stored in float data textures.
+        struct GLClusteredLights {
+
+            static constexpr int gridX = 16;
+            static constexpr int gridY = 9;
+            static constexpr int gridZ = 24;
+
+            // 4 texels per light: position + distance, color + decay, direction + coneCos, penumbraCos + isSpot
+            std::shared_ptr<DataTexture> lightTexture;
+            // 1 texel per cluster: index offset, light count
+            std::shared_ptr<DataTexture> gridTexture;
+            // 4 light indices per texel
+            std::shared_ptr<DataTexture> indexTexture;
+
+            Matrix4 projectionMatrix;
+            Vector2 depth;// near, 1 / log(far / near)
+
+            GLClusteredLights();
+
+            void update(const std::vector<Light*>& lights, const Camera& camera);
+
+            // [offset, count] of the light indices of a cluster
+            [[nodiscard]] std::pair<unsigned int, unsigned int> getCluster(int x, int y, int z) const;
+
+            [[nodiscard]] unsigned int getLightIndex(unsigned int i) const;
+
+        private:
+            std::vector<unsigned int> counts_;
+            std::vector<unsigned int> offsets_;
+            std::vector<unsigned int> indices_;
+        };
+
+    }// namespace gl
+
+}// namespace threepp
+
+#endif//THREEPP_GLCLUSTEREDLIGHTS_HPP
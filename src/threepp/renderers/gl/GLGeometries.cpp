@@ -39,7 +39,7 @@ struct GLGeometries::Impl {
                 scope_->attributes_.remove(value.get());
             }
 
-            geometry->removeEventListener("dispose", this);
+            geometry->removeEventListener(events::dispose, this);
 
             scope_->geometries_.erase(geometry);
 
@@ -84,7 +84,7 @@ struct GLGeometries::Impl {
 
         if (geometries_.count(geometry) && geometries_.at(geometry)) return;
 
-        geometry->addEventListener("dispose", &onGeometryDispose_);
+        geometry->addEventListener(events::dispose, &onGeometryDispose_);
 
         geometries_[geometry] = true;
 
@@ -192,6 +192,37 @@ struct GLGeometries::Impl {
 
         return wireframeAttributes_.at(geometry).get();
     }
+
+    void evict(BufferGeometry* geometry) {
+
+        if (geometry->hasIndex()) {
+
+            attributes_.remove(geometry->getIndex());
+        }
+
+        for (const auto& [name, value] : geometry->getAttributes()) {
+
+            attributes_.remove(value.get());
+        }
+
+        for (const auto& [name, array] : geometry->getMorphAttributes()) {
+
+            for (const auto& attribute : array) {
+
+                attributes_.remove(attribute.get());
+            }
+        }
+
+        if (wireframeAttributes_.count(geometry)) {
+
+            attributes_.remove(wireframeAttributes_.at(geometry).get());
+            wireframeAttributes_.erase(geometry);
+        }
+
+        bindingStates_.releaseStatesOfGeometry(geometry);
+
+        ++info_.memory.evictions;
+    }
 };
 
 
@@ -218,4 +249,9 @@ IntBufferAttribute* GLGeometries::getWireframeAttribute(BufferGeometry* geometry
     return pimpl_->getWireframeAttribute(geometry);
 }
 
+void GLGeometries::evict(BufferGeometry* geometry) {
+
+    pimpl_->evict(geometry);
+}
+
 gl::GLGeometries::~GLGeometries() = default;
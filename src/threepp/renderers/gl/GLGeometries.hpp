@@ -29,6 +29,9 @@ namespace threepp {
 
             IntBufferAttribute* getWireframeAttribute(BufferGeometry* geometry);
 
+            // Releases the GPU buffers of the geometry. They are re-uploaded on next use.
+            void evict(BufferGeometry* geometry);
+
             ~GLGeometries();
 
         private:
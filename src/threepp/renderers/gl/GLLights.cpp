@@ -17,7 +17,91 @@ namespace {
 
     bool shadowCastingLightsFirst(const Light* lightA, const Light* lightB) {
 
-        return (lightB->castShadow ? 1 : 0) > (lightA->castShadow ? 1 : 0);
+        return lightA->castShadow && !lightB->castShadow;
+    }
+
+    template<class T>
+    void hashCombine(size_t& seed, const T& value) {
+
+        seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    void hashMatrix(size_t& seed, const Matrix4& matrix) {
+
+        for (auto e : matrix.elements) hashCombine(seed, e);
+    }
+
+    // covers everything setup() reads from the lights, so an unchanged hash means unchanged uniforms
+    size_t computeLightsHash(const std::vector<Light*>& lights, bool clustered) {
+
+        size_t hash = lights.size();
+        hashCombine(hash, clustered);
+
+        for (auto light : lights) {
+
+            hashCombine(hash, light->id);
+            hashCombine(hash, light->castShadow);
+            hashCombine(hash, light->intensity);
+            hashCombine(hash, light->color.r);
+            hashCombine(hash, light->color.g);
+            hashCombine(hash, light->color.b);
+            hashMatrix(hash, *light->matrixWorld);
+
+            if (auto withTarget = dynamic_cast<LightWithTarget*>(light)) {
+
+                hashMatrix(hash, *withTarget->target->matrixWorld);
+            }
+
+            if (auto spotLight = light->as<SpotLight>()) {
+
+                hashCombine(hash, spotLight->distance);
+                hashCombine(hash, spotLight->angle);
+                hashCombine(hash, spotLight->penumbra);
+                hashCombine(hash, spotLight->decay);
+
+            } else if (auto pointLight = light->as<PointLight>()) {
+
+                hashCombine(hash, pointLight->distance);
+                hashCombine(hash, pointLight->decay);
+
+            } else if (auto hemisphereLight = light->as<HemisphereLight>()) {
+
+                hashCombine(hash, hemisphereLight->groundColor.r);
+                hashCombine(hash, hemisphereLight->groundColor.g);
+                hashCombine(hash, hemisphereLight->groundColor.b);
+
+            } else if (auto lightProbe = light->as<LightProbe>()) {
+
+                for (const auto& coefficient : lightProbe->sh.getCoefficients()) {
+
+                    hashCombine(hash, coefficient.x);
+                    hashCombine(hash, coefficient.y);
+                    hashCombine(hash, coefficient.z);
+                }
+            }
+
+            auto withShadow = dynamic_cast<LightWithShadow*>(light);
+            if (light->castShadow && withShadow) {
+
+                const auto& shadow = withShadow->shadow;
+
+                hashCombine(hash, shadow->bias);
+                hashCombine(hash, shadow->normalBias);
+                hashCombine(hash, shadow->radius);
+                hashCombine(hash, shadow->mapSize.x);
+                hashCombine(hash, shadow->mapSize.y);
+                hashCombine(hash, shadow->map.get());
+                hashCombine(hash, shadow->camera->near);
+                hashCombine(hash, shadow->camera->far);
+            }
+        }
+
+        return hash;
+    }
+
+    bool isClustered(const Light* light, bool clustered) {
+
+        return clustered && !light->castShadow && (light->is<PointLight>() || light->is<SpotLight>());
     }
 
     template<class T>
@@ -31,7 +115,20 @@ namespace {
 }// namespace
 
 
-void GLLights::setup(std::vector<Light*>& lights) {
+void GLLights::setup(std::vector<Light*>& lights, bool clustered) {
+
+    const auto lightsHash = computeLightsHash(lights, clustered);
+
+    if (lightsHash_ == lightsHash) {
+
+        // same lights in the same order, reuse last sorting and uniforms
+        lights = sortedLights_;
+        lightsChanged_ = false;
+        return;
+    }
+
+    lightsHash_ = lightsHash;
+    lightsChanged_ = true;
 
     float r = 0, g = 0, b = 0;
 
@@ -48,9 +145,18 @@ void GLLights::setup(std::vector<Light*>& lights) {
 
     std::stable_sort(lights.begin(), lights.end(), shadowCastingLightsFirst);
 
+    state.clustered = clustered;
+    clusteredLights_.clear();
+
     for (auto light : lights) {
 
         auto& color = light->color;
+
+        if (isClustered(light, clustered)) {
+
+            clusteredLights_.emplace_back(light);
+            continue;
+        }
         auto intensity = light->intensity;
 
         if (light->is<AmbientLight>()) {
@@ -189,6 +295,8 @@ void GLLights::setup(std::vector<Light*>& lights) {
 
     state.ambient.setRGB(r, g, b);
 
+    sortedLights_ = lights;
+
     auto& hash = state.hash;
 
     if (hash.directionalLength != directionalLength ||
@@ -197,7 +305,8 @@ void GLLights::setup(std::vector<Light*>& lights) {
         hash.hemiLength != hemiLength ||
         hash.numDirectionalShadows != numDirectionalShadows ||
         hash.numPointShadows != numPointShadows ||
-        hash.numSpotShadows != numSpotShadows) {
+        hash.numSpotShadows != numSpotShadows ||
+        hash.clustered != clustered) {
 
         state.directional.resize(directionalLength);
         state.spot.resize(spotLength);
@@ -223,12 +332,22 @@ void GLLights::setup(std::vector<Light*>& lights) {
         hash.numPointShadows = numPointShadows;
         hash.numSpotShadows = numSpotShadows;
 
+        hash.clustered = clustered;
+
         state.version = nextVersion++;
     }
 }
 
 void GLLights::setupView(std::vector<Light*>& lights, Camera* camera) {
 
+    size_t viewHash = 0;
+    hashMatrix(viewHash, camera->matrixWorldInverse);
+    hashMatrix(viewHash, camera->projectionMatrix);
+
+    if (!lightsChanged_ && viewHash_ == viewHash) return;
+
+    viewHash_ = viewHash;
+
     int directionalLength = 0;
     int pointLength = 0;
     int spotLength = 0;
@@ -238,6 +357,8 @@ void GLLights::setupView(std::vector<Light*>& lights, Camera* camera) {
 
     for (auto light : lights) {
 
+        if (isClustered(light, state.clustered)) continue;
+
         if (light->as<DirectionalLight>()) {
 
             auto l = light->as<DirectionalLight>();
@@ -298,4 +419,9 @@ void GLLights::setupView(std::vector<Light*>& lights, Camera* camera) {
             ++hemiLength;
         }
     }
+
+    if (state.clustered) {
+
+        clusters.update(clusteredLights_, *camera);
+    }
 }
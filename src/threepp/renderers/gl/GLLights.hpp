@@ -5,10 +5,13 @@
 
 #include "threepp/lights/lights.hpp"
 
+#include "threepp/renderers/gl/GLClusteredLights.hpp"
+
 #include "threepp/core/Uniform.hpp"
 #include "threepp/math/Vector2.hpp"
 #include "threepp/math/Vector3.hpp"
 
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -131,12 +134,18 @@ namespace threepp::gl {
                 int numDirectionalShadows = -1;
                 int numPointShadows = -1;
                 int numSpotShadows = -1;
+
+                int clustered = -1;
             };
 
             unsigned int version = 0;
 
             Hash hash{};
 
+            // point and spot lights without shadows are binned into clusters
+            // instead of the uniform arrays, so their count does not change the program
+            bool clustered = false;
+
             Color ambient{0, 0, 0};
             std::vector<Vector3> probe{9};
             std::vector<LightUniforms*> directional;
@@ -156,7 +165,9 @@ namespace threepp::gl {
 
         LightState state{};
 
-        void setup(std::vector<Light*>& lights);
+        GLClusteredLights clusters;
+
+        void setup(std::vector<Light*>& lights, bool clustered = false);
 
         void setupView(std::vector<Light*>& lights, Camera* camera);
 
@@ -164,6 +175,14 @@ namespace threepp::gl {
         UniformsCache cache_;
         ShadowUniformsCache shadowCache_;
 
+        std::vector<Light*> clusteredLights_;
+
+        // skips setup and setupView for unchanged lights and camera
+        std::optional<size_t> lightsHash_;
+        std::optional<size_t> viewHash_;
+        std::vector<Light*> sortedLights_;
+        bool lightsChanged_ = true;
+
         unsigned int nextVersion = 0;
     };
 
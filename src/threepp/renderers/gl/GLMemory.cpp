@@ -0,0 +1,88 @@
+
+#include "threepp/renderers/gl/GLMemory.hpp"
+
+#include "threepp/renderers/GLRenderTarget.hpp"
+
+#include <algorithm>
+
+using namespace threepp;
+
+size_t gl::bytesPerTexel(Format format, Type type) {
+
+    size_t channels;
+    switch (format) {
+        case Format::RGBA:
+        case Format::RGBAInteger:
+            channels = 4;
+            break;
+        case Format::RGB:
+        case Format::RGBInteger:
+            channels = 3;
+            break;
+        case Format::RG:
+        case Format::RGInteger:
+        case Format::LuminanceAlpha:
+            channels = 2;
+            break;
+        default:
+            channels = 1;
+            break;
+    }
+
+    switch (type) {
+        case Type::Float:
+        case Type::Int:
+        case Type::UnsignedInt:
+        case Type::UnsignedInt248:
+            return channels * 4;
+        case Type::HalfFloat:
+        case Type::Short:
+        case Type::UnsignedShort:
+            return channels * 2;
+        case Type::UnsignedShort4444:
+        case Type::UnsignedShort5551:
+        case Type::UnsignedShort565:
+            return 2;
+        default:
+            return channels;
+    }
+}
+
+size_t gl::textureBytes(size_t width, size_t height, size_t depth, Format format, Type type, bool mipmapped) {
+
+    const auto bytes = width * height * std::max<size_t>(depth, 1) * bytesPerTexel(format, type);
+
+    return mipmapped ? bytes + bytes / 3 : bytes;
+}
+
+size_t gl::renderTargetBytes(const GLRenderTarget& renderTarget, bool mipmapped) {
+
+    const auto& texture = *renderTarget.texture;
+    auto bytes = textureBytes(renderTarget.width, renderTarget.height, 1, texture.format, texture.type, mipmapped);
+
+    if (renderTarget.depthBuffer && !renderTarget.depthTexture) {
+
+        // DEPTH_COMPONENT16 or DEPTH_STENCIL (24/8)
+        bytes += static_cast<size_t>(renderTarget.width) * renderTarget.height * (renderTarget.stencilBuffer ? 4 : 2);
+    }
+
+    return bytes;
+}
+
+size_t gl::evictLeastRecentlyUsed(std::vector<EvictionCandidate>& candidates, const MemoryInfo& memory, size_t budget) {
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.lastUsedFrame < b.lastUsedFrame;
+    });
+
+    size_t evicted = 0;
+    for (const auto& candidate : candidates) {
+
+        if (memory.totalBytes() <= budget) break;
+
+        candidate.evict();
+        ++evicted;
+    }
+
+    return evicted;
+}
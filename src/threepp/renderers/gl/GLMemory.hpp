@@ -0,0 +1,62 @@
+
+#ifndef THREEPP_GLMEMORY_HPP
+#define THREEPP_GLMEMORY_HPP
+
+// Estimates of the GPU memory reported by GLInfo::memory, and eviction under GLRenderer::memoryBudget.
+
+#include "threepp/constants.hpp"
+#include "threepp/renderers/gl/GLInfo.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace threepp {
+
+    class GLRenderTarget;
+
+}// namespace threepp
+
+namespace threepp::gl {
+
+    size_t bytesPerTexel(Format format, Type type);
+
+    // a full mip chain adds a third to the size of the base level
+    size_t textureBytes(size_t width, size_t height, size_t depth, Format format, Type type, bool mipmapped);
+
+    // the color texture and, without a depth texture, the depth/stencil renderbuffer
+    size_t renderTargetBytes(const GLRenderTarget& renderTarget, bool mipmapped);
+
+    // replaces the bytes recorded for one resource, keeping the total in step
+    inline void trackBytes(size_t& total, size_t& recorded, size_t bytes) {
+
+        total -= recorded;
+        recorded = bytes;
+        total += bytes;
+    }
+
+    // removes a texture from the counts when its GL storage is released, by eviction or disposal.
+    // Returns false if the texture holds no storage, so that releasing it twice counts once.
+    inline bool untrackTexture(MemoryInfo& memory, bool& allocated, size_t& bytes) {
+
+        if (!allocated) return false;
+
+        allocated = false;
+        trackBytes(memory.textureBytes, bytes, 0);
+        --memory.textures;
+
+        return true;
+    }
+
+    // a resource that can be released and is restored the next time it is used
+    struct EvictionCandidate {
+        size_t lastUsedFrame;
+        std::function<void()> evict;
+    };
+
+    // evicts least recently used candidates first until memory fits the budget, returns the number evicted.
+    // Candidates used in the same frame are evicted in the given order.
+    size_t evictLeastRecentlyUsed(std::vector<EvictionCandidate>& candidates, const MemoryInfo& memory, size_t budget);
+
+}// namespace threepp::gl
+
+#endif//THREEPP_GLMEMORY_HPP
@@ -25,11 +25,33 @@ struct GLObjects::Impl {
         void onEvent(Event& event) override {
             auto instancedMesh = static_cast<InstancedMesh*>(event.target);
 
-            instancedMesh->removeEventListener("dispose", this);
+            instancedMesh->removeEventListener(events::dispose, this);
 
             scope->attributes_.remove(instancedMesh->instanceMatrix.get());
 
             if (instancedMesh->instanceColor) scope->attributes_.remove(instancedMesh->instanceColor.get());
+
+            for (const auto& level : instancedMesh->levels()) {
+
+                if (level.instanceMatrix) scope->attributes_.remove(level.instanceMatrix.get());
+                if (level.instanceColor) scope->attributes_.remove(level.instanceColor.get());
+            }
+        }
+
+    private:
+        GLObjects::Impl* scope;
+    };
+
+    struct OnGeometryDispose: public EventListener {
+
+        explicit OnGeometryDispose(GLObjects::Impl* scope): scope(scope) {}
+
+        void onEvent(Event& event) override {
+            auto geometry = static_cast<BufferGeometry*>(event.target);
+
+            geometry->removeEventListener(events::dispose, this);
+
+            scope->updateMap_.erase(geometry);
         }
 
     private:
@@ -41,50 +63,105 @@ struct GLObjects::Impl {
     GLAttributes& attributes_;
 
     OnInstancedMeshDispose onInstancedMeshDispose;
+    OnGeometryDispose onGeometryDispose;
 
+    // geometries listen for dispose while they are in the map
     std::unordered_map<BufferGeometry*, size_t> updateMap_;
 
     Impl(GLGeometries& geometries, GLAttributes& attributes, GLInfo& info)
         : attributes_(attributes),
           geometries_(geometries), info_(info),
-          onInstancedMeshDispose(this) {}
+          onInstancedMeshDispose(this),
+          onGeometryDispose(this) {}
+
+    ~Impl() {
+
+        dispose();
+    }
 
     BufferGeometry* update(Object3D* object) {
 
         const auto frame = info_.render.frame;
 
         auto geometry = object->geometry();
+        updateGeometry(object, geometry, frame);
+
+        if (auto instancedMesh = object->as<InstancedMesh>()) {
+
+            if (!object->hasEventListener(events::dispose, &onInstancedMeshDispose)) {
+
+                object->addEventListener(events::dispose, &onInstancedMeshDispose);
+            }
+
+            attributes_.update(instancedMesh->instanceMatrix.get(), GL_ARRAY_BUFFER);
+
+            if (instancedMesh->instanceColor != nullptr) {
+
+                attributes_.update(instancedMesh->instanceColor.get(), GL_ARRAY_BUFFER);
+            }
+
+            if (instancedMesh->cullInstances) {
+
+                for (const auto& level : instancedMesh->levels()) {
+
+                    if (level.count == 0) continue;
+
+                    updateGeometry(object, level.geometry.get(), frame);
+
+                    attributes_.update(level.instanceMatrix.get(), GL_ARRAY_BUFFER);
+                    if (level.instanceColor) attributes_.update(level.instanceColor.get(), GL_ARRAY_BUFFER);
+                }
+            }
+        }
+
+        return geometry;
+    }
+
+    void updateGeometry(Object3D* object, BufferGeometry* geometry, size_t frame) {
+
         geometries_.get(object, geometry);
 
         // Update once per frame
 
-        if (!updateMap_.count(geometry) || updateMap_[geometry] != frame) {
+        const auto it = updateMap_.find(geometry);
+        if (it == updateMap_.end() || it->second != frame) {
+
+            if (it == updateMap_.end()) geometry->addEventListener(events::dispose, &onGeometryDispose);
 
             geometries_.update(geometry);
 
             updateMap_[geometry] = frame;
         }
+    }
 
-        if (auto instancedMesh = object->as<InstancedMesh>()) {
-
-            if (!object->hasEventListener("dispose", &onInstancedMeshDispose)) {
+    std::vector<std::pair<size_t, BufferGeometry*>> getEvictionCandidates(size_t frame) const {
 
-                object->addEventListener("dispose", &onInstancedMeshDispose);
-            }
+        std::vector<std::pair<size_t, BufferGeometry*>> candidates;
+        for (const auto& [geometry, lastFrame] : updateMap_) {
 
-            attributes_.update(instancedMesh->instanceMatrix.get(), GL_ARRAY_BUFFER);
+            if (lastFrame < frame) {
 
-            if (instancedMesh->instanceColor != nullptr) {
-
-                attributes_.update(instancedMesh->instanceColor.get(), GL_ARRAY_BUFFER);
+                candidates.emplace_back(lastFrame, geometry);
             }
         }
 
-        return geometry;
+        return candidates;
+    }
+
+    void evict(BufferGeometry* geometry) {
+
+        geometry->removeEventListener(events::dispose, &onGeometryDispose);
+        updateMap_.erase(geometry);
+        geometries_.evict(geometry);
     }
 
     void dispose() {
 
+        for (const auto& [geometry, frame] : updateMap_) {
+
+            geometry->removeEventListener(events::dispose, &onGeometryDispose);
+        }
+
         updateMap_.clear();
     }
 };
@@ -97,6 +174,16 @@ BufferGeometry* GLObjects::update(Object3D* object) {
 gl::GLObjects::GLObjects(GLGeometries& geometries, GLAttributes& attributes, GLInfo& info)
     : pimpl_(std::make_unique<Impl>(geometries, attributes, info)) {}
 
+std::vector<std::pair<size_t, BufferGeometry*>> GLObjects::getEvictionCandidates(size_t frame) const {
+
+    return pimpl_->getEvictionCandidates(frame);
+}
+
+void GLObjects::evict(BufferGeometry* geometry) {
+
+    pimpl_->evict(geometry);
+}
+
 void gl::GLObjects::dispose() {
 
     pimpl_->dispose();
@@ -6,6 +6,8 @@
 #include <threepp/core/BufferGeometry.hpp>
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace threepp {
 
@@ -24,6 +26,11 @@ namespace threepp {
 
             BufferGeometry* update(Object3D* object);
 
+            // Geometries not updated since the given frame, paired with the frame they were last used.
+            std::vector<std::pair<size_t, BufferGeometry*>> getEvictionCandidates(size_t frame) const;
+
+            void evict(BufferGeometry* geometry);
+
             void dispose();
 
             ~GLObjects();
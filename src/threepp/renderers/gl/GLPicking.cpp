@@ -0,0 +1,593 @@
+
+#include "threepp/renderers/gl/GLPicking.hpp"
+
+#include "threepp/cameras/Camera.hpp"
+#include "threepp/core/BufferGeometry.hpp"
+#include "threepp/materials/RawShaderMaterial.hpp"
+#include "threepp/objects/BatchedMesh.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/objects/LineSegments.hpp"
+#include "threepp/objects/Points.hpp"
+#include "threepp/objects/SkinnedMesh.hpp"
+#include "threepp/renderers/GLRenderTarget.hpp"
+#include "threepp/renderers/gl/GLCapabilities.hpp"
+#include "threepp/renderers/gl/GLState.hpp"
+
+#ifndef EMSCRIPTEN
+#include <glad/glad.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    enum Variant {
+        Plain,
+        Instanced,
+        Skinned,
+        PointSprites,
+        VariantCount
+    };
+
+#ifndef EMSCRIPTEN
+    const std::string version = "#version 330 core\n";
+#else
+    const std::string version = "#version 300 es\n";
+#endif
+
+    const std::string vertexShader = R"(
+#define texture2D texture
+
+precision highp float;
+precision highp int;
+
+uniform mat4 modelViewMatrix;
+uniform mat4 projectionMatrix;
+
+uniform float pointSize;
+uniform float pointScale;
+
+in vec3 position;
+
+#ifdef USE_INSTANCING
+	in mat4 instanceMatrix;
+#endif
+
+#ifdef USE_SKINNING
+	in vec4 skinIndex;
+	in vec4 skinWeight;
+#endif
+
+#include <skinning_pars_vertex>
+
+flat out int vInstanceId;
+
+void main() {
+
+	#include <skinbase_vertex>
+	#include <begin_vertex>
+	#include <skinning_vertex>
+	#include <project_vertex>
+
+	#ifdef USE_POINTS
+
+		gl_PointSize = pointSize;
+		if ( pointScale > 0.0 ) gl_PointSize *= ( pointScale / - mvPosition.z );
+
+	#endif
+
+	vInstanceId = gl_InstanceID;
+
+}
+)";
+
+    const std::string fragmentShader = R"(
+precision highp float;
+precision highp int;
+
+uniform int objectId;
+uniform int primitiveOffset;
+
+flat in int vInstanceId;
+
+layout(location = 0) out uvec4 pickId;
+
+void main() {
+
+	// gl_PrimitiveID needs geometry shader support on GLSL ES
+	#ifdef GL_ES
+		uint primitive = 0xffffffffu;
+	#else
+		uint primitive = uint( primitiveOffset + gl_PrimitiveID );
+	#endif
+
+	pickId = uvec4( uint( objectId ), uint( vInstanceId ), primitive, floatBitsToUint( gl_FragCoord.z ) );
+
+}
+)";
+
+    std::shared_ptr<RawShaderMaterial> createMaterial(const std::string& defines) {
+
+        auto material = RawShaderMaterial::create();
+        material->vertexShader = version + defines + vertexShader;
+        material->fragmentShader = version + fragmentShader;
+        // integer targets cannot blend
+        material->blending = Blending::None;
+        material->uniforms = std::make_shared<UniformMap>(UniformMap{
+                {"objectId", Uniform(0)},
+                {"primitiveOffset", Uniform(0)},
+                {"pointSize", Uniform(1.f)},
+                {"pointScale", Uniform(0.f)}});
+
+        return material;
+    }
+
+    // the first vertex or index of a draw, as in GLRenderer::renderBufferDirect
+    int drawStart(const BufferGeometry& geometry, const std::optional<GeometryGroup>& group) {
+
+        return std::max(geometry.drawRange.start, group ? group->start : 0);
+    }
+
+}// namespace
+
+struct GLPicking::Impl {
+
+    struct Request {
+        PickData data;
+        // Object3D::id of each object id, resolved when the pixels arrive
+        std::vector<unsigned int> objectIds;
+
+        Callback callback;
+
+        unsigned int buffer = 0;
+        GLsync fence = nullptr;
+    };
+
+    // objects referenced by requests, forgotten when they are destroyed
+    struct Watch {
+        Object3D* object;
+        size_t requests;
+    };
+
+    struct OnObjectDestroyed: EventListener {
+
+        explicit OnObjectDestroyed(Impl* scope): scope(scope) {}
+
+        void onEvent(Event& event) override {
+
+            scope->forget(*static_cast<Object3D*>(event.target));
+        }
+
+        Impl* scope;
+    };
+
+    std::array<std::shared_ptr<RawShaderMaterial>, VariantCount> materials{
+            createMaterial(""),
+            createMaterial("#define USE_INSTANCING\n"),
+            createMaterial("#define USE_SKINNING\n#define BONE_TEXTURE\n"),
+            createMaterial("#define USE_POINTS\n")};
+
+    std::unique_ptr<GLRenderTarget> target;
+
+    // objects of the current pass, id - 1 indexes objects
+    std::unordered_map<Object3D*, uint32_t> ids;
+    Request current;
+
+    std::deque<Request> pending;
+    std::vector<unsigned int> freeBuffers;
+
+    OnObjectDestroyed onObjectDestroyed{this};
+    std::unordered_map<unsigned int, Watch> watched;
+
+    ~Impl() {
+
+        for (auto& [id, watch] : watched) watch.object->removeEventListener(events::destroyed, &onObjectDestroyed);
+    }
+
+    void watch(Object3D& object) {
+
+        auto [it, inserted] = watched.try_emplace(object.id, Watch{&object, 0});
+        if (inserted) object.addEventListener(events::destroyed, &onObjectDestroyed);
+
+        ++it->second.requests;
+    }
+
+    // drops the references of a request
+    void release(const Request& request) {
+
+        for (auto id : request.objectIds) {
+
+            const auto it = watched.find(id);
+            if (it == watched.end() || --it->second.requests > 0) continue;
+
+            it->second.object->removeEventListener(events::destroyed, &onObjectDestroyed);
+            watched.erase(it);
+        }
+    }
+
+    void forget(Object3D& object) {
+
+        object.removeEventListener(events::destroyed, &onObjectDestroyed);
+        watched.erase(object.id);
+    }
+
+    GLRenderTarget* begin(unsigned int size) {
+
+        if (!target) {
+
+            GLRenderTarget::Options options;
+            options.format = Format::RGBAInteger;
+            options.type = Type::UnsignedInt;
+            options.minFilter = Filter::Nearest;
+            options.magFilter = Filter::Nearest;
+
+            target = GLRenderTarget::create(size, size, options);
+
+        } else if (target->width != size) {
+
+            target->setSize(size, size);
+        }
+
+        // a pass that was never ended
+        release(current);
+
+        ids.clear();
+        current = Request();
+        current.data.size = size;
+
+        return target.get();
+    }
+
+    Material* material(Object3D* object, BufferGeometry* geometry, Material* material, const std::optional<GeometryGroup>& group, int pixelRatio, float height) {
+
+        // the id shaders do not read the matrices of batched geometries
+        if (object->is<BatchedMesh>()) return nullptr;
+
+        Variant variant;
+        PickPrimitive primitive;
+        auto start = drawStart(*geometry, group);
+
+        const auto wireframe = dynamic_cast<MaterialWithWireframe*>(material);
+        const bool isWireframe = wireframe && wireframe->wireframe;
+
+        if (object->is<Points>()) {
+
+            variant = PointSprites;
+            primitive = PickPrimitive::Vertex;
+
+        } else if (object->is<Line>()) {
+
+            variant = Plain;
+            primitive = object->is<LineSegments>() ? PickPrimitive::Segment : PickPrimitive::Vertex;
+            if (object->is<LineSegments>()) start /= 2;
+
+        } else if (object->is<Mesh>()) {
+
+            if (object->is<InstancedMesh>()) {
+
+                variant = Instanced;
+
+            } else if (object->is<SkinnedMesh>() && GLCapabilities::instance().floatVertexTextures) {
+
+                variant = Skinned;
+
+            } else {
+
+                variant = Plain;
+            }
+
+            primitive = isWireframe ? PickPrimitive::None : PickPrimitive::Face;
+            start /= 3;
+
+        } else {
+
+            // sprites are drawn by their own shader
+            return nullptr;
+        }
+
+        auto [it, inserted] = ids.try_emplace(object, static_cast<uint32_t>(current.objectIds.size() + 1));
+        if (inserted) {
+
+            current.objectIds.emplace_back(object->id);
+            current.data.primitives.emplace_back(primitive);
+            watch(*object);
+        }
+
+        auto& result = materials[variant];
+        result->side = material->side;
+        result->wireframe = isWireframe;
+
+        auto& uniforms = *result->uniforms;
+        uniforms.at("objectId").setValue(static_cast<int>(it->second));
+        uniforms.at("primitiveOffset").setValue(start);
+
+        if (auto size = dynamic_cast<MaterialWithSize*>(material)) {
+
+            uniforms.at("pointSize").setValue(size->size * static_cast<float>(pixelRatio));
+            uniforms.at("pointScale").setValue(size->sizeAttenuation ? height * 0.5f : 0.f);
+        }
+
+        result->uniformsNeedUpdate = true;
+
+        return result.get();
+    }
+
+    void end(const Camera& camera, const Vector2& center, const Vector2& halfSize, Callback callback) {
+
+        auto& request = current;
+        auto& data = request.data;
+        data.inverse.multiplyMatrices(*camera.matrixWorld, camera.projectionMatrixInverse);
+        data.origin.setFromMatrixPosition(*camera.matrixWorld);
+        data.center.copy(center);
+        data.halfSize.copy(halfSize);
+        request.callback = std::move(callback);
+
+        const auto count = static_cast<size_t>(data.size) * data.size * 4;
+        const auto size = data.size;
+
+#ifndef EMSCRIPTEN
+
+        if (freeBuffers.empty()) {
+
+            GLuint buffer;
+            glGenBuffers(1, &buffer);
+            freeBuffers.emplace_back(buffer);
+        }
+
+        request.buffer = freeBuffers.back();
+        freeBuffers.pop_back();
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, request.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(count * sizeof(uint32_t)), nullptr, GL_STREAM_READ);
+        glReadPixels(0, 0, size, size, GL_RGBA_INTEGER, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        request.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+#else
+
+        // WebGL cannot map buffers, the pixels are read right away and delivered on the next poll
+        data.pixels.resize(count);
+        glReadPixels(0, 0, size, size, GL_RGBA_INTEGER, GL_UNSIGNED_INT, data.pixels.data());
+
+#endif
+
+        pending.emplace_back(std::move(request));
+        current = Request();
+        ids.clear();
+    }
+
+    // true once the pixels of the request are in its data
+    bool fetch(Request& request, bool wait) {
+
+#ifndef EMSCRIPTEN
+
+        while (true) {
+
+            const auto status = glClientWaitSync(request.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? 1000000000 : 0);
+
+            if (status == GL_TIMEOUT_EXPIRED) {
+
+                if (wait) continue;
+                return false;
+            }
+
+            break;
+        }
+
+        glDeleteSync(request.fence);
+        request.fence = nullptr;
+
+        const auto count = static_cast<size_t>(request.data.size) * request.data.size * 4;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, request.buffer);
+        if (auto data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(count * sizeof(uint32_t)), GL_MAP_READ_BIT)) {
+
+            auto& pixels = request.data.pixels;
+            pixels.resize(count);
+            std::memcpy(pixels.data(), data, count * sizeof(uint32_t));
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        freeBuffers.emplace_back(request.buffer);
+        request.buffer = 0;
+
+#endif
+
+        return true;
+    }
+
+    void poll(bool wait) {
+
+        while (!pending.empty()) {
+
+            if (!fetch(pending.front(), wait)) return;
+
+            // the callback may start another pick
+            auto request = std::move(pending.front());
+            pending.pop_front();
+
+            // objects destroyed since the pick resolve to null
+            auto& data = request.data;
+            data.objects.clear();
+            for (auto id : request.objectIds) {
+
+                const auto it = watched.find(id);
+                data.objects.emplace_back(it != watched.end() ? it->second.object : nullptr);
+            }
+            release(request);
+
+            if (request.callback) request.callback(decodePicks(data));
+        }
+    }
+
+    void dispose() {
+
+        for (auto& request : pending) {
+
+#ifndef EMSCRIPTEN
+            glDeleteSync(request.fence);
+            freeBuffers.emplace_back(request.buffer);
+#endif
+            release(request);
+        }
+
+        release(current);
+        current = Request();
+
+#ifndef EMSCRIPTEN
+
+        if (!freeBuffers.empty()) glDeleteBuffers(static_cast<GLsizei>(freeBuffers.size()), freeBuffers.data());
+
+#endif
+
+        pending.clear();
+        freeBuffers.clear();
+
+        if (target) target->dispose();
+        target = nullptr;
+
+        for (auto& material : materials) material->dispose();
+    }
+};
+
+std::vector<Intersection> gl::decodePicks(const PickData& data) {
+
+    struct Key {
+        uint32_t object, instance, primitive;
+
+        bool operator==(const Key& other) const {
+
+            return object == other.object && instance == other.instance && primitive == other.primitive;
+        }
+    };
+
+    struct Hash {
+        size_t operator()(const Key& key) const {
+
+            return (static_cast<size_t>(key.object) * 73856093) ^ (static_cast<size_t>(key.instance) * 19349663) ^ (static_cast<size_t>(key.primitive) * 83492791);
+        }
+    };
+
+    std::unordered_map<Key, Intersection, Hash> hits;
+
+    const auto size = static_cast<float>(data.size);
+    const auto& pixels = data.pixels;
+
+    for (size_t i = 0; i < pixels.size() / 4; ++i) {
+
+        const auto* pixel = &pixels[i * 4];
+        const auto id = pixel[0];
+
+        if (id == pickNoHit || id > data.objects.size()) continue;
+
+        float depth;
+        std::memcpy(&depth, &pixel[3], sizeof(float));
+
+        const auto x = static_cast<float>(i % data.size);
+        const auto y = static_cast<float>(i / data.size);
+
+        Vector3 point(
+                data.center.x + ((x + 0.5f) / size * 2 - 1) * data.halfSize.x,
+                data.center.y + ((y + 0.5f) / size * 2 - 1) * data.halfSize.y,
+                depth * 2 - 1);
+        point.applyMatrix4(data.inverse);
+
+        const auto distance = point.distanceTo(data.origin);
+
+        const Key key{id, pixel[1], pixel[2]};
+        if (auto it = hits.find(key); it != hits.end() && it->second.distance <= distance) continue;
+
+        auto object = data.objects[id - 1];
+        if (!object) continue;
+
+        Intersection intersection;
+        intersection.distance = distance;
+        intersection.point = point;
+        intersection.object = object;
+
+        if (object->is<InstancedMesh>()) intersection.instanceId = static_cast<int>(pixel[1]);
+
+        if (pixel[2] != std::numeric_limits<uint32_t>::max()) {
+
+            const auto primitive = static_cast<int>(pixel[2]);
+
+            switch (data.primitives[id - 1]) {
+                case PickPrimitive::Face:
+                    intersection.faceIndex = primitive;
+                    break;
+                case PickPrimitive::Vertex:
+                    intersection.index = primitive;
+                    break;
+                case PickPrimitive::Segment:
+                    intersection.index = primitive * 2;
+                    break;
+                case PickPrimitive::None:
+                    break;
+            }
+        }
+
+        hits.insert_or_assign(key, intersection);
+    }
+
+    std::vector<Intersection> result;
+    result.reserve(hits.size());
+    for (auto& [key, intersection] : hits) result.emplace_back(intersection);
+
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.distance < b.distance; });
+
+    return result;
+}
+
+GLPicking::GLPicking()
+    : pimpl_(std::make_unique<Impl>()) {}
+
+GLRenderTarget* GLPicking::begin(unsigned int size) {
+
+    return pimpl_->begin(size);
+}
+
+void GLPicking::clear(GLState& state) {
+
+    state.colorBuffer.setMask(true);
+    state.depthBuffer.setMask(true);
+
+    const GLuint none[4]{pickNoHit, 0, 0, 0};
+    glClearBufferuiv(GL_COLOR, 0, none);
+
+    const GLfloat far = 1;
+    glClearBufferfv(GL_DEPTH, 0, &far);
+}
+
+Material* GLPicking::material(Object3D* object, BufferGeometry* geometry, Material* material, std::optional<GeometryGroup> group, int pixelRatio, float height) {
+
+    return pimpl_->material(object, geometry, material, group, pixelRatio, height);
+}
+
+void GLPicking::end(const Camera& camera, const Vector2& center, const Vector2& halfSize, Callback callback) {
+
+    pimpl_->end(camera, center, halfSize, std::move(callback));
+}
+
+void GLPicking::poll(bool wait) {
+
+    pimpl_->poll(wait);
+}
+
+void GLPicking::dispose() {
+
+    pimpl_->dispose();
+}
+
+GLPicking::~GLPicking() = default;
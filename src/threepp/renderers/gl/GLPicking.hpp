@@ -0,0 +1,95 @@
+
+#ifndef THREEPP_GLPICKING_HPP
+#define THREEPP_GLPICKING_HPP
+
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/core/misc.hpp"
+#include "threepp/math/Matrix4.hpp"
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace threepp {
+
+    class BufferGeometry;
+    class Camera;
+    class GLRenderTarget;
+    class Material;
+    class Object3D;
+
+    namespace gl {
+
+        class GLState;
+
+        // an object id of 0 marks pixels without a hit, object id i > 0 is PickData::objects[i - 1]
+        constexpr uint32_t pickNoHit = 0;
+
+        // what the primitive id of an object counts
+        enum class PickPrimitive {
+            None,
+            Face,
+            Vertex, // Intersection::index of a point or a line strip segment
+            Segment,// Intersection::index is the first vertex of the segment
+        };
+
+        // the pixels of a pick region, with what is needed to turn them into intersections
+        struct PickData {
+            unsigned int size = 0;
+            // object id, instance id, primitive id and depth bits of each pixel
+            std::vector<uint32_t> pixels;
+
+            // objects that are gone by the time the pixels arrive are null, and left out
+            std::vector<Object3D*> objects;
+            std::vector<PickPrimitive> primitives;
+
+            // unprojects the region of the camera, as it was when picking
+            Matrix4 inverse;
+            Vector3 origin;
+            Vector2 center;
+            Vector2 halfSize;
+        };
+
+        // one intersection per distinct object, instance and primitive, nearest first
+        std::vector<Intersection> decodePicks(const PickData& data);
+
+        // GPU picking. Object id, instance id, primitive id and depth of each pixel of a small region are
+        // rendered into an RGBA32UI target, then read back through pixel buffer objects guarded by fences,
+        // so that the CPU never waits for the GPU.
+        struct GLPicking {
+
+            using Callback = std::function<void(const std::vector<Intersection>&)>;
+
+            GLPicking();
+
+            // starts a pass over a region of size x size pixels, returning its target
+            GLRenderTarget* begin(unsigned int size);
+
+            // clears the bound target to no hit
+            void clear(GLState& state);
+
+            // the material drawing the ids of a render item, or nullptr if the object cannot be picked
+            Material* material(Object3D* object, BufferGeometry* geometry, Material* material, std::optional<GeometryGroup> group, int pixelRatio, float height);
+
+            // starts reading back the bound target. center and halfSize locate the region in the normalized device
+            // coordinates of the camera, which must hold its own projection again.
+            void end(const Camera& camera, const Vector2& center, const Vector2& halfSize, Callback callback);
+
+            // calls back the picks whose pixels have arrived, in order. With wait, blocks until all have.
+            void poll(bool wait);
+
+            void dispose();
+
+            ~GLPicking();
+
+        private:
+            struct Impl;
+            std::unique_ptr<Impl> pimpl_;
+        };
+
+    }// namespace gl
+
+}// namespace threepp
+
+#endif//THREEPP_GLPICKING_HPP
@@ -2,6 +2,7 @@
 #include "threepp/renderers/gl/GLProgram.hpp"
 
 #include "threepp/renderers/gl/GLBindingStates.hpp"
+#include "threepp/renderers/gl/GLClusteredLights.hpp"
 #include "threepp/renderers/gl/GLPrograms.hpp"
 #include "threepp/renderers/gl/GLUniforms.hpp"
 
@@ -258,6 +259,17 @@ namespace {
         return shadowMapTypeDefine;
     }
 
+    std::string generateClusteredLightsDefines() {
+
+        std::stringstream ss;
+        ss << "#define USE_CLUSTERED_LIGHTS\n"
+           << "#define CLUSTER_GRID_X " << GLClusteredLights::gridX << "\n"
+           << "#define CLUSTER_GRID_Y " << GLClusteredLights::gridY << "\n"
+           << "#define CLUSTER_GRID_Z " << GLClusteredLights::gridZ;
+
+        return ss.str();
+    }
+
     std::string generateEnvMapTypeDefine(const ProgramParameters* parameters) {
 
         std::string envMapTypeDefine = "ENVMAP_TYPE_CUBE";
@@ -341,6 +353,7 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
     auto envMapTypeDefine = generateEnvMapTypeDefine(parameters);
     auto envMapModeDefine = generateEnvMapModeDefine(parameters);
     auto envMapBlendingDefine = generateEnvMapBlendingDefine(parameters);
+    auto clusteredLightsDefines = generateClusteredLightsDefines();
 
     auto gammaFactorDefine = (renderer->gammaFactor > 0) ? renderer->gammaFactor : 1.f;
 
@@ -401,6 +414,8 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
                     parameters->instancing ? "#define USE_INSTANCING" : "",
                     parameters->instancingColor ? "#define USE_INSTANCING_COLOR" : "",
 
+                    parameters->batching ? "#define USE_BATCHING" : "",
+
                     parameters->supportsVertexTextures ? "#define VERTEX_TEXTURES" : "",
 
                     "#define GAMMA_FACTOR " + std::to_string(gammaFactorDefine),
@@ -451,6 +466,8 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
                     parameters->shadowMapEnabled ? "#define USE_SHADOWMAP" : "",
                     parameters->shadowMapEnabled ? "#define " + shadowMapTypeDefine : "",
 
+                    parameters->clusteredLights ? clusteredLightsDefines : "",
+
                     parameters->sizeAttenuation ? "#define USE_SIZEATTENUATION" : "",
 
                     parameters->logarithmicDepthBuffer ? "#define USE_LOGDEPTHBUF" : "",
@@ -475,6 +492,12 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
 
                     "#endif",
 
+                    "#ifdef USE_BATCHING",
+
+                    "	attribute float batchId;",
+
+                    "#endif",
+
                     "attribute vec3 position;",
                     "attribute vec3 normal;",
                     "attribute vec2 uv;",
@@ -601,6 +624,8 @@ GLProgram::GLProgram(const GLRenderer* renderer, std::string cacheKey, const Pro
 
                     parameters->physicallyCorrectLights ? "#define PHYSICALLY_CORRECT_LIGHTS" : "",
 
+                    parameters->clusteredLights ? clusteredLightsDefines : "",
+
                     parameters->logarithmicDepthBuffer ? "#define USE_LOGDEPTHBUF" : "",
 
                     "uniform mat4 viewMatrix;",
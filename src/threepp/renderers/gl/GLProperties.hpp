@@ -21,12 +21,23 @@ namespace threepp::gl {
         std::optional<int> maxMipLevel{};
         std::optional<unsigned int> glTexture{};
         unsigned int version{};
+
+        size_t bytes{};
+        size_t lastUsedFrame{};
+
+        // texture streaming
+        bool streaming{};
+        bool streamingHinted{};
+        int residentLevel{};
+        int requestedLevel{};
     };
 
     struct RenderTargetProperties {
 
         std::optional<unsigned int> glFramebuffer;
         std::optional<unsigned int> glDepthbuffer;
+
+        size_t bytes{};
     };
 
     struct MaterialProperties {
@@ -46,6 +57,7 @@ namespace threepp::gl {
 
         std::optional<Encoding> outputEncoding;
         bool instancing{};
+        bool batching{};
         bool skinning{};
         bool vertexAlphas{};
 
@@ -38,9 +38,9 @@ void GLRenderState::pushShadow(Light* shadowLight) {
     shadowsArray_.emplace_back(shadowLight);
 }
 
-void GLRenderState::setupLights() {
+void GLRenderState::setupLights(bool clustered) {
 
-    lights_.setup(lightsArray_);
+    lights_.setup(lightsArray_, clustered);
 }
 
 void GLRenderState::setupLightsView(Camera* camera) {
@@ -51,12 +51,12 @@ void GLRenderState::setupLightsView(Camera* camera) {
 
 std::shared_ptr<GLRenderState> GLRenderStates::get(Scene* scene, size_t renderCallDepth) {
 
-    if (renderCallDepth >= renderStates_[scene->uuid].size()) {
+    if (renderCallDepth >= renderStates_[scene->uuid()].size()) {
 
-        renderStates_[scene->uuid].emplace_back(std::make_shared<GLRenderState>());
+        renderStates_[scene->uuid()].emplace_back(std::make_shared<GLRenderState>());
     }
 
-    return renderStates_[scene->uuid].at(renderCallDepth);
+    return renderStates_[scene->uuid()].at(renderCallDepth);
 }
 
 void GLRenderStates::dispose() {
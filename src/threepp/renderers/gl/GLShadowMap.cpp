@@ -5,6 +5,7 @@
 #include "threepp/math/Frustum.hpp"
 #include "threepp/scenes/Scene.hpp"
 
+#include "threepp/objects/Group.hpp"
 #include "threepp/objects/Line.hpp"
 #include "threepp/objects/Mesh.hpp"
 #include "threepp/objects/Points.hpp"
@@ -76,6 +77,7 @@ struct GLShadowMap::Impl {
     GLObjects& _objects;
 
     const Frustum* _frustum;
+    std::vector<Object3D*> _staticObjects;
 
     Vector2 _shadowMapSize;
     Vector2 _viewportSize;
@@ -230,51 +232,89 @@ struct GLShadowMap::Impl {
         return result;
     }
 
-    void renderObject(GLRenderer& _renderer, Object3D* object, Camera* camera, Camera* shadowCamera, Light* light) {
+    void renderObject(GLRenderer& _renderer, Object3D* object, Camera* camera, Camera* shadowCamera, Light* light, const SceneBVH* bvh) {
 
         if (!object->visible) return;
 
+        // static subtrees are rendered from the bvh query
+        if (bvh && bvh->coversSubtree(*object)) return;
+
+        if (auto group = object->as<Group>(); group && _renderer.groupCulling && group->frustumCulled) {
+
+            const auto& bounds = group->subtreeBounds();
+            if (bounds && !_frustum->intersectsBox(*bounds)) return;
+        }
+
         bool visible = object->layers.test(camera->layers);
 
         if (visible && (object->is<Mesh>() || object->is<Line>() || object->is<Points>())) {
 
-            if ((object->castShadow || (object->receiveShadow && scope->type == ShadowMap::VSM)) && (!object->frustumCulled || _frustum->intersectsObject(*object))) {
+            if (castsShadow(object) && !(bvh && bvh->contains(*object)) && (!object->frustumCulled || _frustum->intersectsObject(*object))) {
 
-                object->modelViewMatrix.multiplyMatrices(shadowCamera->matrixWorldInverse, *object->matrixWorld);
+                renderDepth(_renderer, object, shadowCamera, light);
+            }
+        }
 
-                const auto geometry = _objects.update(object);
-                const auto material = object->materials();
+        for (auto& child : object->children) {
 
-                if (material.size() > 1) {
+            renderObject(_renderer, child, camera, shadowCamera, light, bvh);
+        }
+    }
 
-                    const auto& groups = geometry->groups;
+    // renders the static objects of the scene that intersect the shadow frustum
+    void renderStatic(GLRenderer& _renderer, const SceneBVH& bvh, Scene* scene, Camera* camera, Camera* shadowCamera, Light* light) {
 
-                    for (const auto& group : groups) {
+        _staticObjects.clear();
+        bvh.intersectFrustum(*_frustum, _staticObjects);
 
-                        if (material.size() > group.materialIndex) {
-                            const auto groupMaterial = material[group.materialIndex];
+        for (auto object : _staticObjects) {
 
-                            if (groupMaterial && groupMaterial->visible) {
+            if (!castsShadow(object) || !object->layers.test(camera->layers)) continue;
 
-                                const auto depthMaterial = getDepthMaterial(_renderer, object, geometry, groupMaterial, light, shadowCamera->near, shadowCamera->far);
+            // skipped, like in renderObject, if the object or an ancestor is hidden
+            auto ancestor = object;
+            while (ancestor && ancestor->visible && ancestor != scene) ancestor = ancestor->parent;
+            if (ancestor != scene || !scene->visible) continue;
 
-                                _renderer.renderBufferDirect(shadowCamera, nullptr, geometry, depthMaterial, object, group);
-                            }
-                        }
-                    }
+            renderDepth(_renderer, object, shadowCamera, light);
+        }
+    }
+
+    [[nodiscard]] bool castsShadow(const Object3D* object) const {
 
-                } else if (material.front()->visible) {
+        return object->castShadow || (object->receiveShadow && scope->type == ShadowMap::VSM);
+    }
+
+    void renderDepth(GLRenderer& _renderer, Object3D* object, Camera* shadowCamera, Light* light) {
+
+        object->modelViewMatrix.multiplyMatrices(shadowCamera->matrixWorldInverse, *object->matrixWorld);
+
+        const auto geometry = _objects.update(object);
+        const auto material = object->materials();
+
+        if (material.size() > 1) {
+
+            const auto& groups = geometry->groups;
+
+            for (const auto& group : groups) {
 
-                    auto depthMaterial = getDepthMaterial(_renderer, object, geometry, material.front(), light, shadowCamera->near, shadowCamera->far);
+                if (material.size() > group.materialIndex) {
+                    const auto groupMaterial = material[group.materialIndex];
 
-                    _renderer.renderBufferDirect(shadowCamera, nullptr, geometry, depthMaterial, object, std::nullopt);
+                    if (groupMaterial && groupMaterial->visible) {
+
+                        const auto depthMaterial = getDepthMaterial(_renderer, object, geometry, groupMaterial, light, shadowCamera->near, shadowCamera->far);
+
+                        _renderer.renderBufferDirect(shadowCamera, nullptr, geometry, depthMaterial, object, group);
+                    }
                 }
             }
-        }
 
-        for (auto& child : object->children) {
+        } else if (material.front()->visible) {
+
+            auto depthMaterial = getDepthMaterial(_renderer, object, geometry, material.front(), light, shadowCamera->near, shadowCamera->far);
 
-            renderObject(_renderer, child, camera, shadowCamera, light);
+            _renderer.renderBufferDirect(shadowCamera, nullptr, geometry, depthMaterial, object, std::nullopt);
         }
     }
 
@@ -391,7 +431,9 @@ struct GLShadowMap::Impl {
 
                 _frustum = &shadow->getFrustum();
 
-                renderObject(_renderer, scene, camera, shadow->camera.get(), light);
+                const auto bvh = scene->bvh.get();
+                renderObject(_renderer, scene, camera, shadow->camera.get(), light, bvh);
+                if (bvh) renderStatic(_renderer, *bvh, scene, camera, shadow->camera.get(), light);
             }
 
             // do blur pass for VSM
@@ -696,7 +696,7 @@ void gl::GLState::bindTexture(int glType, std::optional<int> glTexture) {
         currentBoundTextures[*currentTextureSlot] = boundTexture;
     }
 
-    auto boundTexture = currentBoundTextures.at(*currentTextureSlot);
+    auto& boundTexture = currentBoundTextures.at(*currentTextureSlot);
 
     if (boundTexture.type != glType || boundTexture.texture != glTexture) {
 
@@ -723,6 +723,18 @@ void gl::GLState::unbindTexture() {
     }
 }
 
+void gl::GLState::releaseTexture(int glTexture) {
+
+    for (auto& [slot, boundTexture] : currentBoundTextures) {
+
+        if (boundTexture.texture == glTexture) {
+
+            boundTexture.type = std::nullopt;
+            boundTexture.texture = std::nullopt;
+        }
+    }
+}
+
 void gl::GLState::texImage2D(GLuint target, GLint level, GLint internalFormat, GLint width, GLint height, GLuint format, GLuint type, const void* pixels) {
 
     glTexImage2D(target, level, internalFormat, width, height, 0, format, type, pixels);
@@ -2,16 +2,20 @@
 #include "threepp/renderers/gl/GLTextures.hpp"
 
 #include "threepp/renderers/gl/GLCapabilities.hpp"
+#include "threepp/renderers/gl/GLMemory.hpp"
 #include "threepp/renderers/gl/GLUtils.hpp"
 
 #include "threepp/textures/DataTexture3D.hpp"
 #include "threepp/textures/DepthTexture.hpp"
+#include "threepp/textures/TextureAtlas.hpp"
 
 #if EMSCRIPTEN
 #include <GLES3/gl32.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 
 using namespace threepp;
@@ -38,6 +42,17 @@ namespace {
                texture.minFilter != Filter::Nearest && texture.minFilter != Filter::Linear;
     }
 
+    // levels at or below this size are uploaded immediately when a streamed texture is first used
+    const unsigned int streamingTailSize = 64;
+
+    const size_t streamingPixelBuffers = 3;
+
+    bool textureSupportsStreaming(const Texture& texture) {
+
+        return texture.mipmaps.size() > 1 && texture.type == Type::UnsignedByte &&
+               !dynamic_cast<const DataTexture3D*>(&texture);
+    }
+
     GLuint filterFallback(Filter f) {
 
         if (f == Filter::Nearest || f == Filter::NearestMipmapNearest || f == Filter::NearestMipmapLinear) {
@@ -73,6 +88,9 @@ namespace {
             if (glType == GL_UNSIGNED_BYTE) internalFormat = GL_RGBA8;
         }
 
+        if (glFormat == GL_RED_INTEGER && glType == GL_UNSIGNED_INT) internalFormat = GL_R32UI;
+        if (glFormat == GL_RGBA_INTEGER && glType == GL_UNSIGNED_INT) internalFormat = GL_RGBA32UI;
+
         return internalFormat;
     }
 
@@ -116,6 +134,12 @@ void gl::GLTextures::uploadTexture(TextureProperties* textureProperties, Texture
 
     if (!texture.image) return;
 
+    if (streamingEnabled && textureSupportsStreaming(texture)) {
+
+        uploadStreamingTexture(textureProperties, texture, slot);
+        return;
+    }
+
     GLint textureType = GL_TEXTURE_2D;
 
     auto dataTexture3D = dynamic_cast<DataTexture3D*>(&texture);
@@ -189,28 +213,234 @@ void gl::GLTextures::uploadTexture(TextureProperties* textureProperties, Texture
         }
     }
 
-    if (textureNeedsGenerateMipmaps(texture)) {
+    const bool generatesMipmaps = textureNeedsGenerateMipmaps(texture);
+    if (generatesMipmaps) {
 
         generateMipmap(textureType, texture, image.width, image.height);
     }
 
+    if (!dataTexture3D && !mipmaps.empty()) {
+
+        size_t bytes = 0;
+        for (const auto& mipmap : mipmaps) {
+            bytes += textureBytes(mipmap.width, mipmap.height, 1, texture.format, texture.type, false);
+        }
+        setTextureBytes(textureProperties, bytes);
+
+    } else {
+
+        setTextureBytes(textureProperties, textureBytes(image.width, image.height, image.depth, texture.format, texture.type, generatesMipmaps));
+    }
+
+    textureProperties->version = texture.version();
+
+    if (texture.onUpdate) texture.onUpdate.value()(texture);
+}
+
+void gl::GLTextures::setTextureBytes(TextureProperties* textureProperties, size_t bytes) {
+
+    trackBytes(info.memory.textureBytes, textureProperties->bytes, bytes);
+}
+
+void gl::GLTextures::uploadStreamingTexture(TextureProperties* textureProperties, Texture& texture, GLuint slot) {
+
+    initTexture(textureProperties, texture);
+
+    state.activeTexture(GL_TEXTURE0 + slot);
+    state.bindTexture(GL_TEXTURE_2D, textureProperties->glTexture);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, texture.unpackAlignment);
+
+    GLuint glFormat = toGLFormat(texture.format);
+    GLuint glType = toGLType(texture.type);
+    auto glInternalFormat = getInternalFormat(glFormat, glType);
+
+    setTextureParameters(GL_TEXTURE_2D, texture);
+
+    auto& mipmaps = texture.mipmaps;
+    const auto maxLevel = static_cast<int>(mipmaps.size()) - 1;
+
+    // allocate storage for every level, then make the coarse tail resident right away
+
+    size_t bytes = 0;
+    int residentLevel = maxLevel;
+    for (int i = maxLevel; i >= 0; --i) {
+
+        auto& mipmap = mipmaps[i];
+        const bool tail = mipmap.width <= streamingTailSize && mipmap.height <= streamingTailSize;
+
+        state.texImage2D(GL_TEXTURE_2D, i, glInternalFormat,
+                         static_cast<int>(mipmap.width), static_cast<int>(mipmap.height),
+                         glFormat, glType, tail || i == maxLevel ? mipmap.data().data() : nullptr);
+
+        if (tail || i == maxLevel) residentLevel = i;
+
+        bytes += textureBytes(mipmap.width, mipmap.height, 1, texture.format, texture.type, false);
+    }
+
+    setTextureBytes(textureProperties, bytes);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, residentLevel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+
+    texture.generateMipmaps = false;
+    textureProperties->maxMipLevel = maxLevel;
+    textureProperties->residentLevel = residentLevel;
+    textureProperties->requestedLevel = residentLevel;
+    textureProperties->streamingHinted = false;
+
+    if (!textureProperties->streaming) {
+
+        textureProperties->streaming = true;
+        streamingTextures_.emplace_back(&texture);
+    }
+
     textureProperties->version = texture.version();
 
     if (texture.onUpdate) texture.onUpdate.value()(texture);
 }
 
+void gl::GLTextures::requestStreamingLevel(const Texture& texture, float screenSize) {
+
+    auto textureProperties = properties.textureProperties.get(texture.uuid);
+
+    if (!textureProperties->streaming) return;
+
+    const auto& base = texture.mipmaps.front();
+    const auto size = static_cast<float>(std::max(base.width, base.height));
+    const auto maxLevel = textureProperties->maxMipLevel.value_or(0);
+
+    int level = maxLevel;
+    if (screenSize >= 1) {
+
+        level = std::clamp(static_cast<int>(std::floor(std::log2(size / screenSize))), 0, maxLevel);
+    }
+
+    if (!textureProperties->streamingHinted) {
+
+        textureProperties->streamingHinted = true;
+        textureProperties->requestedLevel = level;
+
+    } else {
+
+        textureProperties->requestedLevel = std::min(textureProperties->requestedLevel, level);
+    }
+}
+
+void gl::GLTextures::updateStreaming() {
+
+    if (streamingTextures_.empty()) return;
+
+    if (pixelBuffers_.empty()) {
+
+        pixelBuffers_.resize(streamingPixelBuffers);
+        glGenBuffers(static_cast<GLsizei>(pixelBuffers_.size()), pixelBuffers_.data());
+    }
+
+    state.activeTexture(GL_TEXTURE0);
+
+    // one level per texture per pass, so coarse levels of every texture land before finer ones
+
+    size_t uploaded = 0;
+    bool budgetExhausted = false;
+    bool progress = true;
+    while (progress && !budgetExhausted) {
+
+        progress = false;
+
+        for (auto texture : streamingTextures_) {
+
+            auto textureProperties = properties.textureProperties.get(texture->uuid);
+
+            // textures nobody has reported a screen size for are streamed in completely
+            const auto targetLevel = textureProperties->streamingHinted ? textureProperties->requestedLevel : 0;
+
+            if (targetLevel >= textureProperties->residentLevel) continue;
+
+            const auto level = textureProperties->residentLevel - 1;
+            const auto bytes = texture->mipmaps[level].data().size();
+
+            if (uploaded > 0 && uploaded + bytes > streamingBudget) {
+
+                budgetExhausted = true;
+                break;
+            }
+
+            uploadStreamingLevel(textureProperties, *texture, level);
+
+            uploaded += bytes;
+            progress = true;
+        }
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    for (auto texture : streamingTextures_) {
+
+        auto textureProperties = properties.textureProperties.get(texture->uuid);
+        // hints are gathered anew each frame
+        if (textureProperties->streamingHinted) {
+            textureProperties->requestedLevel = textureProperties->residentLevel;
+        }
+    }
+}
+
+void gl::GLTextures::uploadStreamingLevel(TextureProperties* textureProperties, Texture& texture, int level) {
+
+    auto& mipmap = texture.mipmaps[level];
+    const auto& data = mipmap.data();
+
+    const auto pixelBuffer = pixelBuffers_[pixelBufferIndex_];
+    pixelBufferIndex_ = (pixelBufferIndex_ + 1) % pixelBuffers_.size();
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+    // orphan the previous storage so we never wait for the GPU to finish reading it
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(data.size()), nullptr, GL_STREAM_DRAW);
+
+#ifndef EMSCRIPTEN
+    void* ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(data.size()), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!ptr) {
+
+        std::cerr << "THREE.GLTextures: Unable to map pixel buffer for streaming" << std::endl;
+        return;
+    }
+    std::memcpy(ptr, data.data(), data.size());
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+#else
+    // WebGL 2 has no buffer mapping
+    glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(data.size()), data.data());
+#endif
+
+    state.bindTexture(GL_TEXTURE_2D, textureProperties->glTexture);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, texture.unpackAlignment);
+    glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0,
+                    static_cast<int>(mipmap.width), static_cast<int>(mipmap.height),
+                    toGLFormat(texture.format), toGLType(texture.type), nullptr);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+
+    textureProperties->residentLevel = level;
+}
+
 void gl::GLTextures::initTexture(TextureProperties* textureProperties, Texture& texture) {
 
     if (!textureProperties->glInit) {
 
         textureProperties->glInit = true;
 
-        texture.addEventListener("dispose", &onTextureDispose_);
+        // evicted textures are still registered
+        if (!texture.hasEventListener(events::dispose, &onTextureDispose_)) {
+
+            texture.addEventListener(events::dispose, &onTextureDispose_);
+        }
 
         GLuint glTexture;
         glGenTextures(1, &glTexture);
         textureProperties->glTexture = glTexture;
 
+        residentTextures_.emplace(&texture);
+
         info.memory.textures++;
     }
 }
@@ -219,9 +449,19 @@ void gl::GLTextures::deallocateTexture(Texture* texture) {
 
     auto textureProperties = properties.textureProperties.get(texture->uuid);
 
-    if (!textureProperties->glInit) return;
+    // an evicted texture has already been released
+    if (untrackTexture(info.memory, textureProperties->glInit, textureProperties->bytes)) {
 
-    glDeleteTextures(1, &textureProperties->glTexture.value());
+        state.releaseTexture(static_cast<int>(*textureProperties->glTexture));
+        glDeleteTextures(1, &textureProperties->glTexture.value());
+
+        residentTextures_.erase(texture);
+
+        if (textureProperties->streaming) {
+
+            streamingTextures_.erase(std::remove(streamingTextures_.begin(), streamingTextures_.end(), texture), streamingTextures_.end());
+        }
+    }
 
     properties.textureProperties.remove(texture->uuid);
 }
@@ -237,6 +477,7 @@ void gl::GLTextures::deallocateRenderTarget(GLRenderTarget* renderTarget) {
 
     if (textureProperties->glTexture) {
 
+        state.releaseTexture(static_cast<int>(*textureProperties->glTexture));
         glDeleteTextures(1, &textureProperties->glTexture.value());
 
         info.memory.textures--;
@@ -247,6 +488,8 @@ void gl::GLTextures::deallocateRenderTarget(GLRenderTarget* renderTarget) {
         renderTarget->depthTexture->dispose();
     }
 
+    info.memory.renderTargetBytes -= renderTargetProperties->bytes;
+
     glDeleteFramebuffers(1, &renderTargetProperties->glFramebuffer.value());
     if (renderTargetProperties->glDepthbuffer) glDeleteRenderbuffers(1, &renderTargetProperties->glDepthbuffer.value());
 
@@ -275,7 +518,15 @@ int gl::GLTextures::allocateTextureUnit() {
 
 void gl::GLTextures::setTexture2D(Texture& texture, GLuint slot) {
 
+    // atlas regions share the storage of their page
+    if (auto region = dynamic_cast<AtlasTexture*>(&texture)) {
+
+        setTexture2D(*region->page(), slot);
+        return;
+    }
+
     auto textureProperties = properties.textureProperties.get(texture.uuid);
+    textureProperties->lastUsedFrame = info.render.frame;
 
     if (texture.version() > 0 && textureProperties->version != texture.version()) {
 
@@ -299,6 +550,7 @@ void gl::GLTextures::setTexture2D(Texture& texture, GLuint slot) {
 void gl::GLTextures::setTexture2DArray(Texture& texture, GLuint slot) {
 
     auto textureProperties = properties.textureProperties.get(texture.uuid);
+    textureProperties->lastUsedFrame = info.render.frame;
 
     if (texture.version() > 0 && textureProperties->version != texture.version()) {
 
@@ -313,6 +565,7 @@ void gl::GLTextures::setTexture2DArray(Texture& texture, GLuint slot) {
 void gl::GLTextures::setTexture3D(Texture& texture, GLuint slot) {
 
     auto textureProperties = properties.textureProperties.get(texture.uuid);
+    textureProperties->lastUsedFrame = info.render.frame;
 
     if (texture.version() > 0 && textureProperties->version != texture.version()) {
 
@@ -327,6 +580,7 @@ void gl::GLTextures::setTexture3D(Texture& texture, GLuint slot) {
 void gl::GLTextures::setTextureCube(Texture& texture, GLuint slot) {
 
     auto textureProperties = properties.textureProperties.get(texture.uuid);
+    textureProperties->lastUsedFrame = info.render.frame;
 
     if (texture.version() > 0 && textureProperties->version != texture.version()) {
 
@@ -465,7 +719,7 @@ void gl::GLTextures::setupRenderTarget(GLRenderTarget* renderTarget) {
     auto renderTargetProperties = properties.renderTargetProperties.get(renderTarget->uuid);
     auto textureProperties = properties.textureProperties.get(texture->uuid);
 
-    renderTarget->addEventListener("dispose", &onRenderTargetDispose_);
+    renderTarget->addEventListener(events::dispose, &onRenderTargetDispose_);
 
     GLuint glTexture;
     glGenTextures(1, &glTexture);
@@ -496,13 +750,16 @@ void gl::GLTextures::setupRenderTarget(GLRenderTarget* renderTarget) {
     setTextureParameters(glTextureType, *texture);
     setupFrameBufferTexture(*renderTargetProperties->glFramebuffer, renderTarget, *texture, GL_COLOR_ATTACHMENT0, glTextureType);
 
-    if (textureNeedsGenerateMipmaps(*texture)) {
+    const bool generatesMipmaps = textureNeedsGenerateMipmaps(*texture);
+    if (generatesMipmaps) {
 
         generateMipmap(GL_TEXTURE_2D, *texture, renderTarget->width, renderTarget->height);
     }
 
     state.bindTexture(GL_TEXTURE_2D, 0);
 
+    trackBytes(info.memory.renderTargetBytes, renderTargetProperties->bytes, renderTargetBytes(*renderTarget, generatesMipmaps));
+
 
     // Setup depth and stencil buffers
 
@@ -534,22 +791,75 @@ std::optional<unsigned int> gl::GLTextures::getGlTexture(const Texture& texture)
     return textureProperties->glTexture;
 }
 
+std::vector<std::pair<size_t, Texture*>> gl::GLTextures::getEvictionCandidates(size_t frame) {
+
+    std::vector<std::pair<size_t, Texture*>> candidates;
+
+    for (auto texture : residentTextures_) {
+
+        // depth textures are attached to framebuffers and have no CPU side copy
+        if (!texture->image || dynamic_cast<DepthTexture*>(texture)) continue;
+
+        auto textureProperties = properties.textureProperties.get(texture->uuid);
+
+        if (textureProperties->lastUsedFrame < frame) {
+
+            candidates.emplace_back(textureProperties->lastUsedFrame, texture);
+        }
+    }
+
+    return candidates;
+}
+
+void gl::GLTextures::evictTexture(Texture& texture) {
+
+    auto textureProperties = properties.textureProperties.get(texture.uuid);
+
+    if (!untrackTexture(info.memory, textureProperties->glInit, textureProperties->bytes)) return;
+
+    state.releaseTexture(static_cast<int>(*textureProperties->glTexture));
+    glDeleteTextures(1, &textureProperties->glTexture.value());
+
+    ++info.memory.evictions;
+
+    if (textureProperties->streaming) {
+
+        streamingTextures_.erase(std::remove(streamingTextures_.begin(), streamingTextures_.end(), &texture), streamingTextures_.end());
+    }
+
+    residentTextures_.erase(&texture);
+
+    // version 0 forces a new upload the next time the texture is used
+    *textureProperties = TextureProperties{};
+}
+
+void gl::GLTextures::dispose() {
+
+    residentTextures_.clear();
+
+    streamingTextures_.clear();
+
+    if (!pixelBuffers_.empty()) {
+
+        glDeleteBuffers(static_cast<GLsizei>(pixelBuffers_.size()), pixelBuffers_.data());
+        pixelBuffers_.clear();
+    }
+}
+
 void gl::GLTextures::TextureEventListener::onEvent(Event& event) {
 
     auto texture = static_cast<Texture*>(event.target);
 
-    texture->removeEventListener("dispose", this);
+    texture->removeEventListener(events::dispose, this);
 
     scope_->deallocateTexture(texture);
-
-    --scope_->info.memory.textures;
 }
 
 void gl::GLTextures::RenderTargetEventListener::onEvent(Event& event) {
 
     auto renderTarget = static_cast<GLRenderTarget*>(event.target);
 
-    renderTarget->removeEventListener("dispose", this);
+    renderTarget->removeEventListener(events::dispose, this);
 
     scope_->deallocateRenderTarget(renderTarget);
 }
@@ -13,6 +13,8 @@
 
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace threepp::gl {
 
@@ -23,6 +25,11 @@ namespace threepp::gl {
         const int maxTextureSize;
         const int maxSamples;
 
+        // When enabled, textures with a CPU side mipmap chain are uploaded progressively,
+        // coarse levels first, using at most streamingBudget bytes per frame.
+        bool streamingEnabled{false};
+        size_t streamingBudget{4 * 1024 * 1024};
+
         GLTextures(GLState& state, GLProperties& properties, GLInfo& info);
 
         void generateMipmap(unsigned int target, const Texture& texture, unsigned int width, unsigned int height);
@@ -35,6 +42,14 @@ namespace threepp::gl {
 
         void uploadCubeTexture(TextureProperties* textureProperties, Texture& texture, unsigned int slot);
 
+        void uploadStreamingTexture(TextureProperties* textureProperties, Texture& texture, unsigned int slot);
+
+        // Request the mip level required to cover screenSize pixels. Finer levels are streamed in by updateStreaming.
+        void requestStreamingLevel(const Texture& texture, float screenSize);
+
+        // Upload pending mip levels of streamed textures through the PBO ring, within streamingBudget.
+        void updateStreaming();
+
         void deallocateTexture(Texture* texture);
 
         void deallocateRenderTarget(GLRenderTarget* renderTarget);
@@ -69,6 +84,14 @@ namespace threepp::gl {
 
         [[nodiscard]] std::optional<unsigned int> getGlTexture(const Texture& texture) const;
 
+        // Textures not used since the given frame that can be restored from their CPU side image, with their last used frame.
+        [[nodiscard]] std::vector<std::pair<size_t, Texture*>> getEvictionCandidates(size_t frame);
+
+        // Releases the GL texture. It is transparently re-uploaded the next time it is used.
+        void evictTexture(Texture& texture);
+
+        void dispose();
+
     private:
         struct TextureEventListener: EventListener {
 
@@ -98,6 +121,15 @@ namespace threepp::gl {
         RenderTargetEventListener onRenderTargetDispose_;
 
         int textureUnits = 0;
+
+        std::unordered_set<Texture*> residentTextures_;
+        std::vector<Texture*> streamingTextures_;
+        std::vector<unsigned int> pixelBuffers_;
+        size_t pixelBufferIndex_ = 0;
+
+        void uploadStreamingLevel(TextureProperties* textureProperties, Texture& texture, int level);
+
+        void setTextureBytes(TextureProperties* textureProperties, size_t bytes);
     };
 
 }// namespace threepp::gl
@@ -7,6 +7,7 @@
 #include "threepp/renderers/shaders/ShaderLib.hpp"
 
 #include "threepp/materials/RawShaderMaterial.hpp"
+#include "threepp/objects/BatchedMesh.hpp"
 #include "threepp/objects/InstancedMesh.hpp"
 #include "threepp/objects/SkinnedMesh.hpp"
 #include "threepp/scenes/Scene.hpp"
@@ -89,6 +90,8 @@ ProgramParameters::ProgramParameters(
     instancing = instancedMesh != nullptr;
     instancingColor = instancedMesh != nullptr && instancedMesh->instanceColor != nullptr;
 
+    batching = object->is<BatchedMesh>();
+
     supportsVertexTextures = GLCapabilities::instance().vertexTextures;
     outputEncoding = renderer.outputEncoding;
 
@@ -175,6 +178,8 @@ ProgramParameters::ProgramParameters(
     numPointLightShadows = lights.pointShadowMap.size();
     numSpotLightShadows = lights.spotShadowMap.size();
 
+    clusteredLights = lights.clustered;
+
     numClippingPlanes = clipping.numPlanes;
     numClipIntersection = clipping.numIntersection;
 
@@ -206,6 +211,8 @@ std::string ProgramParameters::hash() const {
     s << std::to_string(instancing) << '\n';
     s << std::to_string(instancingColor) << '\n';
 
+    s << std::to_string(batching) << '\n';
+
     s << std::to_string(supportsVertexTextures) << '\n';
     s << std::to_string(as_integer(outputEncoding)) << '\n';
     s << std::to_string(map) << '\n';
@@ -280,6 +287,8 @@ std::string ProgramParameters::hash() const {
     s << std::to_string(numPointLightShadows) << '\n';
     s << std::to_string(numSpotLightShadows) << '\n';
 
+    s << std::to_string(clusteredLights) << '\n';
+
     s << std::to_string(numClippingPlanes) << '\n';
     s << std::to_string(numClipIntersection) << '\n';
 
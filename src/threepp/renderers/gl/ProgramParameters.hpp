@@ -33,6 +33,8 @@ namespace threepp {
             bool instancing{};
             bool instancingColor{};
 
+            bool batching{};
+
             bool supportsVertexTextures;
             Encoding outputEncoding{};
             bool map{};
@@ -103,6 +105,8 @@ namespace threepp {
             size_t numPointLightShadows{};
             size_t numSpotLightShadows{};
 
+            bool clusteredLights{};
+
             int numClippingPlanes{};
             int numClipIntersection{};
 
@@ -6,5 +6,5 @@ using namespace threepp;
 
 std::shared_ptr<Scene> Scene::create() {
 
-    return std::make_shared<Scene>();
+    return utils::makePooled<Scene>();
 }
@@ -0,0 +1,422 @@
+
+#include "threepp/scenes/SceneBVH.hpp"
+
+#include "threepp/core/Object3D.hpp"
+#include "threepp/math/Box3.hpp"
+#include "threepp/math/Frustum.hpp"
+#include "threepp/math/Ray.hpp"
+#include "threepp/math/bvh.hpp"
+#include "threepp/objects/Group.hpp"
+#include "threepp/objects/Line.hpp"
+#include "threepp/objects/Mesh.hpp"
+#include "threepp/objects/Points.hpp"
+#include "threepp/objects/SkinnedMesh.hpp"
+#include "threepp/utils/SmallVector.hpp"
+#include "threepp/utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace threepp;
+
+namespace {
+
+    using bvh::invalid;
+    using bvh::Node;
+
+    constexpr uint32_t maxLeafSize = 8;
+
+    struct Item {
+        Object3D* object;
+        Box3 box;
+        Vector3 centroid;
+    };
+
+    bool isCandidate(Object3D& object) {
+
+        return object.isStatic && object.frustumCulled &&
+               (object.is<Mesh>() || object.is<Line>() || object.is<Points>()) &&
+               !object.is<SkinnedMesh>() && object.geometry();
+    }
+
+}// namespace
+
+struct SceneBVH::Impl {
+
+    // drops the subtree of an object removed from the graph or destroyed
+    struct OnObjectGone: EventListener {
+
+        explicit OnObjectGone(Impl* scope): scope(scope) {}
+
+        void onEvent(Event& event) override {
+
+            scope->drop(*static_cast<Object3D*>(event.target));
+        }
+
+        Impl* scope;
+    };
+
+    // a covered subtree with new children has to be traversed again
+    struct OnChildrenAdded: EventListener {
+
+        explicit OnChildrenAdded(Impl* scope): scope(scope) {}
+
+        void onEvent(Event& event) override {
+
+            const auto& added = *static_cast<std::vector<Object3D*>*>(event.target);
+            scope->uncover(added.front()->parent);
+        }
+
+        Impl* scope;
+    };
+
+    unsigned int threads;
+    std::unique_ptr<utils::ThreadPool> pool;
+
+    std::vector<Item> items;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> itemNodes;// leaf of each item
+
+    std::unordered_map<const Object3D*, uint32_t> itemIndices;
+    std::unordered_set<const Object3D*> coveredSubtrees;
+
+    // the items, their ancestors and the covered nodes listen for new children, destruction and,
+    // below the root, removal
+    OnObjectGone onObjectGone{this};
+    OnChildrenAdded onChildrenAdded{this};
+    Object3D* root = nullptr;
+    std::unordered_set<Object3D*> watched;
+
+    Box3 emptyBox;
+
+    explicit Impl(unsigned int threads)
+        : threads(std::max(threads, 1u)) {
+
+        if (this->threads > 1) {
+
+            pool = std::make_unique<utils::ThreadPool>(this->threads);
+        }
+    }
+
+    void watch(Object3D& object) {
+
+        object.addEventListener(events::destroyed, &onObjectGone);
+        object.addEventListener(events::childrenAdded, &onChildrenAdded);
+        if (&object != root) object.addEventListener(events::remove, &onObjectGone);
+
+        watched.emplace(&object);
+    }
+
+    void unwatch(Object3D& object) {
+
+        object.removeEventListener(events::destroyed, &onObjectGone);
+        object.removeEventListener(events::childrenAdded, &onChildrenAdded);
+        object.removeEventListener(events::remove, &onObjectGone);
+    }
+
+    void unwatchAll() {
+
+        for (auto object : watched) unwatch(*object);
+        watched.clear();
+    }
+
+    // the object is no longer in the graph, or is being destroyed. Nodes keep their bounds until the next build.
+    void drop(Object3D& object) {
+
+        object.traverse([this](Object3D& o) {
+            if (watched.erase(&o)) unwatch(o);
+
+            coveredSubtrees.erase(&o);
+
+            const auto it = itemIndices.find(&o);
+            if (it != itemIndices.end()) {
+
+                items[it->second].object = nullptr;
+                itemIndices.erase(it);
+            }
+        });
+
+        if (&object == root) root = nullptr;
+    }
+
+    // the object and its ancestors no longer cover their subtrees
+    void uncover(Object3D* object) {
+
+        for (; object; object = object->parent) {
+
+            coveredSubtrees.erase(object);
+        }
+    }
+
+    // collects candidates below object, returns whether the whole subtree is covered
+    bool collect(Object3D& object) {
+
+        const auto first = items.size();
+        bool covered = false;
+
+        if (isCandidate(object)) {
+
+            const auto box = object.worldBoundingBox();
+            if (box && !box->isEmpty()) {
+
+                Item item{&object, *box, {}};
+                box->getCenter(item.centroid);
+                items.emplace_back(item);
+                covered = true;
+            }
+
+        } else {
+
+            covered = typeid(object) == typeid(Object3D) || typeid(object) == typeid(Group);
+        }
+
+        for (auto child : object.children) {
+
+            if (!collect(*child)) covered = false;
+        }
+
+        if (covered) coveredSubtrees.emplace(&object);
+        if (covered || items.size() > first) watch(object);
+
+        return covered;
+    }
+
+    void build(Object3D& object) {
+
+        unwatchAll();
+
+        items.clear();
+        nodes.clear();
+        itemNodes.clear();
+        itemIndices.clear();
+        coveredSubtrees.clear();
+
+        root = &object;
+        collect(object);
+
+        if (items.empty()) return;
+
+        // subtrees up to this size are built as independent jobs
+        const auto taskSize = std::max<uint32_t>(parallelThreshold, static_cast<uint32_t>(items.size()) / (threads * 4));
+
+        nodes = bvh::Builder<Item>(items, maxLeafSize, pool.get(), taskSize).build();
+
+        itemNodes.resize(items.size());
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+
+            const auto& node = nodes[i];
+            if (!node.isLeaf()) continue;
+
+            for (auto j = node.begin; j < node.end; ++j) itemNodes[j] = i;
+        }
+
+        for (uint32_t i = 0; i < items.size(); ++i) {
+
+            itemIndices[items[i].object] = i;
+        }
+    }
+
+    // returns whether the bounds of the item changed
+    bool refreshItem(uint32_t index) {
+
+        auto& item = items[index];
+        if (!item.object) return false;
+
+        const auto box = item.object->worldBoundingBox();
+        if (!box || box->equals(item.box)) return false;
+
+        item.box.copy(*box);
+        box->getCenter(item.centroid);
+
+        return true;
+    }
+
+    // recomputes the bounds of the given nodes and their ancestors, children before parents
+    void refitNodes(std::vector<uint32_t>& dirty) {
+
+        std::priority_queue<uint32_t> queue(dirty.begin(), dirty.end());
+
+        auto last = invalid;
+        while (!queue.empty()) {
+
+            const auto index = queue.top();
+            queue.pop();
+
+            if (index == last) continue;
+            last = index;
+
+            auto& node = nodes[index];
+            Box3 box;
+
+            if (node.isLeaf()) {
+
+                for (auto i = node.begin; i < node.end; ++i) box.union_(items[i].box);
+
+            } else {
+
+                box.copy(nodes[node.left].box).union_(nodes[node.right].box);
+            }
+
+            if (box.equals(node.box)) continue;
+
+            node.box.copy(box);
+            if (node.parent != invalid) queue.push(node.parent);
+        }
+    }
+
+    size_t refit(const std::vector<Object3D*>& objects) {
+
+        std::vector<uint32_t> dirty;
+
+        for (auto object : objects) {
+
+            const auto it = itemIndices.find(object);
+            if (it == itemIndices.end()) continue;
+
+            if (refreshItem(it->second)) dirty.emplace_back(itemNodes[it->second]);
+        }
+
+        refitNodes(dirty);
+
+        return dirty.size();
+    }
+
+    size_t refit() {
+
+        std::vector<uint32_t> dirty;
+
+        for (uint32_t i = 0; i < items.size(); ++i) {
+
+            if (refreshItem(i)) dirty.emplace_back(itemNodes[i]);
+        }
+
+        refitNodes(dirty);
+
+        return dirty.size();
+    }
+
+    void intersectFrustum(const Frustum& frustum, std::vector<Object3D*>& result) const {
+
+        if (nodes.empty()) return;
+
+        utils::SmallVector<uint32_t, 64> stack;
+        stack.push_back(0);
+
+        while (!stack.empty()) {
+
+            const auto& node = nodes[stack.back()];
+            stack.pop_back();
+
+            if (!frustum.intersectsBox(node.box)) continue;
+
+            if (frustum.containsBox(node.box)) {
+
+                for (auto i = node.begin; i < node.end; ++i) {
+
+                    if (items[i].object) result.emplace_back(items[i].object);
+                }
+                continue;
+            }
+
+            if (node.isLeaf()) {
+
+                for (auto i = node.begin; i < node.end; ++i) {
+
+                    if (items[i].object && frustum.intersectsBox(items[i].box)) result.emplace_back(items[i].object);
+                }
+                continue;
+            }
+
+            stack.push_back(node.right);
+            stack.push_back(node.left);
+        }
+    }
+
+    void intersectRay(const Ray& ray, std::vector<Object3D*>& result, float near, float far) const {
+
+        if (nodes.empty()) return;
+
+        const auto& origin = ray.origin;
+        const Vector3 invDir(1.f / ray.direction.x, 1.f / ray.direction.y, 1.f / ray.direction.z);
+
+        utils::SmallVector<uint32_t, 64> stack;
+        stack.push_back(0);
+
+        while (!stack.empty()) {
+
+            const auto& node = nodes[stack.back()];
+            stack.pop_back();
+
+            if (!bvh::intersectsBox(node.box, origin, invDir, near, far)) continue;
+
+            if (node.isLeaf()) {
+
+                for (auto i = node.begin; i < node.end; ++i) {
+
+                    if (items[i].object && bvh::intersectsBox(items[i].box, origin, invDir, near, far)) result.emplace_back(items[i].object);
+                }
+                continue;
+            }
+
+            stack.push_back(node.right);
+            stack.push_back(node.left);
+        }
+    }
+};
+
+SceneBVH::SceneBVH(unsigned int threads)
+    : pimpl_(std::make_unique<Impl>(threads)) {}
+
+void SceneBVH::build(Object3D& root) {
+
+    pimpl_->build(root);
+}
+
+size_t SceneBVH::refit(const std::vector<Object3D*>& objects) {
+
+    return pimpl_->refit(objects);
+}
+
+size_t SceneBVH::refit() {
+
+    return pimpl_->refit();
+}
+
+void SceneBVH::intersectFrustum(const Frustum& frustum, std::vector<Object3D*>& result) const {
+
+    pimpl_->intersectFrustum(frustum, result);
+}
+
+void SceneBVH::intersectRay(const Ray& ray, std::vector<Object3D*>& result, float near, float far) const {
+
+    pimpl_->intersectRay(ray, result, near, far);
+}
+
+bool SceneBVH::contains(const Object3D& object) const {
+
+    return pimpl_->itemIndices.count(&object) > 0;
+}
+
+bool SceneBVH::coversSubtree(const Object3D& object) const {
+
+    return pimpl_->coveredSubtrees.count(&object) > 0;
+}
+
+size_t SceneBVH::size() const {
+
+    return pimpl_->itemIndices.size();
+}
+
+const Box3& SceneBVH::bounds() const {
+
+    return pimpl_->nodes.empty() ? pimpl_->emptyBox : pimpl_->nodes.front().box;
+}
+
+SceneBVH::~SceneBVH() {
+
+    pimpl_->unwatchAll();
+}
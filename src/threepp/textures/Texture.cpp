@@ -26,7 +26,7 @@ void Texture::dispose() {
 
     if (!disposed_) {
         disposed_ = true;
-        this->dispatchEvent("dispose", this);
+        this->dispatchEvent(events::dispose, this);
     }
 }
 
@@ -0,0 +1,316 @@
+
+#include "threepp/textures/TextureAtlas.hpp"
+
+#include "threepp/core/Object3D.hpp"
+#include "threepp/materials/interfaces.hpp"
+#include "threepp/objects/Sprite.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+using namespace threepp;
+
+namespace {
+
+    unsigned int channelCount(Format format) {
+
+        return format == Format::RGBA ? 4 : 3;
+    }
+
+    bool isEligible(const Texture& texture, unsigned int maxTextureSize) {
+
+        if (!texture.image || dynamic_cast<const AtlasTexture*>(&texture)) return false;
+
+        const auto& image = *texture.image;
+        if (image.width == 0 || image.height == 0 || image.depth > 0) return false;
+        if (image.width > maxTextureSize || image.height > maxTextureSize) return false;
+
+        if (texture.type != Type::UnsignedByte) return false;
+        if (texture.format != Format::RGBA && texture.format != Format::RGB) return false;
+        if (texture.mapping != Mapping::UV) return false;
+
+        // regions can neither repeat nor rotate within the page
+        if (texture.wrapS != TextureWrapping::ClampToEdge || texture.wrapT != TextureWrapping::ClampToEdge) return false;
+        if (texture.rotation != 0 || !texture.matrixAutoUpdate) return false;
+
+        return true;
+    }
+
+    // true when the map is the only texture deciding the uvTransform uniform
+    bool onlyMapIsUvTransformed(Material* material) {
+
+        auto alphaMaterial = dynamic_cast<MaterialWithAlphaMap*>(material);
+        auto specularMaterial = dynamic_cast<MaterialWithSpecularMap*>(material);
+        auto displacementMaterial = dynamic_cast<MaterialWithDisplacementMap*>(material);
+        auto normalMaterial = dynamic_cast<MaterialWithNormalMap*>(material);
+        auto bumpMaterial = dynamic_cast<MaterialWithBumpMap*>(material);
+        auto roughnessMaterial = dynamic_cast<MaterialWithRoughness*>(material);
+        auto metalnessMaterial = dynamic_cast<MaterialWithMetalness*>(material);
+        auto emissiveMaterial = dynamic_cast<MaterialWithEmissive*>(material);
+
+        return !(alphaMaterial && alphaMaterial->alphaMap) &&
+               !(specularMaterial && specularMaterial->specularMap) &&
+               !(displacementMaterial && displacementMaterial->displacementMap) &&
+               !(normalMaterial && normalMaterial->normalMap) &&
+               !(bumpMaterial && bumpMaterial->bumpMap) &&
+               !(roughnessMaterial && roughnessMaterial->roughnessMap) &&
+               !(metalnessMaterial && metalnessMaterial->metalnessMap) &&
+               !(emissiveMaterial && emissiveMaterial->emissiveMap);
+    }
+
+    // shelf packer
+    struct Page {
+
+        std::shared_ptr<Texture> texture;
+
+        unsigned int cursorX = 0;
+        unsigned int cursorY = 0;
+        unsigned int shelfHeight = 0;
+
+        bool allocate(unsigned int width, unsigned int height, unsigned int size, unsigned int& x, unsigned int& y) {
+
+            if (width > size || height > size) return false;
+
+            if (cursorX + width > size) {
+
+                cursorX = 0;
+                cursorY += shelfHeight;
+                shelfHeight = 0;
+            }
+
+            if (cursorY + height > size) return false;
+
+            x = cursorX;
+            y = cursorY;
+
+            cursorX += width;
+            shelfHeight = std::max(shelfHeight, height);
+
+            return true;
+        }
+    };
+
+}// namespace
+
+struct TextureAtlas::Impl {
+
+    struct OnTextureDispose: EventListener {
+
+        explicit OnTextureDispose(Impl* scope): scope(scope) {}
+
+        void onEvent(Event& event) override {
+
+            auto texture = static_cast<Texture*>(event.target);
+            texture->removeEventListener(events::dispose, this);
+
+            scope->regions_.erase(texture->uuid);
+        }
+
+        Impl* scope;
+    };
+
+    struct Region {
+        std::weak_ptr<Texture> source;
+        std::shared_ptr<AtlasTexture> texture;
+    };
+
+    unsigned int pageSize;
+    unsigned int maxTextureSize;
+    unsigned int padding;
+
+    // pages grouped by format, encoding and row order
+    std::map<std::tuple<Format, Encoding, bool>, std::vector<Page>> groups_;
+    std::vector<std::shared_ptr<Texture>> pages_;
+
+    // keyed by the uuid of the source texture, erased when it is disposed
+    OnTextureDispose onTextureDispose{this};
+    std::unordered_map<std::string, Region> regions_;
+
+    Impl(unsigned int pageSize, unsigned int maxTextureSize, unsigned int padding)
+        : pageSize(pageSize),
+          maxTextureSize(pageSize > 2 * padding ? std::min(maxTextureSize, pageSize - 2 * padding) : 0),
+          padding(padding) {}
+
+    ~Impl() {
+
+        for (auto& [uuid, region] : regions_) {
+
+            // a texture disposed before it was added again is not notified when destroyed
+            if (auto source = region.source.lock()) source->removeEventListener(events::dispose, &onTextureDispose);
+        }
+    }
+
+    std::shared_ptr<AtlasTexture> add(const std::shared_ptr<Texture>& texture) {
+
+        if (!texture) return nullptr;
+
+        auto it = regions_.find(texture->uuid);
+        if (it != regions_.end()) return it->second.texture;
+
+        if (!isEligible(*texture, maxTextureSize)) return nullptr;
+
+        auto& image = *texture->image;
+        const auto channels = channelCount(texture->format);
+
+        if (image.data().size() < static_cast<size_t>(image.width) * image.height * channels) return nullptr;
+
+        const auto paddedWidth = image.width + 2 * padding;
+        const auto paddedHeight = image.height + 2 * padding;
+
+        auto& pages = groups_[{texture->format, texture->encoding, image.flipped()}];
+
+        unsigned int x = 0, y = 0;
+        Page* page = nullptr;
+        for (auto& candidate : pages) {
+
+            if (candidate.allocate(paddedWidth, paddedHeight, pageSize, x, y)) {
+
+                page = &candidate;
+                break;
+            }
+        }
+
+        if (!page) {
+
+            page = &pages.emplace_back(createPage(*texture, channels));
+            if (!page->allocate(paddedWidth, paddedHeight, pageSize, x, y)) {
+
+                pages.pop_back();
+                pages_.pop_back();
+                return nullptr;
+            }
+        }
+
+        blit(*page->texture, image, channels, x + padding, y + padding);
+        page->texture->needsUpdate();
+
+        auto region = AtlasTexture::create(page->texture);
+        region->name = texture->name;
+        region->format = texture->format;
+        region->type = texture->type;
+        region->encoding = texture->encoding;
+        region->premultiplyAlpha = texture->premultiplyAlpha;
+
+        const auto size = static_cast<float>(pageSize);
+        const Vector2 regionOffset(static_cast<float>(x + padding) / size, static_cast<float>(y + padding) / size);
+        const Vector2 regionScale(static_cast<float>(image.width) / size, static_cast<float>(image.height) / size);
+
+        region->offset.copy(texture->offset).multiply(regionScale).add(regionOffset);
+        region->repeat.copy(texture->repeat).multiply(regionScale);
+
+        regions_[texture->uuid] = {texture, region};
+        texture->addEventListener(events::dispose, &onTextureDispose);
+
+        return region;
+    }
+
+    size_t apply(Object3D& root) {
+
+        size_t count = 0;
+
+        root.traverse([&](Object3D& object) {
+            std::vector<Material*> materials;
+            if (auto sprite = dynamic_cast<Sprite*>(&object)) {
+
+                materials.emplace_back(sprite->material.get());
+
+            } else {
+
+                materials = object.materials();
+            }
+
+            for (auto material : materials) {
+
+                auto mapMaterial = dynamic_cast<MaterialWithMap*>(material);
+                if (!mapMaterial || !mapMaterial->map) continue;
+                if (!onlyMapIsUvTransformed(material)) continue;
+
+                if (auto region = add(mapMaterial->map)) {
+
+                    mapMaterial->map = region;
+                    material->needsUpdate();
+                    ++count;
+                }
+            }
+        });
+
+        return count;
+    }
+
+    Page createPage(const Texture& source, unsigned int channels) {
+
+        const auto& image = *source.image;
+
+        std::vector<unsigned char> data(static_cast<size_t>(pageSize) * pageSize * channels);
+
+        auto texture = Texture::create(Image(data, pageSize, pageSize, image.flipped()));
+        texture->name = "TextureAtlas";
+        texture->format = source.format;
+        texture->type = source.type;
+        texture->encoding = source.encoding;
+        texture->unpackAlignment = 1;
+        // coarser levels would average texels of neighbouring regions, beyond what the padding covers
+        texture->generateMipmaps = false;
+        texture->minFilter = Filter::Linear;
+
+        pages_.emplace_back(texture);
+
+        return {texture};
+    }
+
+    // copies the image and extends its border into the padding, limiting bleeding when filtered
+    void blit(Texture& page, Image& image, unsigned int channels, unsigned int x, unsigned int y) const {
+
+        auto& dst = page.image->data();
+        const auto& src = image.data();
+
+        const auto rowBytes = static_cast<size_t>(image.width) * channels;
+        const auto pageStride = static_cast<size_t>(pageSize) * channels;
+
+        const auto offsetOf = [&](unsigned int px, unsigned int py) {
+            return static_cast<size_t>(py) * pageStride + static_cast<size_t>(px) * channels;
+        };
+
+        for (unsigned int row = 0; row < image.height; ++row) {
+
+            const auto rowOffset = offsetOf(x, y + row);
+            std::memcpy(dst.data() + rowOffset, src.data() + row * rowBytes, rowBytes);
+
+            for (unsigned int p = 1; p <= padding; ++p) {
+
+                std::memcpy(dst.data() + offsetOf(x - p, y + row), dst.data() + rowOffset, channels);
+                std::memcpy(dst.data() + offsetOf(x + image.width - 1 + p, y + row), dst.data() + offsetOf(x + image.width - 1, y + row), channels);
+            }
+        }
+
+        const auto paddedRowBytes = static_cast<size_t>(image.width + 2 * padding) * channels;
+        for (unsigned int p = 1; p <= padding; ++p) {
+
+            std::memcpy(dst.data() + offsetOf(x - padding, y - p), dst.data() + offsetOf(x - padding, y), paddedRowBytes);
+            std::memcpy(dst.data() + offsetOf(x - padding, y + image.height - 1 + p), dst.data() + offsetOf(x - padding, y + image.height - 1), paddedRowBytes);
+        }
+    }
+};
+
+TextureAtlas::TextureAtlas(unsigned int pageSize, unsigned int maxTextureSize, unsigned int padding)
+    : pimpl_(std::make_unique<Impl>(pageSize, maxTextureSize, padding)) {}
+
+std::shared_ptr<AtlasTexture> TextureAtlas::add(const std::shared_ptr<Texture>& texture) {
+
+    return pimpl_->add(texture);
+}
+
+size_t TextureAtlas::apply(Object3D& root) {
+
+    return pimpl_->apply(root);
+}
+
+const std::vector<std::shared_ptr<Texture>>& TextureAtlas::pages() const {
+
+    return pimpl_->pages_;
+}
+
+TextureAtlas::~TextureAtlas() = default;
@@ -0,0 +1,60 @@
+
+#include "threepp/utils/PoolAllocator.hpp"
+
+#include <algorithm>
+
+using namespace threepp::utils;
+
+BlockPool::BlockPool(size_t blockSize, size_t blocksPerChunk)
+    : blockSize_(std::max(blockSize, sizeof(Node))),
+      blocksPerChunk_(std::max<size_t>(blocksPerChunk, 1)) {}
+
+void* BlockPool::allocate() {
+
+    std::lock_guard<std::mutex> lck(m_);
+
+    if (!free_) {
+
+        // operator new[] aligns to at least max_align_t, and blocks are multiples of it
+        auto& chunk = chunks_.emplace_back(new std::byte[blockSize_ * blocksPerChunk_]);
+
+        for (auto i = blocksPerChunk_; i-- > 0;) {
+
+            auto node = reinterpret_cast<Node*>(chunk.get() + i * blockSize_);
+            node->next = free_;
+            free_ = node;
+        }
+    }
+
+    auto node = free_;
+    free_ = node->next;
+    ++size_;
+
+    return node;
+}
+
+void BlockPool::deallocate(void* p) noexcept {
+
+    if (!p) return;
+
+    std::lock_guard<std::mutex> lck(m_);
+
+    auto node = static_cast<Node*>(p);
+    node->next = free_;
+    free_ = node;
+    --size_;
+}
+
+size_t BlockPool::size() const {
+
+    std::lock_guard<std::mutex> lck(m_);
+
+    return size_;
+}
+
+size_t BlockPool::capacity() const {
+
+    std::lock_guard<std::mutex> lck(m_);
+
+    return chunks_.size() * blocksPerChunk_;
+}
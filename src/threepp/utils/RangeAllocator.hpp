@@ -0,0 +1,71 @@
+
+#ifndef THREEPP_RANGEALLOCATOR_HPP
+#define THREEPP_RANGEALLOCATOR_HPP
+
+#include <iterator>
+#include <map>
+#include <optional>
+
+namespace threepp::utils {
+
+    // First-fit allocator of ranges in [0, capacity). Released ranges are merged with their free neighbours.
+    class RangeAllocator {
+
+    public:
+        explicit RangeAllocator(size_t capacity = 0) {
+
+            if (capacity > 0) free_[0] = capacity;
+        }
+
+        // offset of a range of size elements, or nothing if no free range is large enough
+        std::optional<size_t> allocate(size_t size) {
+
+            if (size == 0) return 0;
+
+            for (auto it = free_.begin(); it != free_.end(); ++it) {
+
+                const auto [offset, available] = *it;
+                if (available < size) continue;
+
+                free_.erase(it);
+                if (available > size) free_[offset + size] = available - size;
+
+                return offset;
+            }
+
+            return std::nullopt;
+        }
+
+        void release(size_t offset, size_t size) {
+
+            if (size == 0) return;
+
+            auto next = free_.lower_bound(offset);
+
+            if (next != free_.end() && next->first == offset + size) {
+
+                size += next->second;
+                next = free_.erase(next);
+            }
+
+            if (next != free_.begin()) {
+
+                auto previous = std::prev(next);
+                if (previous->first + previous->second == offset) {
+
+                    previous->second += size;
+                    return;
+                }
+            }
+
+            free_[offset] = size;
+        }
+
+    private:
+        // offset -> size of the free ranges
+        std::map<size_t, size_t> free_;
+    };
+
+}// namespace threepp::utils
+
+#endif//THREEPP_RANGEALLOCATOR_HPP
@@ -4,6 +4,8 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <thread>
+
 using namespace threepp;
 
 namespace {
@@ -78,3 +80,70 @@ TEST_CASE("Test events") {
     material->dispose();
     REQUIRE(!material->hasEventListener("dispose", &onDispose));
 }
+
+TEST_CASE("Event types are interned") {
+
+    CHECK(EventType("dispose") == events::dispose);
+    CHECK(EventType(std::string("remove")) == events::remove);
+    CHECK(EventType("custom") == EventType("custom"));
+    CHECK(EventType("custom") != EventType("other"));
+    CHECK(EventType("custom").name() == "custom");
+    CHECK(events::childrenRemoved.name() == "childrenRemoved");
+    CHECK(EventType("destroyed") == events::destroyed);
+
+    EventDispatcher evt;
+
+    std::string type;
+    LambdaEventListener l([&type](Event& e) {
+        type = e.type;
+    });
+
+    // more listeners than fit inline
+    std::vector<MyEventListener> counters(5);
+    for (auto& c : counters) evt.addEventListener(events::added, &c);
+    evt.addEventListener("custom", &l);
+
+    evt.dispatchEvent("custom");
+    CHECK(type == "custom");
+
+    evt.dispatchEvent(events::added);
+    evt.removeEventListener(events::added, &counters[1]);
+    evt.dispatchEvent(events::added);
+
+    CHECK(counters[0].numCalled == 2);
+    CHECK(counters[1].numCalled == 1);
+    CHECK(counters[4].numCalled == 2);
+}
+
+TEST_CASE("Event type names are readable while types are interned") {
+
+    const EventType first("concurrent0");
+
+    std::thread writer([] {
+        for (int i = 1; i < 1000; ++i) EventType("concurrent" + std::to_string(i));
+    });
+
+    for (int i = 0; i < 1000; ++i) {
+
+        CHECK(first.name() == "concurrent0");
+        CHECK(events::dispose.name() == "dispose");
+    }
+
+    writer.join();
+
+    CHECK(EventType("concurrent999").name() == "concurrent999");
+}
+
+TEST_CASE("String types dispatch like interned types") {
+
+    EventDispatcher evt;
+
+    MyEventListener l;
+    evt.addEventListener(events::remove, &l);
+
+    evt.dispatchEvent("remove");
+    evt.dispatchEvent(std::string("remove"));
+    evt.dispatchEvent("unrelated");
+
+    CHECK(l.numCalled == 2);
+}
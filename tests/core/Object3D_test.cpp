@@ -8,6 +8,9 @@
 #include "threepp/math/Matrix3.hpp"
 #include "threepp/math/Matrix4.hpp"
 #include "threepp/math/Vector3.hpp"
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/objects/Group.hpp"
+#include "threepp/objects/Mesh.hpp"
 
 #include "../equals_util.hpp"
 
@@ -425,3 +428,327 @@ TEST_CASE("updateWorldMatrix") {
 
     REQUIRE(object->matrixWorld->elements == m.setPosition(parent->position).elements);
 }
+
+TEST_CASE("updateMatrixWorld skips unchanged objects") {
+
+    auto parent = Object3D::create();
+    auto child = Object3D::create();
+    auto staticChild = Object3D::create();
+    auto grandChild = Object3D::create();
+
+    parent->add(child);
+    parent->add(staticChild);
+    child->add(grandChild);
+
+    parent->updateMatrixWorld();
+
+    auto count = Object3D::matrixWorldUpdates();
+    parent->updateMatrixWorld();
+    REQUIRE(Object3D::matrixWorldUpdates() - count == 0);
+
+    child->position.set(1, 0, 0);
+
+    count = Object3D::matrixWorldUpdates();
+    parent->updateMatrixWorld();
+    REQUIRE(Object3D::matrixWorldUpdates() - count == 2);
+
+    Vector3 position;
+    grandChild->getWorldPosition(position);
+    REQUIRE(position == Vector3(1, 0, 0));
+
+    child->rotation.y = math::PI / 2;
+    grandChild->position.set(0, 0, 1);
+
+    parent->updateMatrixWorld();
+    grandChild->getWorldPosition(position);
+    REQUIRE_THAT(position.x, Catch::Matchers::WithinAbs(2, 1e-6));
+    REQUIRE_THAT(position.z, Catch::Matchers::WithinAbs(0, 1e-6));
+}
+
+TEST_CASE("updateMatrixWorld skips static subtrees") {
+
+    struct Probe: Object3D {
+
+        int visits = 0;
+
+        void updateMatrixWorld(bool force) override {
+
+            ++visits;
+            Object3D::updateMatrixWorld(force);
+        }
+    };
+
+    auto root = Object3D::create();
+    auto group = Object3D::create();
+    auto probe = std::make_shared<Probe>();
+
+    group->matrixAutoUpdate = false;
+    probe->matrixAutoUpdate = false;
+    root->add(group);
+    group->add(probe);
+
+    root->updateMatrixWorld();
+    REQUIRE(probe->visits == 1);
+
+    root->updateMatrixWorld();
+    CHECK(probe->visits == 1);
+
+    // updateMatrix flags the subtree
+    probe->position.x = 2;
+    probe->updateMatrix();
+    root->updateMatrixWorld();
+    CHECK(probe->visits == 2);
+    CHECK(probe->matrixWorld->elements[12] == 2);
+
+    // so does a matrix written directly
+    group->matrix->makeTranslation(0, 3, 0);
+    group->matrixWorldNeedsUpdate = true;
+    root->updateMatrixWorld();
+    CHECK(probe->visits == 3);
+    CHECK(probe->matrixWorld->elements[13] == 3);
+
+    // moving the root reaches the subtree
+    root->position.z = 1;
+    root->updateMatrixWorld();
+    CHECK(probe->visits == 4);
+    CHECK(probe->matrixWorld->elements[14] == 1);
+
+    // an object with matrixAutoUpdate is checked every update
+    probe->matrixAutoUpdate = true;
+    root->updateMatrixWorld();
+    root->updateMatrixWorld();
+    CHECK(probe->visits == 6);
+}
+
+TEST_CASE("objects sharing a matrix follow their source") {
+
+    auto source = Object3D::create();
+    auto follower = Object3D::create();
+    auto root = Object3D::create();
+    root->add(follower);
+
+    follower->shareMatrix(source->matrixWorld);
+    follower->matrixAutoUpdate = false;
+    CHECK(follower->matrixShared());
+
+    root->updateMatrixWorld();
+
+    source->position.x = 5;
+    source->updateMatrixWorld();
+    root->updateMatrixWorld();
+    CHECK(follower->matrixWorld->elements[12] == 5);
+
+    // the shared matrix does not force a full update of other objects
+    const auto count = Object3D::matrixWorldUpdates();
+    source->updateMatrixWorld();
+    CHECK(Object3D::matrixWorldUpdates() - count == 0);
+}
+
+TEST_CASE("rotation and quaternion sync") {
+
+    auto object = Object3D::create();
+
+    object->rotation.y = math::PI / 2;
+    object->rotation.x = 0;
+
+    Quaternion expected;
+    expected.setFromAxisAngle(Vector3(0, 1, 0), math::PI / 2);
+    REQUIRE(object->quaternion.equals(expected));
+
+    object->quaternion.setFromAxisAngle(Vector3(1, 0, 0), math::PI / 4);
+    REQUIRE_THAT(object->rotation.x(), Catch::Matchers::WithinAbs(math::PI / 4, 1e-6));
+    REQUIRE_THAT(object->rotation.y(), Catch::Matchers::WithinAbs(0, 1e-6));
+
+    // writing a single component keeps the others
+    object->rotation.z = math::PI / 2;
+    REQUIRE_THAT(object->rotation.x(), Catch::Matchers::WithinAbs(math::PI / 4, 1e-6));
+
+    object->updateMatrix();
+    Quaternion q;
+    q.setFromEuler(Euler(math::PI / 4, 0, math::PI / 2));
+    REQUIRE_THAT(object->quaternion.angleTo(q), Catch::Matchers::WithinAbs(0, 1e-3));
+}
+
+TEST_CASE("add and remove children") {
+
+    struct Counter: EventListener {
+        int count = 0;
+        void onEvent(Event&) override { ++count; }
+    } added, removed, batchAdded, batchRemoved;
+
+    Object3D parent;
+    parent.addEventListener("childrenAdded", &batchAdded);
+    parent.addEventListener("childrenRemoved", &batchRemoved);
+
+    std::vector<std::shared_ptr<Object3D>> objects;
+    for (int i = 0; i < 5; ++i) {
+        auto o = Object3D::create();
+        o->name = std::to_string(i);
+        o->addEventListener("added", &added);
+        o->addEventListener("remove", &removed);
+        objects.emplace_back(o);
+    }
+
+    parent.addAll(objects);
+    REQUIRE(parent.children.size() == 5);
+    CHECK(added.count == 5);
+    CHECK(batchAdded.count == 1);
+
+    parent.remove(*objects[1]);
+    CHECK(objects[1]->parent == nullptr);
+    CHECK(parent.children == std::vector<Object3D*>{objects[0].get(), objects[2].get(), objects[3].get(), objects[4].get()});
+
+    parent.keepChildOrder = false;
+    parent.remove(*objects[0]);
+    CHECK(parent.children == std::vector<Object3D*>{objects[4].get(), objects[2].get(), objects[3].get()});
+    CHECK(removed.count == 2);
+
+    parent.removeAll({objects[2].get(), objects[1].get(), objects[2].get()});
+    CHECK(parent.children == std::vector<Object3D*>{objects[4].get(), objects[3].get()});
+    CHECK(removed.count == 3);
+    CHECK(batchRemoved.count == 1);
+
+    // reparenting in bulk
+    Object3D other;
+    other.addAll(std::vector<Object3D*>{objects[3].get(), objects[0].get()});
+    CHECK(parent.children == std::vector<Object3D*>{objects[4].get()});
+    CHECK(other.children == std::vector<Object3D*>{objects[3].get(), objects[0].get()});
+    CHECK(objects[3]->parent == &other);
+
+    // owned children stay alive until removed
+    std::weak_ptr<Object3D> weak = objects[4];
+    objects.clear();
+    CHECK(!weak.expired());
+    parent.clear();
+    CHECK(weak.expired());
+    CHECK(batchRemoved.count == 3);
+}
+
+TEST_CASE("destruction is distinct from dispose") {
+
+    struct Counter: EventListener {
+        int count = 0;
+        void onEvent(Event&) override { ++count; }
+    } disposed, destroyed;
+
+    {
+        Object3D object;
+        object.addEventListener(events::dispose, &disposed);
+        object.addEventListener(events::destroyed, &destroyed);
+    }
+
+    CHECK(disposed.count == 0);
+    CHECK(destroyed.count == 1);
+}
+
+TEST_CASE("traverse") {
+
+    Object3D root;
+    root.name = "root";
+
+    std::vector<std::shared_ptr<Object3D>> objects;
+    for (auto name : {"a", "b", "c", "d"}) {
+        auto o = Object3D::create();
+        o->name = name;
+        objects.emplace_back(o);
+    }
+    auto mesh = Mesh::create();
+    mesh->name = "mesh";
+
+    // root -> a -> (b, mesh), c -> d
+    root.add(objects[0]);
+    objects[0]->add(objects[1]);
+    objects[0]->add(mesh);
+    root.add(objects[2]);
+    objects[2]->add(objects[3]);
+
+    std::string order;
+    root.traverse([&](Object3D& o) { order += o.name + " "; });
+    CHECK(order == "root a b mesh c d ");
+
+    order.clear();
+    root.traverse([&](Object3D& o) {
+        order += o.name + " ";
+        return o.name == "a" ? TraverseResult::SkipChildren : TraverseResult::Continue;
+    });
+    CHECK(order == "root a c d ");
+
+    order.clear();
+    root.traverse([&](Object3D& o) {
+        order += o.name + " ";
+        return o.name == "mesh" ? TraverseResult::Stop : TraverseResult::Continue;
+    });
+    CHECK(order == "root a b mesh ");
+
+    order.clear();
+    objects[0]->visible = false;
+    root.traverseVisible([&](Object3D& o) { order += o.name + " "; });
+    CHECK(order == "root c d ");
+
+    int meshes = 0;
+    root.traverseType<Mesh>([&](Mesh&) { ++meshes; });
+    CHECK(meshes == 1);
+
+    order.clear();
+    const std::function<void(Object3D&)> f = [&](Object3D& o) { order += o.name + " "; };
+    mesh->traverseAncestors(f);
+    CHECK(order == "a root ");
+}
+
+TEST_CASE("world bounds are cached") {
+
+    auto mesh = Mesh::create(BoxGeometry::create(2, 2, 2));
+    mesh->position.set(10, 0, 0);
+    mesh->updateMatrixWorld();
+
+    const auto sphere = mesh->worldBoundingSphere();
+    REQUIRE(sphere);
+    CHECK(sphere->center == Vector3(10, 0, 0));
+    CHECK_THAT(sphere->radius, Catch::Matchers::WithinRel(std::sqrt(3.f)));
+
+    const auto box = mesh->worldBoundingBox();
+    REQUIRE(box);
+    CHECK(box->min() == Vector3(9, -1, -1));
+    CHECK(box->max() == Vector3(11, 1, 1));
+
+    mesh->scale.set(2, 2, 2);
+    mesh->updateMatrixWorld();
+    CHECK(mesh->worldBoundingBox()->max() == Vector3(12, 2, 2));
+
+    mesh->geometry()->boundingBox->set(Vector3(-1, -1, -1), Vector3(2, 1, 1));
+    CHECK(mesh->worldBoundingBox()->max() == Vector3(14, 2, 2));
+
+    CHECK(Object3D().worldBoundingSphere() == nullptr);
+}
+
+TEST_CASE("group subtree bounds") {
+
+    auto group = Group::create();
+    auto nested = Group::create();
+    auto a = Mesh::create(BoxGeometry::create(2, 2, 2));
+    auto b = Mesh::create(BoxGeometry::create(2, 2, 2));
+    a->position.x = -5;
+    b->position.x = 5;
+    group->add(a);
+    group->add(nested);
+    nested->add(b);
+    group->updateMatrixWorld();
+
+    group->updateSubtreeBounds();
+    REQUIRE(group->subtreeBounds());
+    REQUIRE(nested->subtreeBounds());
+    CHECK(group->subtreeBounds()->containsPoint(Vector3(-5, 0, 0)));
+    CHECK(group->subtreeBounds()->containsPoint(Vector3(5, 0, 0)));
+    CHECK(!nested->subtreeBounds()->containsPoint(Vector3(-5, 0, 0)));
+
+    // objects that must always be visited prevent culling of the subtree, but not of unrelated groups
+    b->frustumCulled = false;
+    group->updateSubtreeBounds();
+    CHECK(!group->subtreeBounds());
+    CHECK(!nested->subtreeBounds());
+
+    b->frustumCulled = true;
+    a->add(Object3D::create());
+    group->updateSubtreeBounds();
+    CHECK(group->subtreeBounds());
+}
@@ -0,0 +1,133 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/core/PointOctree.hpp"
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/math/MathUtils.hpp"
+#include "threepp/objects/Points.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace threepp;
+
+namespace {
+
+    std::shared_ptr<Points> createCloud(size_t count) {
+
+        std::vector<float> positions(count * 3);
+        for (auto& value : positions) value = math::randFloatSpread(20);
+
+        auto geometry = BufferGeometry::create();
+        geometry->setAttribute("position", FloatBufferAttribute::create(positions, 3));
+
+        auto points = Points::create(geometry);
+        points->rotation.y = 0.4f;
+        points->updateMatrixWorld();
+
+        return points;
+    }
+
+    std::vector<std::pair<int, float>> hits(Raycaster& raycaster, Points& points) {
+
+        std::vector<std::pair<int, float>> result;
+        for (const auto& intersection : raycaster.intersectObject(points)) {
+
+            result.emplace_back(*intersection.index, *intersection.distanceToRay);
+        }
+
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    void compare(Points& points, unsigned int threads) {
+
+        auto geometry = points.geometry();
+        Raycaster raycaster;
+        raycaster.params.pointsThreshold = 0.1f;
+
+        std::vector<std::vector<std::pair<int, float>>> expected;
+        for (int i = 0; i < 20; ++i) {
+
+            const auto angle = static_cast<float>(i) * 0.3f;
+            raycaster.ray.set({std::cos(angle) * 30, 1, std::sin(angle) * 30}, Vector3(-std::cos(angle), 0, -std::sin(angle)));
+            expected.emplace_back(hits(raycaster, points));
+        }
+
+        if (!geometry->pointsTree || threads > 0) geometry->computePointsTree(threads);
+
+        size_t total = 0;
+        for (int i = 0; i < 20; ++i) {
+
+            const auto angle = static_cast<float>(i) * 0.3f;
+            raycaster.ray.set({std::cos(angle) * 30, 1, std::sin(angle) * 30}, Vector3(-std::cos(angle), 0, -std::sin(angle)));
+
+            CHECK(hits(raycaster, points) == expected[i]);
+            total += expected[i].size();
+        }
+
+        CHECK(total > 0);
+    }
+
+}// namespace
+
+TEST_CASE("raycast matches brute force") {
+
+    auto points = createCloud(100000);
+
+    compare(*points, 1);
+    compare(*points, 4);
+
+    points->geometry()->setDrawRange(1000, 50000);
+    compare(*points, 0);
+}
+
+TEST_CASE("update after moving points") {
+
+    auto points = createCloud(20000);
+    auto geometry = points->geometry();
+    geometry->computePointsTree();
+
+    auto position = geometry->getAttribute<float>("position");
+    auto& tree = *geometry->pointsTree;
+    CHECK(tree.size() == 20000);
+
+    // move a range of points far away
+    for (int i = 100; i < 200; ++i) position->setXYZ(i, 50, 50, static_cast<float>(i) * 0.01f);
+    position->updateRange = {300, 300};
+    position->needsUpdate();
+
+    CHECK(!tree.matches(*position));
+    tree.update(*position);
+    CHECK(tree.matches(*position));
+    CHECK(tree.bounds().max().x == 50);
+
+    compare(*points, 0);
+}
+
+TEST_CASE("update honours update ranges") {
+
+    auto points = createCloud(20000);
+    auto geometry = points->geometry();
+    geometry->computePointsTree();
+
+    auto position = geometry->getAttribute<float>("position");
+    auto& tree = *geometry->pointsTree;
+
+    // two separate runs of points, in array elements
+    for (int i = 100; i < 110; ++i) position->setXYZ(i, 60, 0, 0);
+    for (int i = 5000; i < 5010; ++i) position->setXYZ(i, 0, -60, 0);
+    position->addUpdateRange(300, 30);
+    position->addUpdateRange(15000, 30);
+    position->needsUpdate();
+
+    tree.update(*position);
+    CHECK(tree.matches(*position));
+    CHECK(tree.bounds().max().x == 60);
+    CHECK(tree.bounds().min().y == -60);
+
+    // left for the renderer to upload
+    CHECK(position->updateRanges.size() == 2);
+
+    compare(*points, 0);
+}
@@ -0,0 +1,201 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/geometries/TorusKnotGeometry.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/scenes/Scene.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using namespace threepp;
+
+namespace {
+
+    std::shared_ptr<Scene> createScene() {
+
+        auto scene = Scene::create();
+
+        auto geometry = TorusKnotGeometry::create();
+        for (int i = 0; i < 4; ++i) {
+
+            auto mesh = Mesh::create(geometry);
+            mesh->position.set(static_cast<float>(i) * 3 - 4.5f, 0, 0);
+            scene->add(mesh);
+        }
+
+        auto instanced = InstancedMesh::create(geometry, nullptr, 2);
+        Matrix4 matrix;
+        instanced->setMatrixAt(0, matrix.makeTranslation(0, 3, 0));
+        instanced->setMatrixAt(1, matrix.makeTranslation(0, -3, 0));
+        scene->add(instanced);
+
+        scene->updateMatrixWorld();
+
+        return scene;
+    }
+
+    // rays fanning out from the camera position
+    std::vector<Ray> createRays(size_t count) {
+
+        std::vector<Ray> rays;
+        for (size_t i = 0; i < count; ++i) {
+
+            const auto t = static_cast<float>(i) / static_cast<float>(count);
+            Vector3 direction(std::sin(t * 6.28f) * 0.4f, std::cos(t * 12.56f) * 0.4f, -1);
+            rays.emplace_back(Vector3(0, 0, 10), direction.normalize());
+        }
+
+        return rays;
+    }
+
+}// namespace
+
+TEST_CASE("intersectBatch matches intersectObject") {
+
+    auto scene = createScene();
+    const auto rays = createRays(500);
+
+    Raycaster raycaster;
+
+    std::vector<std::vector<Intersection>> expected;
+    for (const auto& ray : rays) {
+
+        raycaster.ray.copy(ray);
+        expected.emplace_back(raycaster.intersectObject(*scene, true));
+    }
+
+    RaycastResults results;
+
+    for (unsigned int threads : {1u, 4u}) {
+
+        raycaster.threads = threads;
+        raycaster.intersectBatch(rays, {scene.get()}, results, true);
+
+        REQUIRE(results.numRays() == rays.size());
+
+        size_t hits = 0;
+        for (size_t i = 0; i < rays.size(); ++i) {
+
+            REQUIRE(results.numIntersections(i) == expected[i].size());
+
+            auto it = results.begin(i);
+            for (const auto& intersection : expected[i]) {
+
+                CHECK(it->object == intersection.object);
+                CHECK(it->distance == intersection.distance);
+                CHECK(it->instanceId == intersection.instanceId);
+                ++it;
+            }
+            hits += expected[i].size();
+        }
+
+        CHECK(hits > 0);
+        CHECK(results.intersections.size() == hits);
+    }
+}
+
+TEST_CASE("raycasting from several threads") {
+
+    auto scene = createScene();
+    const auto rays = createRays(200);
+
+    Raycaster raycaster;
+    std::vector<size_t> expected;
+    for (const auto& ray : rays) {
+
+        raycaster.ray.copy(ray);
+        expected.emplace_back(raycaster.intersectObject(*scene, true).size());
+    }
+
+    std::vector<std::vector<size_t>> counts(4);
+    std::vector<std::thread> threads;
+    for (auto& count : counts) {
+
+        threads.emplace_back([&] {
+            Raycaster local;
+            std::vector<Intersection> intersects;
+            for (const auto& ray : rays) {
+
+                local.ray.copy(ray);
+                intersects.clear();
+                local.intersectObject(*scene, true, intersects);
+                count.emplace_back(intersects.size());
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    for (const auto& count : counts) {
+
+        CHECK(count == expected);
+    }
+}
+
+TEST_CASE("InstancedMesh raycast") {
+
+    auto geometry = TorusKnotGeometry::create(1, 0.4f, 32, 8);
+    auto instanced = InstancedMesh::create(geometry, nullptr, 1000);
+
+    // the same instances as separate meshes
+    auto scene = Scene::create();
+
+    Matrix4 matrix;
+    for (int i = 0; i < 1000; ++i) {
+
+        matrix.makeTranslation(static_cast<float>(i % 10) * 3, static_cast<float>(i / 10 % 10) * 3, static_cast<float>(i / 100) * 3);
+        instanced->setMatrixAt(i, matrix);
+
+        auto mesh = Mesh::create(geometry);
+        mesh->position.setFromMatrixPosition(matrix);
+        scene->add(mesh);
+    }
+
+    scene->updateMatrixWorld();
+    instanced->updateMatrixWorld();
+
+    const auto check = [&] {
+        Raycaster raycaster;
+
+        for (const auto& ray : createRays(100)) {
+
+            raycaster.ray.set(Vector3(13.5f, 13.5f, 50), ray.direction);
+
+            const auto expected = raycaster.intersectObject(*scene, true);
+            const auto intersects = raycaster.intersectObject(*instanced);
+
+            REQUIRE(intersects.size() == expected.size());
+            for (size_t i = 0; i < intersects.size(); ++i) {
+
+                CHECK(intersects[i].distance == expected[i].distance);
+                const auto mesh = std::find(scene->children.begin(), scene->children.end(), expected[i].object);
+                CHECK(*intersects[i].instanceId == mesh - scene->children.begin());
+            }
+
+            raycaster.firstHitOnly = true;
+            const auto first = raycaster.intersectObject(*instanced);
+            raycaster.firstHitOnly = false;
+
+            REQUIRE(first.size() == (expected.empty() ? 0 : 1));
+            if (!first.empty()) CHECK(first.front().distance == expected.front().distance);
+        }
+    };
+
+    check();
+
+    // moving instances refits the hierarchy
+    for (int i = 0; i < 1000; ++i) {
+
+        auto mesh = scene->children[i];
+        mesh->position.z += 1;
+        matrix.makeTranslation(mesh->position.x, mesh->position.y, mesh->position.z);
+        instanced->setMatrixAt(i, matrix);
+    }
+    instanced->instanceMatrix->needsUpdate();
+    scene->updateMatrixWorld();
+
+    check();
+}
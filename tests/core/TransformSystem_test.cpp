@@ -0,0 +1,143 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/core/Object3D.hpp"
+#include "threepp/core/TransformSystem.hpp"
+
+#include <cmath>
+
+using namespace threepp;
+
+namespace {
+
+    bool matricesEqual(const Matrix4& a, const Matrix4& b, float eps = 1e-5f) {
+
+        for (int i = 0; i < 16; ++i) {
+            if (std::abs(a.elements[i] - b.elements[i]) > eps) return false;
+        }
+        return true;
+    }
+
+    // builds two identical hierarchies
+    std::vector<std::shared_ptr<Object3D>> makeChain(Object3D& root, int depth, int branching, std::vector<Object3D*>& out) {
+
+        std::vector<std::shared_ptr<Object3D>> owned;
+
+        std::vector<Object3D*> level{&root};
+        for (int d = 0; d < depth; ++d) {
+
+            std::vector<Object3D*> next;
+            for (auto parent : level) {
+                for (int b = 0; b < branching; ++b) {
+
+                    auto o = Object3D::create();
+                    o->position.set(static_cast<float>(b), static_cast<float>(d), 1);
+                    o->rotation.set(0.1f * static_cast<float>(d), 0.2f * static_cast<float>(b), 0.3f);
+                    o->scale.set(1.1f, 0.9f, 1);
+                    parent->add(o);
+
+                    next.emplace_back(o.get());
+                    out.emplace_back(o.get());
+                    owned.emplace_back(o);
+                }
+            }
+            level = next;
+        }
+
+        return owned;
+    }
+
+}// namespace
+
+TEST_CASE("Matches recursive updateMatrixWorld") {
+
+    Object3D referenceRoot;
+    Object3D root;
+    referenceRoot.position.set(1, 2, 3);
+    root.position.set(1, 2, 3);
+
+    std::vector<Object3D*> reference, objects;
+    auto ownedA = makeChain(referenceRoot, 4, 3, reference);
+    auto ownedB = makeChain(root, 4, 3, objects);
+
+    TransformSystem system(root);
+    CHECK(system.size() == objects.size() + 1);
+
+    for (int frame = 0; frame < 2; ++frame) {
+
+        reference[frame]->position.x += 1;
+        objects[frame]->position.x += 1;
+
+        referenceRoot.updateMatrixWorld();
+        system.update();
+
+        for (size_t i = 0; i < objects.size(); ++i) {
+            REQUIRE(matricesEqual(*objects[i]->matrixWorld, *reference[i]->matrixWorld));
+        }
+    }
+}
+
+TEST_CASE("Rebuilds on hierarchy changes") {
+
+    Object3D root;
+    auto child = Object3D::create();
+    child->position.set(0, 1, 0);
+    root.add(child);
+
+    TransformSystem system(root);
+    REQUIRE(system.size() == 2);
+
+    auto grandChild = Object3D::create();
+    grandChild->position.set(0, 0, 2);
+    child->add(grandChild);
+
+    system.update();
+    CHECK(system.size() == 3);
+    Vector3 position;
+    grandChild->getWorldPosition(position);
+    CHECK(position.equals(Vector3(0, 1, 2)));
+
+    child->remove(*grandChild);
+    system.update();
+    CHECK(system.size() == 2);
+}
+
+TEST_CASE("Cameras update their inverse") {
+
+    Object3D root;
+    root.position.set(0, 0, 5);
+    auto camera = PerspectiveCamera::create();
+    root.add(camera);
+
+    TransformSystem system(root);
+    system.update();
+
+    Matrix4 expected;
+    expected.makeTranslation(0, 0, -5);
+    CHECK(matricesEqual(camera->matrixWorldInverse, expected));
+}
+
+TEST_CASE("Shared matrices stay shared") {
+
+    Object3D root;
+    auto followed = Object3D::create();
+    followed->position.set(1, 2, 3);
+    root.add(followed);
+
+    auto follower = Object3D::create();
+    follower->shareMatrix(followed->matrixWorld);
+    follower->matrixAutoUpdate = false;
+    root.add(follower);
+
+    TransformSystem system(root);
+    CHECK(system.size() == 1);
+
+    followed->position.set(4, 5, 6);
+    system.update();
+
+    CHECK(follower->matrix == followed->matrixWorld);
+    Vector3 position;
+    follower->getWorldPosition(position);
+    CHECK(position.equals(Vector3(4, 5, 6)));
+}
@@ -0,0 +1,181 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/core/TriangleBVH.hpp"
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/geometries/TorusKnotGeometry.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/objects/Mesh.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+using namespace threepp;
+
+namespace {
+
+    std::vector<Intersection> sorted(std::vector<Intersection> intersects) {
+
+        std::sort(intersects.begin(), intersects.end(), [](const auto& a, const auto& b) {
+            return a.distance < b.distance || (a.distance == b.distance && *a.faceIndex < *b.faceIndex);
+        });
+
+        return intersects;
+    }
+
+    // raycasts towards the origin from points around the mesh, with and without the bounds tree
+    void compare(Mesh& mesh, Raycaster& raycaster, unsigned int threads) {
+
+        auto geometry = mesh.geometry();
+        mesh.updateMatrixWorld();
+
+        std::vector<std::vector<Intersection>> expected;
+        for (int i = 0; i < 32; ++i) {
+
+            const auto angle = static_cast<float>(i) * 0.39f;
+            const Vector3 origin(std::cos(angle) * 5, std::sin(angle * 0.7f) * 2, std::sin(angle) * 5);
+            raycaster.set(origin, Vector3().sub(origin).add({0.1f, 0.2f, 0}).normalize());
+            expected.emplace_back(sorted(raycaster.intersectObject(mesh)));
+        }
+
+        geometry->computeBoundsTree(threads);
+        REQUIRE(geometry->boundsTree);
+
+        for (int i = 0; i < 32; ++i) {
+
+            const auto angle = static_cast<float>(i) * 0.39f;
+            const Vector3 origin(std::cos(angle) * 5, std::sin(angle * 0.7f) * 2, std::sin(angle) * 5);
+            raycaster.set(origin, Vector3().sub(origin).add({0.1f, 0.2f, 0}).normalize());
+
+            const auto intersects = sorted(raycaster.intersectObject(mesh));
+
+            REQUIRE(intersects.size() == expected[i].size());
+            for (size_t j = 0; j < intersects.size(); ++j) {
+
+                CHECK(intersects[j].faceIndex == expected[i][j].faceIndex);
+                CHECK(intersects[j].distance == expected[i][j].distance);
+                CHECK(intersects[j].face->materialIndex == expected[i][j].face->materialIndex);
+            }
+        }
+
+        geometry->boundsTree = nullptr;
+    }
+
+}// namespace
+
+TEST_CASE("raycast matches brute force") {
+
+    Raycaster raycaster;
+
+    SECTION("indexed") {
+
+        auto mesh = Mesh::create(TorusKnotGeometry::create(1, 0.4f, 128, 32));
+        compare(*mesh, raycaster, 1);
+        compare(*mesh, raycaster, 4);
+    }
+
+    SECTION("non-indexed") {
+
+        auto mesh = Mesh::create(TorusKnotGeometry::create()->toNonIndexed());
+        compare(*mesh, raycaster, 1);
+    }
+
+    SECTION("groups and draw range") {
+
+        std::vector<std::shared_ptr<Material>> materials;
+        for (int i = 0; i < 6; ++i) materials.emplace_back(MeshBasicMaterial::create());
+
+        auto geometry = BoxGeometry::create(2, 2, 2, 8, 8, 8);
+        geometry->setDrawRange(0, geometry->getIndex()->count() / 2);
+
+        auto mesh = Mesh::create(geometry, materials);
+        mesh->rotation.set(0.3f, 0.5f, 0);
+        mesh->scale.set(1, 2, 1);
+        compare(*mesh, raycaster, 1);
+    }
+
+    SECTION("firstHitOnly") {
+
+        raycaster.firstHitOnly = true;
+
+        auto mesh = Mesh::create(TorusKnotGeometry::create());
+        compare(*mesh, raycaster, 1);
+    }
+}
+
+TEST_CASE("copies drop the cached hierarchies") {
+
+    auto geometry = BoxGeometry::create();
+    geometry->computeBoundsTree();
+    geometry->computePointsTree();
+
+    auto copy = BufferGeometry::create();
+    copy->boundsTree = geometry->boundsTree;
+    copy->pointsTree = geometry->pointsTree;
+    copy->copy(*geometry);
+
+    CHECK(!copy->boundsTree);
+    CHECK(!copy->pointsTree);
+    CHECK(geometry->boundsTree);
+}
+
+TEST_CASE("serialize") {
+
+    auto geometry = TorusKnotGeometry::create();
+    auto tree = TriangleBVH::create(*geometry);
+
+    std::stringstream ss;
+    tree->serialize(ss);
+
+    auto copy = TriangleBVH::deserialize(ss);
+    REQUIRE(copy);
+    CHECK(copy->matches(*geometry));
+    CHECK(copy->triangleCount() == tree->triangleCount());
+    CHECK(copy->bounds().equals(tree->bounds()));
+
+    std::stringstream garbage("not a tree");
+    CHECK(!TriangleBVH::deserialize(garbage));
+}
+
+TEST_CASE("deserialize rejects corrupt trees") {
+
+    auto geometry = TorusKnotGeometry::create();
+    auto tree = TriangleBVH::create(*geometry);
+
+    std::stringstream ss;
+    tree->serialize(ss);
+    const auto bytes = ss.str();
+
+    // header: magic, version, node count, triangle count
+    constexpr size_t headerSize = 16;
+    constexpr size_t nodeSize = 44;
+    constexpr size_t leftOffset = 6 * sizeof(float) + 2 * sizeof(uint32_t);
+
+    SECTION("node count out of bounds") {
+
+        auto corrupt = bytes;
+        const uint32_t nodeCount = 0xFFFFFFFF;
+        std::memcpy(corrupt.data() + 8, &nodeCount, sizeof(nodeCount));
+
+        std::stringstream in(corrupt);
+        CHECK(!TriangleBVH::deserialize(in));
+    }
+
+    SECTION("self-referencing node") {
+
+        auto corrupt = bytes;
+        const uint32_t self = 0;
+        std::memcpy(corrupt.data() + headerSize + leftOffset, &self, sizeof(self));
+
+        std::stringstream in(corrupt);
+        CHECK(!TriangleBVH::deserialize(in));
+    }
+
+    SECTION("truncated") {
+
+        std::stringstream in(bytes.substr(0, bytes.size() - nodeSize));
+        CHECK(!TriangleBVH::deserialize(in));
+    }
+}
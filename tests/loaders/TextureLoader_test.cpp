@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/loaders/MipmapChain.hpp"
+#include "threepp/loaders/TextureLoader.hpp"
+
+using namespace threepp;
+
+TEST_CASE("mipmap chain sizes") {
+
+    std::vector<unsigned char> data(5 * 3 * 4);
+    Image image(data, 5, 3);
+
+    const auto chain = generateMipmapChain(image, 4);
+
+    REQUIRE(chain.size() == 3);
+    CHECK((chain[0].width == 5 && chain[0].height == 3));
+    CHECK((chain[1].width == 2 && chain[1].height == 1));
+    CHECK((chain[2].width == 1 && chain[2].height == 1));
+
+    for (auto level : chain) {
+
+        CHECK(level.data().size() == static_cast<size_t>(level.width) * level.height * 4);
+        CHECK(level.flipped() == image.flipped());
+    }
+}
+
+TEST_CASE("mipmap chain contents") {
+
+    // 2x2 RGB, one channel per texel differing
+    std::vector<unsigned char> data{
+            0, 10, 255, 4, 10, 255,
+            8, 10, 0, 1, 10, 0};
+    Image image(data, 2, 2, false);
+
+    auto chain = generateMipmapChain(image, 3);
+
+    REQUIRE(chain.size() == 2);
+    CHECK(chain[0].data() == data);
+    // rounded box filter
+    CHECK(chain[1].data() == std::vector<unsigned char>{3, 10, 128});
+
+    // odd sizes repeat the last column
+    std::vector<unsigned char> row{0, 30, 90};
+    Image odd(row, 3, 1, false);
+
+    chain = generateMipmapChain(odd, 1);
+
+    REQUIRE(chain.size() == 2);
+    CHECK(chain[1].data() == std::vector<unsigned char>{15});
+}
+
+TEST_CASE("loadAsync") {
+
+    TextureLoader loader;
+
+    auto future = loader.loadAsync(std::string(DATA_FOLDER) + "/textures/checker.png");
+    const auto texture = future.get();
+
+    REQUIRE(texture);
+    REQUIRE(texture->image);
+    CHECK(texture->image->width == 256);
+    CHECK(texture->image->height == 256);
+    CHECK(texture->format == Format::RGBA);
+    CHECK(texture->version() > 0);
+
+    // 256 down to 1
+    REQUIRE(texture->mipmaps.size() == 9);
+    CHECK(texture->mipmaps.back().width == 1);
+    CHECK_FALSE(texture->generateMipmaps);
+
+    CHECK(loader.loadAsync(std::string(DATA_FOLDER) + "/textures/checker.png").get() == texture);
+
+    CHECK_FALSE(loader.loadAsync(std::string(DATA_FOLDER) + "/textures/missing.png").get());
+
+    TextureLoader uncached(false);
+    const auto plain = uncached.loadAsync(std::string(DATA_FOLDER) + "/textures/checker.png", true, false).get();
+
+    REQUIRE(plain);
+    CHECK(plain != texture);
+    CHECK(plain->mipmaps.empty());
+}
@@ -0,0 +1,130 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/geometries/PlaneGeometry.hpp"
+#include "threepp/math/Capsule.hpp"
+#include "threepp/math/MathUtils.hpp"
+#include "threepp/math/Octree.hpp"
+#include "threepp/math/Ray.hpp"
+#include "threepp/math/Sphere.hpp"
+#include "threepp/objects/Group.hpp"
+#include "threepp/objects/Mesh.hpp"
+
+#include <cmath>
+
+using namespace threepp;
+
+namespace {
+
+    // a 20x20 floor at y = 0, large enough to be built in parallel, and a number of small boxes scattered above it
+    std::shared_ptr<Group> createWorld(int boxes) {
+
+        auto world = Group::create();
+
+        auto floor = Mesh::create(PlaneGeometry::create(20, 20, 96, 96));
+        floor->rotation.x = -math::PI / 2;
+        world->add(floor);
+
+        for (int i = 0; i < boxes; ++i) {
+
+            auto box = Mesh::create(BoxGeometry::create(0.2f, 0.2f, 0.2f));
+            box->position.set(std::sin(i * 1.3f) * 9, 5 + std::cos(i * 0.7f) * 2, std::cos(i * 1.1f) * 9);
+            world->add(box);
+        }
+
+        return world;
+    }
+
+}// namespace
+
+TEST_CASE("collisions with the floor") {
+
+    auto world = createWorld(100);
+
+    for (auto threads : {1u, 4u}) {
+
+        Octree octree;
+        octree.fromGraphNode(*world, threads);
+
+        CHECK(octree.triangleCount() == 96 * 96 * 2 + 100 * 12);
+        CHECK_THAT(octree.bounds().min().y, Catch::Matchers::WithinAbs(0, 1e-5));
+
+        SECTION("sphere") {
+
+            CHECK(!octree.sphereIntersect(Sphere({1, 0.6f, 2}, 0.5f)));
+
+            const auto collision = octree.sphereIntersect(Sphere({1, 0.3f, 2}, 0.5f));
+            REQUIRE(collision);
+            CHECK_THAT(collision->normal.y, Catch::Matchers::WithinAbs(1, 1e-4));
+            CHECK_THAT(collision->depth, Catch::Matchers::WithinAbs(0.2f, 1e-4));
+        }
+
+        SECTION("capsule") {
+
+            CHECK(!octree.capsuleIntersect(Capsule({-2, 0.6f, 3}, {-2, 1.6f, 3}, 0.5f)));
+
+            const auto collision = octree.capsuleIntersect(Capsule({-2, 0.35f, 3}, {-2, 1.35f, 3}, 0.5f));
+            REQUIRE(collision);
+            CHECK_THAT(collision->normal.y, Catch::Matchers::WithinAbs(1, 1e-4));
+            CHECK_THAT(collision->depth, Catch::Matchers::WithinAbs(0.15f, 1e-4));
+        }
+
+        SECTION("ray") {
+
+            const auto hit = octree.rayIntersect(Ray({0.5f, 1, 0.5f}, {0, -1, 0}));
+            REQUIRE(hit);
+            CHECK_THAT(hit->distance, Catch::Matchers::WithinAbs(1, 1e-4));
+            CHECK_THAT(hit->position.y, Catch::Matchers::WithinAbs(0, 1e-5));
+
+            // backfaces are ignored
+            CHECK(!octree.rayIntersect(Ray({0.5f, -1, 0.5f}, {0, 1, 0})));
+        }
+    }
+}
+
+TEST_CASE("ray hits the nearest triangle") {
+
+    auto world = createWorld(0);
+
+    auto box = Mesh::create(BoxGeometry::create(1, 1, 1));
+    box->position.set(3, 2, 3);
+    world->add(box);
+
+    Octree octree;
+    octree.fromGraphNode(*world);
+
+    const auto hit = octree.rayIntersect(Ray({3, 10, 3}, {0, -1, 0}));
+    REQUIRE(hit);
+    CHECK_THAT(hit->distance, Catch::Matchers::WithinAbs(7.5f, 1e-4));
+    CHECK_THAT(hit->position.y, Catch::Matchers::WithinAbs(2.5f, 1e-4));
+
+    octree.clear();
+    CHECK(octree.triangleCount() == 0);
+    CHECK(!octree.rayIntersect(Ray({3, 10, 3}, {0, -1, 0})));
+}
+
+TEST_CASE("ray hits the nearest triangle for any direction length") {
+
+    auto world = createWorld(0);
+
+    for (auto y : {2.f, 6.f}) {
+
+        auto box = Mesh::create(BoxGeometry::create(1, 1, 1));
+        box->position.set(3, y, 3);
+        world->add(box);
+    }
+
+    Octree octree;
+    octree.fromGraphNode(*world);
+
+    // whichever box is visited first, the nearer one is found
+    const auto down = octree.rayIntersect(Ray({3, 10, 3}, {0, -0.1f, 0}));
+    REQUIRE(down);
+    CHECK_THAT(down->distance, Catch::Matchers::WithinAbs(3.5f, 1e-4));
+
+    const auto up = octree.rayIntersect(Ray({3, -2, 3}, {0, 0.1f, 0}));
+    REQUIRE(up);
+    CHECK_THAT(up->distance, Catch::Matchers::WithinAbs(3.5f, 1e-4));
+}
@@ -0,0 +1,117 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/math/batch.hpp"
+#include "threepp/math/Euler.hpp"
+#include "threepp/math/Quaternion.hpp"
+#include "threepp/math/infinity.hpp"
+
+#include <vector>
+
+using namespace threepp;
+
+namespace {
+
+    Matrix4 someMatrix() {
+
+        Matrix4 m;
+        m.compose(Vector3(1, -2, 3), Quaternion().setFromEuler(Euler(0.3f, -1.2f, 2.1f)), Vector3(2, 0.5f, 1.5f));
+        m.elements[3] = 0.01f;// some perspective
+
+        return m;
+    }
+
+}// namespace
+
+TEST_CASE("applyMatrix4 matches Vector3") {
+
+    const auto m = someMatrix();
+
+    // interleaved with a 4th component that must be left untouched
+    std::vector<float> data{1, 2, 3, 0, -4, 5, -6, 0, 7, 8, 9, 0};
+    const auto original = data;
+    math::applyMatrix4(m, data.data(), 3, 4);
+
+    for (unsigned i = 0; i < 3; ++i) {
+
+        Vector3 v;
+        v.fromArray(original, i * 4);
+        v.applyMatrix4(m);
+
+        CHECK(data[i * 4] == v.x);
+        CHECK(data[i * 4 + 1] == v.y);
+        CHECK(data[i * 4 + 2] == v.z);
+        CHECK(data[i * 4 + 3] == 0);
+    }
+}
+
+TEST_CASE("transformDirections matches Vector3") {
+
+    const auto m = someMatrix();
+
+    std::vector<float> data{1, 2, 3, -4, 5, -6};
+    math::transformDirections(m, data.data(), 2);
+
+    Vector3 a(1, 2, 3), b(-4, 5, -6);
+    a.transformDirection(m);
+    b.transformDirection(m);
+
+    CHECK(data[0] == a.x);
+    CHECK(data[1] == a.y);
+    CHECK(data[2] == a.z);
+    CHECK(data[3] == b.x);
+    CHECK(data[4] == b.y);
+    CHECK(data[5] == b.z);
+}
+
+TEST_CASE("computeBounds") {
+
+    std::vector<float> data{1, -2, 3, -4, 5, -6, 7, 8, 0};
+
+    Vector3 min, max;
+    math::computeBounds(data.data(), 3, 3, min, max);
+
+    CHECK(min == Vector3(-4, -2, -6));
+    CHECK(max == Vector3(7, 8, 3));
+
+    math::computeBounds(data.data(), 0, 3, min, max);
+    CHECK(min.x == Infinity<float>);
+    CHECK(max.x == -Infinity<float>);
+}
+
+TEST_CASE("computeBounds of interleaved positions") {
+
+    // normal then position, so the position of the last vertex ends the array
+    std::vector<float> data{0, 1, 0, 1, -2, 3, 0, 1, 0, -4, 5, -6, 0, 1, 0, 7, 8, 0};
+
+    Vector3 min, max;
+    math::computeBounds(data.data() + 3, 3, 6, min, max);
+
+    CHECK(min == Vector3(-4, -2, -6));
+    CHECK(max == Vector3(7, 8, 3));
+}
+
+TEST_CASE("multiplyMatrices and composeMatrices match Matrix4") {
+
+    const auto a = someMatrix();
+    Matrix4 b;
+    b.makeRotationAxis(Vector3(1, 1, 0).normalize(), 0.7f).setPosition(3, 2, 1);
+
+    Matrix4 expected;
+    expected.multiplyMatrices(a, b);
+
+    Matrix4 out;
+    math::multiplyMatrices(&a, &b, &out, 1);
+    CHECK(out.equals(expected));
+
+    const Vector3 position(1, 2, 3), scale(0.5f, 2, 3);
+    const Quaternion quaternion = Quaternion().setFromEuler(Euler(0.1f, 0.2f, 0.3f));
+
+    float p[]{position.x, position.y, position.z};
+    float q[]{quaternion.x(), quaternion.y(), quaternion.z(), quaternion.w()};
+    float s[]{scale.x, scale.y, scale.z};
+
+    math::composeMatrices(p, q, s, &out, 1);
+    expected.compose(position, quaternion, scale);
+    CHECK(out.equals(expected));
+}
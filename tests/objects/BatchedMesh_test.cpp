@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/geometries/SphereGeometry.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/math/Frustum.hpp"
+#include "threepp/objects/BatchedMesh.hpp"
+
+#include <stdexcept>
+
+using namespace threepp;
+
+TEST_CASE("add and remove geometries") {
+
+    // a box has 24 vertices and 36 indices
+    auto box = BoxGeometry::create();
+    auto mesh = BatchedMesh::create(3, 48, 72, MeshBasicMaterial::create());
+
+    const auto a = mesh->addGeometry(*box);
+    const auto b = mesh->addGeometry(*box);
+    CHECK(mesh->geometryCount() == 2);
+    CHECK_THROWS_AS(mesh->addGeometry(*box), std::runtime_error);
+
+    // the indices of the second box point to its own vertices
+    const auto index = mesh->geometry()->getIndex();
+    CHECK(index->getX(36) == box->getIndex()->getX(0) + 24);
+    CHECK(mesh->geometry()->getAttribute<float>("batchId")->getX(24) == static_cast<float>(b));
+
+    // a removed geometry leaves its room and id to the next one
+    mesh->removeGeometry(a);
+    CHECK_THROWS_AS(mesh->setMatrixAt(a, Matrix4()), std::out_of_range);
+    CHECK(mesh->addGeometry(*box) == a);
+
+    // attributes must match those of the first geometry
+    auto other = BufferGeometry::create();
+    other->setAttribute("position", FloatBufferAttribute::create(std::vector<float>(9), 3));
+    mesh->removeGeometry(a);
+    CHECK_THROWS_AS(mesh->addGeometry(*other), std::invalid_argument);
+}
+
+TEST_CASE("draw ranges follow visibility and culling") {
+
+    auto mesh = BatchedMesh::create(4, 1024, 1024, MeshBasicMaterial::create());
+
+    auto box = BoxGeometry::create();
+    const auto front = mesh->addGeometry(*box);
+    const auto behind = mesh->addGeometry(*box);
+    const auto hidden = mesh->addGeometry(*box);
+
+    mesh->setMatrixAt(front, Matrix4().makeTranslation(0, 0, -5));
+    mesh->setMatrixAt(behind, Matrix4().makeTranslation(0, 0, 5));
+    mesh->setMatrixAt(hidden, Matrix4().makeTranslation(0, 0, -5));
+    mesh->setVisibleAt(hidden, false);
+    mesh->updateMatrixWorld();
+
+    PerspectiveCamera camera(60, 1, 0.1f, 100);
+    camera.updateMatrixWorld();
+
+    CHECK(mesh->drawRanges(camera).starts == std::vector<int>{0, 36});
+
+    Matrix4 projScreenMatrix;
+    projScreenMatrix.multiplyMatrices(camera.projectionMatrix, camera.matrixWorldInverse);
+    Frustum frustum;
+    frustum.setFromProjectionMatrix(projScreenMatrix);
+
+    mesh->cull(frustum, camera);
+    CHECK(mesh->drawRanges(camera).starts == std::vector<int>{0});
+    CHECK(mesh->drawRanges(camera).counts == std::vector<int>{36});
+
+    // other cameras draw every visible geometry
+    PerspectiveCamera shadowCamera;
+    CHECK(mesh->drawRanges(shadowCamera).starts.size() == 2);
+}
+
+TEST_CASE("raycast reports the geometry hit") {
+
+    auto mesh = BatchedMesh::create(2, 4096, 8192, MeshBasicMaterial::create());
+
+    auto sphere = SphereGeometry::create(0.5f);
+    const auto left = mesh->addGeometry(*sphere);
+    const auto right = mesh->addGeometry(*sphere);
+
+    mesh->setMatrixAt(left, Matrix4().makeTranslation(-2, 0, 0));
+    mesh->setMatrixAt(right, Matrix4().makeTranslation(2, 0, 0));
+    mesh->position.z = -1;
+    mesh->updateMatrixWorld();
+
+    Raycaster raycaster({2, 0, 10}, {0, 0, -1});
+    const auto intersects = raycaster.intersectObject(*mesh);
+
+    REQUIRE(!intersects.empty());
+    REQUIRE(intersects.front().batchId);
+    CHECK(*intersects.front().batchId == right);
+    CHECK_THAT(intersects.front().distance, Catch::Matchers::WithinAbs(10.5f, 1e-3));
+
+    mesh->setVisibleAt(right, false);
+    CHECK(raycaster.intersectObject(*mesh).empty());
+}
@@ -0,0 +1,160 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/math/Frustum.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+
+using namespace threepp;
+
+namespace {
+
+    Frustum frustumOf(PerspectiveCamera& camera) {
+
+        camera.updateMatrixWorld();
+
+        Matrix4 projScreenMatrix;
+        projScreenMatrix.multiplyMatrices(camera.projectionMatrix, camera.matrixWorldInverse);
+
+        Frustum frustum;
+        frustum.setFromProjectionMatrix(projScreenMatrix);
+
+        return frustum;
+    }
+
+}// namespace
+
+TEST_CASE("cull instances into levels") {
+
+    // in front of the camera near and far, to the side and behind
+    const std::vector<Vector3> positions{{0, 0, -5}, {0, 0, -50}, {1, 0, -500}, {100, 0, -5}, {0, 0, 50}, {0, 0, -60}};
+
+    auto mesh = InstancedMesh::create(BoxGeometry::create(), MeshBasicMaterial::create(), positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+
+        mesh->setMatrixAt(i, Matrix4().makeTranslation(positions[i].x, positions[i].y, positions[i].z));
+        mesh->setColorAt(i, Color(static_cast<float>(i), 0, 0));
+    }
+
+    auto far = BoxGeometry::create(1, 1, 1, 1, 1, 1);
+    auto near = BoxGeometry::create(1, 1, 1, 2, 2, 2);
+    mesh->addLevel(far, 200);
+    mesh->addLevel(near, 30);
+
+    mesh->cullInstances = true;
+    mesh->updateMatrixWorld();
+
+    PerspectiveCamera camera(60, 1, 0.1f, 1000);
+    mesh->cull(frustumOf(camera), camera);
+
+    const auto& levels = mesh->levels();
+    REQUIRE(levels.size() == 3);
+    CHECK(levels[0].geometry.get() == mesh->geometry());
+    CHECK(levels[1].geometry == near);
+    CHECK(levels[2].geometry == far);
+
+    REQUIRE(levels[0].count == 1);
+    REQUIRE(levels[1].count == 2);
+    REQUIRE(levels[2].count == 1);
+
+    // compacted in instance order
+    CHECK_THAT(levels[1].instanceMatrix->array()[14], Catch::Matchers::WithinAbs(-50, 1e-5));
+    CHECK_THAT(levels[1].instanceMatrix->array()[16 + 14], Catch::Matchers::WithinAbs(-60, 1e-5));
+    CHECK_THAT(levels[1].instanceColor->array()[3], Catch::Matchers::WithinAbs(5, 1e-5));
+    CHECK_THAT(levels[2].instanceMatrix->array()[12], Catch::Matchers::WithinAbs(1, 1e-5));
+
+    CHECK(mesh->culledLevel(near.get(), camera) == &levels[1]);
+
+    PerspectiveCamera other;
+    CHECK(mesh->culledLevel(near.get(), other) == nullptr);
+
+    mesh->cullInstances = false;
+    CHECK(mesh->culledLevel(near.get(), camera) == nullptr);
+}
+
+TEST_CASE("instance bounds follow the mesh transform") {
+
+    auto mesh = InstancedMesh::create(BoxGeometry::create(), MeshBasicMaterial::create(), 2);
+    mesh->setMatrixAt(0, Matrix4().makeTranslation(0, 0, -10));
+    // large enough to reach into the frustum from beside it
+    mesh->setMatrixAt(1, Matrix4().makeTranslation(40, 0, -10).scale({60, 60, 60}));
+
+    mesh->position.x = 100;
+    mesh->cullInstances = true;
+    mesh->updateMatrixWorld();
+
+    PerspectiveCamera camera(60, 1, 0.1f, 1000);
+    mesh->cull(frustumOf(camera), camera);
+
+    CHECK(mesh->levels()[0].count == 0);
+
+    mesh->position.x = -40;
+    mesh->updateMatrixWorld();
+    mesh->cull(frustumOf(camera), camera);
+
+    REQUIRE(mesh->levels()[0].count == 1);
+    CHECK_THAT(mesh->levels()[0].instanceMatrix->array()[12], Catch::Matchers::WithinAbs(40, 1e-5));
+}
+
+TEST_CASE("add and remove instances") {
+
+    auto mesh = InstancedMesh::create(BoxGeometry::create(), MeshBasicMaterial::create(), 2);
+    mesh->count = 0;
+    mesh->instanceMatrix->clearUpdateRanges();
+
+    for (int i = 0; i < 5; ++i) {
+
+        CHECK(mesh->addInstance(Matrix4().makeTranslation(static_cast<float>(i), 0, 0)) == static_cast<size_t>(i));
+    }
+
+    CHECK(mesh->count == 5);
+    CHECK(mesh->capacity() >= 5);
+    CHECK(mesh->instanceMatrix->count() == static_cast<int>(mesh->capacity()));
+
+    mesh->instanceMatrix->clearUpdateRanges();
+
+    // the last instance takes the place of the removed one
+    mesh->removeInstance(1);
+    CHECK(mesh->count == 4);
+
+    Matrix4 matrix;
+    mesh->getMatrixAt(1, matrix);
+    CHECK_THAT(matrix.elements[12], Catch::Matchers::WithinAbs(4, 1e-5));
+
+    const auto& ranges = mesh->instanceMatrix->updateRanges;
+    REQUIRE(ranges.size() == 1);
+    CHECK(ranges.front().offset == 16);
+    CHECK(ranges.front().count == 16);
+
+    mesh->removeInstance(3);
+    CHECK(mesh->count == 3);
+    CHECK(ranges.size() == 1);
+}
+
+TEST_CASE("pending update ranges stay bounded") {
+
+    auto mesh = InstancedMesh::create(BoxGeometry::create(), MeshBasicMaterial::create(), 1000);
+    const auto& ranges = mesh->instanceMatrix->updateRanges;
+    mesh->instanceMatrix->clearUpdateRanges();
+
+    // instances set in order add a single range
+    for (size_t i = 0; i < 1000; ++i) mesh->setMatrixAt(i, Matrix4());
+
+    REQUIRE(ranges.size() == 1);
+    CHECK(ranges.front().offset == 0);
+    CHECK(ranges.front().count == 16000);
+
+    // scattered instances, set over many frames without being drawn
+    mesh->instanceMatrix->clearUpdateRanges();
+    for (int frame = 0; frame < 100; ++frame) {
+
+        for (size_t i = 10; i < 1000; i += 10) mesh->setMatrixAt(i, Matrix4());
+    }
+
+    CHECK(ranges.size() <= BufferAttribute::maxUpdateRanges);
+    CHECK(ranges.front().offset <= 160);
+    CHECK(ranges.back().offset + ranges.back().count >= 990 * 16 + 16);
+}
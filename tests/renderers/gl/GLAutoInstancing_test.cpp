@@ -0,0 +1,126 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/objects/Mesh.hpp"
+#include "threepp/renderers/gl/GLAutoInstancing.hpp"
+#include "threepp/renderers/gl/GLProperties.hpp"
+#include "threepp/renderers/gl/GLRenderLists.hpp"
+
+using namespace threepp;
+using namespace threepp::gl;
+
+TEST_CASE("merge meshes sharing geometry and material") {
+
+    auto geometry = BoxGeometry::create();
+    auto material = MeshBasicMaterial::create();
+    auto other = MeshBasicMaterial::create();
+    auto transparent = MeshBasicMaterial::create();
+    transparent->transparent = true;
+
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    for (int i = 0; i < 4; ++i) {
+
+        meshes.emplace_back(Mesh::create(geometry, material));
+        meshes.back()->position.x = static_cast<float>(i);
+    }
+    meshes.emplace_back(Mesh::create(geometry, other));
+    meshes.emplace_back(Mesh::create(geometry, transparent));
+    meshes.emplace_back(Mesh::create(geometry, transparent));
+
+    // mirrored
+    meshes[3]->scale.x = -1;
+
+    GLProperties properties;
+    GLRenderList list(properties);
+    GLAutoInstancing autoInstancing;
+
+    for (int frame = 0; frame < 2; ++frame) {
+
+        list.init();
+        for (auto& mesh : meshes) {
+
+            mesh->updateMatrixWorld();
+            list.push(mesh.get(), geometry.get(), mesh->material(), 0, 0, std::nullopt);
+        }
+
+        const auto merged = autoInstancing.merge(list);
+        REQUIRE(merged.size() == 1);
+
+        auto instanced = merged.front();
+        CHECK(instanced->count == 3);
+
+        Matrix4 matrix;
+        instanced->getMatrixAt(2, matrix);
+        CHECK_THAT(matrix.elements[12], Catch::Matchers::WithinAbs(2, 1e-5));
+
+        // the instanced mesh, the mirrored mesh and the other material
+        REQUIRE(list.opaque.size() == 3);
+        CHECK(list.opaque[0]->object == instanced);
+        CHECK(list.opaque[1]->object == meshes[3].get());
+        CHECK(list.opaque[2]->object == meshes[4].get());
+
+        CHECK(list.transparent.size() == 2);
+    }
+
+    autoInstancing.dispose();
+}
+
+TEST_CASE("batches live as long as their list draws them") {
+
+    auto geometry = BoxGeometry::create();
+    auto material = MeshBasicMaterial::create();
+
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    for (int i = 0; i < 2; ++i) {
+
+        meshes.emplace_back(Mesh::create(geometry, material));
+        meshes.back()->updateMatrixWorld();
+    }
+
+    GLProperties properties;
+    GLRenderList list(properties);
+    GLRenderList other(properties);
+    GLAutoInstancing autoInstancing;
+
+    const auto merge = [&](bool push) {
+        list.init();
+        if (push) {
+
+            for (auto& mesh : meshes) list.push(mesh.get(), geometry.get(), material.get(), 0, 0, std::nullopt);
+        }
+
+        const auto merged = autoInstancing.merge(list);
+        return merged.empty() ? nullptr : merged.front();
+    };
+
+    auto instanced = merge(true);
+    REQUIRE(instanced);
+
+    // merges of other lists, e.g. render targets drawn each frame, do not age the batch
+    for (int i = 0; i < 4; ++i) {
+
+        other.init();
+        autoInstancing.merge(other);
+    }
+    CHECK(merge(true) == instanced);
+
+    // unused by one merge of its list, the batch is kept, then disposed
+    bool disposed = false;
+    struct OnDispose: EventListener {
+        bool& disposed;
+        explicit OnDispose(bool& disposed): disposed(disposed) {}
+        void onEvent(Event&) override { disposed = true; }
+    } onDispose(disposed);
+    instanced->addEventListener(events::dispose, &onDispose);
+
+    merge(false);
+    CHECK(!disposed);
+    merge(false);
+    CHECK(disposed);
+
+    autoInstancing.dispose();
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/lights/PointLight.hpp"
+#include "threepp/renderers/gl/GLClusteredLights.hpp"
+
+#include <cmath>
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    bool clusterContains(const GLClusteredLights& clusters, int x, int y, int z, unsigned int light) {
+
+        auto [offset, count] = clusters.getCluster(x, y, z);
+        for (unsigned i = 0; i < count; ++i) {
+            if (clusters.getLightIndex(offset + i) == light) return true;
+        }
+
+        return false;
+    }
+
+    int depthSlice(const GLClusteredLights& clusters, float depth) {
+
+        return static_cast<int>(std::log(depth / clusters.depth.x) * clusters.depth.y * GLClusteredLights::gridZ);
+    }
+
+}// namespace
+
+TEST_CASE("bin point lights") {
+
+    auto camera = PerspectiveCamera::create(60, 16.f / 9, 0.1f, 100);
+    camera->updateMatrixWorld();
+
+    auto nearLight = PointLight::create(0xffffff, 1, 1);
+    nearLight->position.set(0, 0, -10);
+    nearLight->updateMatrixWorld();
+
+    auto farLight = PointLight::create(0xffffff, 1, 1);
+    farLight->position.set(0, 0, -50);
+    farLight->updateMatrixWorld();
+
+    std::vector<Light*> lights{nearLight.get(), farLight.get()};
+
+    GLClusteredLights clusters;
+    clusters.update(lights, *camera);
+
+    const auto centerX = GLClusteredLights::gridX / 2;
+    const auto centerY = GLClusteredLights::gridY / 2;
+
+    const auto nearSlice = depthSlice(clusters, 10);
+    const auto farSlice = depthSlice(clusters, 50);
+
+    CHECK(clusterContains(clusters, centerX, centerY, nearSlice, 0));
+    CHECK_FALSE(clusterContains(clusters, centerX, centerY, nearSlice, 1));
+
+    CHECK(clusterContains(clusters, centerX, centerY, farSlice, 1));
+    CHECK_FALSE(clusterContains(clusters, centerX, centerY, farSlice, 0));
+
+    // corner tiles are outside both lights
+    CHECK(clusters.getCluster(0, 0, nearSlice).second == 0);
+    CHECK(clusters.getCluster(GLClusteredLights::gridX - 1, GLClusteredLights::gridY - 1, farSlice).second == 0);
+}
+
+TEST_CASE("unlimited range") {
+
+    auto camera = PerspectiveCamera::create(60, 1, 0.1f, 100);
+    camera->updateMatrixWorld();
+
+    auto light = PointLight::create(0xffffff, 1, 0);
+    light->updateMatrixWorld();
+
+    std::vector<Light*> lights{light.get()};
+
+    GLClusteredLights clusters;
+    clusters.update(lights, *camera);
+
+    CHECK(clusterContains(clusters, 0, 0, 0, 0));
+    CHECK(clusterContains(clusters, GLClusteredLights::gridX - 1, GLClusteredLights::gridY - 1, GLClusteredLights::gridZ - 1, 0));
+}
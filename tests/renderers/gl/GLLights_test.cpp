@@ -0,0 +1,64 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/renderers/gl/GLLights.hpp"
+
+using namespace threepp;
+using namespace threepp::gl;
+
+TEST_CASE("unchanged lights keep their state") {
+
+    auto camera = PerspectiveCamera::create();
+    camera->updateMatrixWorld();
+
+    auto light = PointLight::create(0xffffff, 1);
+    auto shadowLight = PointLight::create(0xffffff, 1);
+    shadowLight->castShadow = true;
+
+    light->updateMatrixWorld();
+    shadowLight->updateMatrixWorld();
+
+    GLLights lights;
+
+    std::vector<Light*> lightsArray{light.get(), shadowLight.get()};
+    lights.setup(lightsArray);
+    lights.setupView(lightsArray, camera.get());
+
+    const auto version = lights.state.version;
+    REQUIRE(lightsArray.front() == shadowLight.get());
+
+    // a new, unsorted array of the same lights is given last frame's order
+    lightsArray = {light.get(), shadowLight.get()};
+    lights.setup(lightsArray);
+    lights.setupView(lightsArray, camera.get());
+
+    CHECK(lightsArray.front() == shadowLight.get());
+    CHECK(lights.state.version == version);
+
+    SECTION("intensity") {
+
+        light->intensity = 2;
+        lights.setup(lightsArray);
+
+        const auto& color = std::get<Color>(lights.state.point[1]->at("color"));
+        CHECK_THAT(color.r, Catch::Matchers::WithinRel(2.f));
+        CHECK(lights.state.version == version);
+    }
+
+    SECTION("camera") {
+
+        light->position.set(0, 0, -5);
+        light->updateMatrixWorld();
+        lights.setup(lightsArray);
+        lights.setupView(lightsArray, camera.get());
+
+        camera->position.z = 5;
+        camera->updateMatrixWorld();
+        lights.setup(lightsArray);
+        lights.setupView(lightsArray, camera.get());
+
+        const auto& position = std::get<Vector3>(lights.state.point[1]->at("position"));
+        CHECK_THAT(position.z, Catch::Matchers::WithinRel(-10.f));
+    }
+}
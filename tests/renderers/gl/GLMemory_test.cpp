@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/renderers/GLRenderTarget.hpp"
+#include "threepp/renderers/gl/GLMemory.hpp"
+
+using namespace threepp;
+using namespace threepp::gl;
+
+TEST_CASE("texture byte estimates") {
+
+    CHECK(bytesPerTexel(Format::RGBA, Type::UnsignedByte) == 4);
+    CHECK(bytesPerTexel(Format::RGBA, Type::Float) == 16);
+    CHECK(bytesPerTexel(Format::RGB, Type::HalfFloat) == 6);
+    CHECK(bytesPerTexel(Format::Red, Type::UnsignedByte) == 1);
+    CHECK(bytesPerTexel(Format::RGB, Type::UnsignedShort565) == 2);
+
+    CHECK(textureBytes(256, 256, 1, Format::RGBA, Type::UnsignedByte, false) == 256 * 256 * 4);
+    CHECK(textureBytes(256, 256, 1, Format::RGBA, Type::UnsignedByte, true) == 256 * 256 * 4 + 256 * 256 * 4 / 3);
+    CHECK(textureBytes(16, 16, 8, Format::RG, Type::Float, false) == 16 * 16 * 8 * 8);
+    CHECK(textureBytes(16, 16, 0, Format::RGBA, Type::UnsignedByte, false) == 16 * 16 * 4);
+}
+
+TEST_CASE("render target byte estimates") {
+
+    GLRenderTarget::Options options;
+    options.depthBuffer = false;
+
+    CHECK(renderTargetBytes(*GLRenderTarget::create(64, 32, options), false) == 64 * 32 * 4);
+
+    options.depthBuffer = true;
+    CHECK(renderTargetBytes(*GLRenderTarget::create(64, 32, options), false) == 64 * 32 * (4 + 2));
+
+    options.stencilBuffer = true;
+    CHECK(renderTargetBytes(*GLRenderTarget::create(64, 32, options), false) == 64 * 32 * (4 + 4));
+}
+
+TEST_CASE("tracked bytes follow uploads, resizes and releases") {
+
+    MemoryInfo memory;
+    size_t a = 0, b = 0;
+
+    trackBytes(memory.bufferBytes, a, 100);
+    trackBytes(memory.bufferBytes, b, 50);
+    CHECK(memory.bufferBytes == 150);
+
+    trackBytes(memory.bufferBytes, a, 40);
+    CHECK(a == 40);
+    CHECK(memory.bufferBytes == 90);
+
+    trackBytes(memory.bufferBytes, b, 0);
+    trackBytes(memory.bufferBytes, a, 0);
+    CHECK(memory.bufferBytes == 0);
+    CHECK(memory.totalBytes() == 0);
+}
+
+TEST_CASE("least recently used resources are evicted first") {
+
+    MemoryInfo memory;
+    memory.textureBytes = 400;
+
+    std::vector<int> evicted;
+    std::vector<EvictionCandidate> candidates;
+    for (auto [id, frame] : std::vector<std::pair<int, size_t>>{{0, 5}, {1, 2}, {2, 9}, {3, 2}}) {
+
+        candidates.push_back({frame, [&, id = id] {
+                                  evicted.push_back(id);
+                                  memory.textureBytes -= 100;
+                              }});
+    }
+
+    SECTION("until within budget") {
+
+        CHECK(evictLeastRecentlyUsed(candidates, memory, 150) == 3);
+        CHECK(evicted == std::vector<int>{1, 3, 0});
+        CHECK(memory.totalBytes() == 100);
+    }
+
+    SECTION("nothing within budget") {
+
+        CHECK(evictLeastRecentlyUsed(candidates, memory, 400) == 0);
+        CHECK(evicted.empty());
+    }
+
+    SECTION("all of them if needed") {
+
+        CHECK(evictLeastRecentlyUsed(candidates, memory, 0) == 4);
+        CHECK(evicted == std::vector<int>{1, 3, 0, 2});
+        CHECK(memory.totalBytes() == 0);
+    }
+}
+
+TEST_CASE("textures evicted and then disposed are untracked once") {
+
+    MemoryInfo memory;
+    memory.textures = 2;
+
+    bool allocated = true;
+    size_t bytes = 0;
+    trackBytes(memory.textureBytes, bytes, 256);
+
+    // evicted
+    CHECK(untrackTexture(memory, allocated, bytes));
+    CHECK(memory.textures == 1);
+    CHECK(memory.textureBytes == 0);
+
+    // disposed later
+    CHECK(!untrackTexture(memory, allocated, bytes));
+    CHECK(memory.textures == 1);
+    CHECK(memory.textureBytes == 0);
+}
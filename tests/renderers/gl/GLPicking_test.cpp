@@ -0,0 +1,138 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/materials/LineBasicMaterial.hpp"
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/materials/RawShaderMaterial.hpp"
+#include "threepp/objects/InstancedMesh.hpp"
+#include "threepp/objects/LineSegments.hpp"
+#include "threepp/objects/Sprite.hpp"
+#include "threepp/renderers/gl/GLPicking.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace threepp;
+using namespace threepp::gl;
+
+namespace {
+
+    uint32_t depthBits(float depth) {
+
+        uint32_t bits;
+        std::memcpy(&bits, &depth, sizeof(float));
+        return bits;
+    }
+
+    int objectId(Material* material) {
+
+        return dynamic_cast<RawShaderMaterial*>(material)->uniforms->at("objectId").value<int>();
+    }
+
+}// namespace
+
+TEST_CASE("objects of a pass get consecutive ids") {
+
+    auto geometry = BoxGeometry::create();
+    auto material = MeshBasicMaterial::create();
+
+    auto a = Mesh::create(geometry, material);
+    auto b = Mesh::create(geometry, material);
+    auto sprite = Sprite::create();
+
+    GLPicking picking;
+    picking.begin(4);
+
+    CHECK(objectId(picking.material(a.get(), geometry.get(), material.get(), std::nullopt, 1, 100)) == 1);
+    CHECK(objectId(picking.material(b.get(), geometry.get(), material.get(), std::nullopt, 1, 100)) == 2);
+    // every draw of an object shares its id
+    CHECK(objectId(picking.material(a.get(), geometry.get(), material.get(), std::nullopt, 1, 100)) == 1);
+
+    CHECK(!picking.material(sprite.get(), sprite->geometry(), sprite->material.get(), std::nullopt, 1, 100));
+
+    // ids start over with the next pass
+    picking.begin(4);
+    CHECK(objectId(picking.material(b.get(), geometry.get(), material.get(), std::nullopt, 1, 100)) == 1);
+}
+
+TEST_CASE("picked pixels decode to one intersection per primitive") {
+
+    auto mesh = Mesh::create(BoxGeometry::create(), MeshBasicMaterial::create());
+    auto instanced = InstancedMesh::create(BoxGeometry::create(), MeshBasicMaterial::create(), 4);
+    auto lines = LineSegments::create(BufferGeometry::create(), LineBasicMaterial::create());
+
+    // identity unprojection: points are in normalized device coordinates
+    PickData data;
+    data.size = 2;
+    data.origin.set(0, 0, -2);
+    data.center.set(0, 0);
+    data.halfSize.set(1, 1);
+    data.objects = {mesh.get(), instanced.get(), lines.get()};
+    data.primitives = {PickPrimitive::Face, PickPrimitive::Face, PickPrimitive::Segment};
+
+    const auto none = std::numeric_limits<uint32_t>::max();
+
+    SECTION("nearest pixel of each primitive, nearest first") {
+
+        data.pixels = {
+                1, 0, 5, depthBits(0.5f),
+                1, 0, 5, depthBits(0.25f),
+                3, 0, 3, depthBits(0.75f),
+                pickNoHit, 0, 0, depthBits(1)};
+
+        const auto hits = decodePicks(data);
+        REQUIRE(hits.size() == 2);
+
+        CHECK(hits[0].object == mesh.get());
+        CHECK(hits[0].faceIndex == 5);
+        CHECK(!hits[0].instanceId);
+        CHECK_THAT(hits[0].point.x, Catch::Matchers::WithinAbs(0.5f, 1e-5));
+        CHECK_THAT(hits[0].point.z, Catch::Matchers::WithinAbs(-0.5f, 1e-5));
+        CHECK_THAT(hits[0].distance, Catch::Matchers::WithinAbs(std::sqrt(2.75f), 1e-5));
+
+        // segments report their first vertex
+        CHECK(hits[1].object == lines.get());
+        CHECK(hits[1].index == 6);
+    }
+
+    SECTION("instances and primitives are told apart") {
+
+        data.pixels = {
+                2, 1, 7, depthBits(0.5f),
+                2, 3, 7, depthBits(0.5f),
+                1, 0, none, depthBits(0.5f),
+                1, 0, 2, depthBits(0.5f)};
+
+        const auto hits = decodePicks(data);
+        REQUIRE(hits.size() == 4);
+
+        std::vector<int> instances;
+        size_t withoutFace = 0;
+        for (const auto& hit : hits) {
+
+            if (hit.object == instanced.get()) instances.emplace_back(*hit.instanceId);
+            if (!hit.faceIndex) ++withoutFace;
+        }
+
+        std::sort(instances.begin(), instances.end());
+        CHECK(instances == std::vector<int>{1, 3});
+        CHECK(withoutFace == 1);
+    }
+
+    SECTION("unknown ids and objects that are gone are left out") {
+
+        data.objects[0] = nullptr;
+        data.pixels = {
+                1, 0, 5, depthBits(0.5f),
+                4, 0, 5, depthBits(0.5f),
+                2, 0, 1, depthBits(0.5f),
+                pickNoHit, 0, 0, depthBits(0.5f)};
+
+        const auto hits = decodePicks(data);
+        REQUIRE(hits.size() == 1);
+        CHECK(hits.front().object == instanced.get());
+    }
+}
@@ -0,0 +1,239 @@
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/cameras/PerspectiveCamera.hpp"
+#include "threepp/core/Raycaster.hpp"
+#include "threepp/geometries/BoxGeometry.hpp"
+#include "threepp/math/Frustum.hpp"
+#include "threepp/objects/Group.hpp"
+#include "threepp/objects/Mesh.hpp"
+#include "threepp/scenes/Scene.hpp"
+
+#include <algorithm>
+
+using namespace threepp;
+
+namespace {
+
+    // grid of static boxes, spaced 2 units apart
+    std::vector<Mesh*> addGrid(Object3D& parent, int size) {
+
+        auto geometry = BoxGeometry::create();
+
+        std::vector<Mesh*> meshes;
+        for (int x = 0; x < size; ++x) {
+            for (int z = 0; z < size; ++z) {
+
+                auto mesh = Mesh::create(geometry);
+                mesh->position.set(static_cast<float>(x) * 2, 0, static_cast<float>(z) * 2);
+                mesh->isStatic = true;
+                meshes.emplace_back(mesh.get());
+                parent.add(mesh);
+            }
+        }
+
+        return meshes;
+    }
+
+    std::vector<Object3D*> bruteForce(const std::vector<Mesh*>& meshes, const Frustum& frustum) {
+
+        std::vector<Object3D*> result;
+        for (auto mesh : meshes) {
+
+            if (frustum.intersectsBox(*mesh->worldBoundingBox())) result.emplace_back(mesh);
+        }
+
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+}// namespace
+
+TEST_CASE("frustum query matches brute force") {
+
+    auto scene = Scene::create();
+    auto meshes = addGrid(*scene, 40);
+    scene->add(Mesh::create(BoxGeometry::create()));// not static
+    scene->updateMatrixWorld();
+
+    for (unsigned int threads : {1u, 4u}) {
+
+        SceneBVH bvh(threads);
+        bvh.build(*scene);
+
+        CHECK(bvh.size() == meshes.size());
+
+        PerspectiveCamera camera(60, 1, 0.1f, 30);
+        camera.position.set(10, 5, 10);
+        camera.lookAt({30, 0, 30});
+        camera.updateMatrixWorld();
+
+        Matrix4 projScreenMatrix;
+        projScreenMatrix.multiplyMatrices(camera.projectionMatrix, camera.matrixWorldInverse);
+        Frustum frustum;
+        frustum.setFromProjectionMatrix(projScreenMatrix);
+
+        std::vector<Object3D*> result;
+        bvh.intersectFrustum(frustum, result);
+        std::sort(result.begin(), result.end());
+
+        const auto expected = bruteForce(meshes, frustum);
+        CHECK(!expected.empty());
+        CHECK(expected.size() < meshes.size());
+        CHECK(result == expected);
+    }
+}
+
+TEST_CASE("refit after moving") {
+
+    auto scene = Scene::create();
+    auto meshes = addGrid(*scene, 4);
+    scene->updateMatrixWorld();
+
+    SceneBVH bvh;
+    bvh.build(*scene);
+
+    CHECK(bvh.refit() == 0);
+
+    auto moved = meshes.front();
+    moved->position.set(100, 0, 0);
+    scene->updateMatrixWorld();
+
+    CHECK(bvh.refit({moved}) == 1);
+    CHECK(bvh.bounds().max().x == 100.5f);
+
+    Ray ray({100, 10, 0}, {0, -1, 0});
+    std::vector<Object3D*> result;
+    bvh.intersectRay(ray, result);
+    REQUIRE(result.size() == 1);
+    CHECK(result.front() == moved);
+}
+
+TEST_CASE("coversSubtree") {
+
+    auto scene = Scene::create();
+    auto group = Group::create();
+    addGrid(*group, 2);
+    scene->add(group);
+
+    auto dynamic = Mesh::create(BoxGeometry::create());
+    scene->add(dynamic);
+    scene->updateMatrixWorld();
+
+    SceneBVH bvh;
+    bvh.build(*scene);
+
+    CHECK(bvh.coversSubtree(*group));
+    CHECK(!bvh.coversSubtree(*scene));
+    CHECK(!bvh.contains(*dynamic));
+}
+
+TEST_CASE("objects added below a covered group are traversed") {
+
+    auto scene = Scene::create();
+    auto group = Group::create();
+    auto inner = Group::create();
+    addGrid(*inner, 2);
+    group->add(inner);
+    scene->add(group);
+    scene->updateMatrixWorld();
+
+    scene->bvh = std::make_shared<SceneBVH>();
+    scene->bvh->build(*scene);
+    REQUIRE(scene->bvh->coversSubtree(*group));
+    REQUIRE(scene->bvh->coversSubtree(*inner));
+
+    auto late = Mesh::create(BoxGeometry::create());
+    late->position.set(10, 0, 10);
+    inner->add(late);
+    scene->updateMatrixWorld();
+
+    CHECK(!scene->bvh->coversSubtree(*inner));
+    CHECK(!scene->bvh->coversSubtree(*group));
+
+    Raycaster raycaster({10, 10, 10}, {0, -1, 0});
+    const auto intersects = raycaster.intersectObject(*scene, true);
+    REQUIRE(!intersects.empty());
+    CHECK(intersects.front().object == late.get());
+}
+
+TEST_CASE("removed covered groups are forgotten") {
+
+    auto scene = Scene::create();
+    auto group = Group::create();
+    scene->add(group);
+
+    SceneBVH bvh;
+    bvh.build(*scene);
+    REQUIRE(bvh.coversSubtree(*group));
+
+    scene->remove(*group);
+    CHECK(!bvh.coversSubtree(*group));
+}
+
+TEST_CASE("raycast scene with bvh") {
+
+    auto scene = Scene::create();
+    addGrid(*scene, 10);
+    auto dynamic = Mesh::create(BoxGeometry::create());
+    dynamic->position.set(4, 5, 4);
+    scene->add(dynamic);
+    scene->updateMatrixWorld();
+
+    Raycaster raycaster({4, 10, 4}, {0, -1, 0});
+    const auto expected = raycaster.intersectObject(*scene, true);
+
+    scene->bvh = std::make_shared<SceneBVH>();
+    scene->bvh->build(*scene);
+
+    const auto intersects = raycaster.intersectObject(*scene, true);
+
+    REQUIRE(intersects.size() == expected.size());
+    for (size_t i = 0; i < intersects.size(); ++i) {
+
+        CHECK(intersects[i].object == expected[i].object);
+        CHECK(intersects[i].distance == expected[i].distance);
+    }
+    CHECK(intersects.front().object == dynamic.get());
+}
+
+TEST_CASE("removed and destroyed objects are dropped") {
+
+    auto scene = Scene::create();
+    auto group = Group::create();
+    const auto meshes = addGrid(*group, 4);
+    scene->add(group);
+    scene->updateMatrixWorld();
+
+    scene->bvh = std::make_shared<SceneBVH>();
+    scene->bvh->build(*scene);
+    REQUIRE(scene->bvh->size() == 16);
+
+    // the box at (4, 0, 4)
+    auto removed = meshes[2 * 4 + 2];
+    Raycaster raycaster({4, 10, 4}, {0, -1, 0});
+    REQUIRE(raycaster.intersectObject(*scene, true).front().object == removed);
+
+    group->remove(*removed);
+
+    CHECK(!scene->bvh->contains(*removed));
+    CHECK(scene->bvh->size() == 15);
+    CHECK(raycaster.intersectObject(*scene, true).empty());
+
+    // destroying the root drops everything below it
+    SceneBVH bvh;
+    {
+        auto root = Group::create();
+        addGrid(*root, 2);
+        root->updateMatrixWorld();
+
+        bvh.build(*root);
+        REQUIRE(bvh.size() == 4);
+    }
+
+    CHECK(bvh.size() == 0);
+
+    std::vector<Object3D*> result;
+    bvh.intersectRay(Ray({0, 10, 0}, {0, -1, 0}), result);
+    CHECK(result.empty());
+}
@@ -0,0 +1,116 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "threepp/materials/MeshBasicMaterial.hpp"
+#include "threepp/materials/SpriteMaterial.hpp"
+#include "threepp/objects/Group.hpp"
+#include "threepp/objects/Sprite.hpp"
+#include "threepp/textures/TextureAtlas.hpp"
+
+using namespace threepp;
+
+namespace {
+
+    std::shared_ptr<Texture> solidTexture(unsigned int width, unsigned int height, unsigned char value) {
+
+        std::vector<unsigned char> data(width * height * 4, value);
+        auto texture = Texture::create(Image(data, width, height));
+        texture->needsUpdate();
+
+        return texture;
+    }
+
+}// namespace
+
+TEST_CASE("add") {
+
+    TextureAtlas atlas(64, 16, 2);
+
+    auto a = solidTexture(8, 8, 10);
+    auto b = solidTexture(4, 4, 20);
+
+    auto regionA = atlas.add(a);
+    auto regionB = atlas.add(b);
+
+    REQUIRE(regionA);
+    REQUIRE(regionB);
+    REQUIRE(atlas.pages().size() == 1);
+    REQUIRE(regionA->page() == regionB->page());
+    REQUIRE(atlas.add(a) == regionA);
+
+    CHECK_THAT(regionA->offset.x, Catch::Matchers::WithinRel(2.f / 64));
+    CHECK_THAT(regionA->repeat.x, Catch::Matchers::WithinRel(8.f / 64));
+    CHECK_THAT(regionB->offset.x, Catch::Matchers::WithinRel(14.f / 64));
+
+    auto& data = atlas.pages().front()->image->data();
+    const auto texel = [&](unsigned int x, unsigned int y) { return data[(y * 64 + x) * 4]; };
+
+    CHECK(texel(2, 2) == 10);
+    CHECK(texel(0, 0) == 10);// padding
+    CHECK(texel(11, 11) == 10);
+    CHECK(texel(14, 2) == 20);
+    CHECK(texel(13, 2) == 20);
+
+    // coarser levels would blend neighbouring regions
+    CHECK_FALSE(regionA->page()->generateMipmaps);
+}
+
+TEST_CASE("ineligible") {
+
+    TextureAtlas atlas(64, 16, 2);
+
+    CHECK_FALSE(atlas.add(solidTexture(32, 32, 0)));
+
+    auto repeating = solidTexture(8, 8, 0);
+    repeating->wrapS = TextureWrapping::Repeat;
+    CHECK_FALSE(atlas.add(repeating));
+
+    CHECK(atlas.pages().empty());
+}
+
+TEST_CASE("padding larger than the page") {
+
+    TextureAtlas atlas(8, 16, 4);
+
+    CHECK_FALSE(atlas.add(solidTexture(1, 1, 0)));
+    CHECK(atlas.pages().empty());
+}
+
+TEST_CASE("apply") {
+
+    TextureAtlas atlas(64, 16, 2);
+
+    auto texture = solidTexture(8, 8, 0);
+
+    auto spriteMaterial = SpriteMaterial::create();
+    spriteMaterial->map = texture;
+
+    auto alphaMapped = SpriteMaterial::create();
+    alphaMapped->map = texture;
+    alphaMapped->alphaMap = texture;
+
+    auto group = Group::create();
+    group->add(Sprite::create(spriteMaterial));
+    group->add(Sprite::create(alphaMapped));
+
+    REQUIRE(atlas.apply(*group) == 1);
+    CHECK(dynamic_cast<AtlasTexture*>(spriteMaterial->map.get()));
+    CHECK(alphaMapped->map == texture);
+}
+
+TEST_CASE("regions are forgotten when the source is disposed") {
+
+    TextureAtlas atlas(64, 16, 2);
+
+    auto texture = solidTexture(8, 8, 0);
+    auto region = atlas.add(texture);
+    REQUIRE(region);
+    REQUIRE(atlas.add(texture) == region);
+
+    texture->dispose();
+
+    auto added = atlas.add(texture);
+    REQUIRE(added);
+    CHECK(added != region);
+}
@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/core/Object3D.hpp"
+#include "threepp/utils/PoolAllocator.hpp"
+
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace threepp;
+
+TEST_CASE("BlockPool reuses blocks") {
+
+    utils::BlockPool pool(32, 4);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 6; ++i) blocks.emplace_back(pool.allocate());
+
+    CHECK(pool.size() == 6);
+    CHECK(pool.capacity() == 8);
+    CHECK(std::set<void*>(blocks.begin(), blocks.end()).size() == blocks.size());
+
+    auto last = blocks.back();
+    pool.deallocate(last);
+    CHECK(pool.size() == 5);
+    CHECK(pool.allocate() == last);
+
+    for (auto b : blocks) pool.deallocate(b);
+    CHECK(pool.size() == 0);
+    CHECK(pool.capacity() == 8);
+}
+
+TEST_CASE("makePooled") {
+
+    struct Counted {
+        int& count;
+        explicit Counted(int& count): count(count) { ++count; }
+        ~Counted() { --count; }
+    };
+
+    int count = 0;
+    {
+        auto a = utils::makePooled<Counted>(count);
+        std::shared_ptr<Counted> b = a;
+        CHECK(count == 1);
+        CHECK(b.use_count() == 2);
+    }
+    CHECK(count == 0);
+}
+
+TEST_CASE("uuid is generated lazily and stays the same") {
+
+    Object3D a, b;
+    const auto uuid = a.uuid();
+
+    CHECK(uuid.size() == 36);
+    CHECK(a.uuid() == uuid);
+    CHECK(b.uuid() != uuid);
+}
+
+TEST_CASE("uuid is generated once when first read concurrently") {
+
+    Object3D object;
+
+    std::vector<const std::string*> uuids(4);
+    std::vector<std::thread> threads;
+    for (auto& uuid : uuids) {
+
+        threads.emplace_back([&] { uuid = &object.uuid(); });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (auto uuid : uuids) CHECK(*uuid == object.uuid());
+}
@@ -0,0 +1,37 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "threepp/utils/SmallVector.hpp"
+
+using namespace threepp;
+
+TEST_CASE("SmallVector") {
+
+    utils::SmallVector<int, 2> v;
+    CHECK(v.empty());
+    CHECK(v.capacity() == 2);
+
+    for (int i = 0; i < 5; ++i) v.push_back(i);
+    CHECK(v.size() == 5);
+    CHECK(v.capacity() >= 5);
+
+    v.erase(1);
+    CHECK(v.size() == 4);
+    CHECK(v[0] == 0);
+    CHECK(v[1] == 2);
+    CHECK(v.back() == 4);
+
+    auto copy = v;
+    v.clear();
+    CHECK(v.empty());
+    CHECK(copy.size() == 4);
+
+    auto moved = std::move(copy);
+    CHECK(moved.size() == 4);
+    CHECK(copy.empty());
+
+    utils::SmallVector<int, 2> small;
+    small.push_back(7);
+    moved = small;
+    CHECK(moved.size() == 1);
+    CHECK(moved[0] == 7);
+}